@@ -0,0 +1,65 @@
+// Text searches sorted by text score with a limit stop reading the index once no other document
+// can make it into the limit. Check that they return the same documents and scores as a full
+// scoring of every match.
+(function() {
+    "use strict";
+
+    var t = db.fts_score_sort_topk;
+    t.drop();
+
+    var words = ["apple", "banana", "cherry", "grape", "lemon", "mango", "olive", "peach"];
+    Random.setRandomSeed();
+    var bulk = t.initializeUnorderedBulkOp();
+    for (var i = 0; i < 2000; i++) {
+        var text = [];
+        var numWords = 1 + Random.randInt(20);
+        for (var j = 0; j < numWords; j++) {
+            // Skew the word frequencies so that some terms are much more common than others.
+            text.push(words[Math.floor(words.length * Math.pow(Random.rand(), 2))]);
+        }
+        bulk.insert({_id: i, a: text.join(" "), b: i % 3});
+    }
+    assert.writeOK(bulk.execute());
+    assert.commandWorked(t.ensureIndex({a: "text"}));
+
+    function check(query, limit) {
+        var proj = {score: {$meta: "textScore"}};
+        var sort = {score: {$meta: "textScore"}};
+
+        var all = t.find(query, proj).sort(sort).toArray();
+        var limited = t.find(query, proj).sort(sort).limit(limit).toArray();
+        assert.eq(Math.min(limit, all.length), limited.length, tojson(query));
+
+        // Ties may be broken differently, so compare the scores, and check each score against
+        // the one the document got from the full scoring.
+        var scoreById = {};
+        all.forEach(function(doc) {
+            scoreById[doc._id] = doc.score;
+        });
+        limited.forEach(function(doc, i) {
+            assert.eq(all[i].score, doc.score, tojson(query));
+            assert.eq(scoreById[doc._id], doc.score, tojson(query));
+        });
+    }
+
+    [1, 5, 20, 100].forEach(function(limit) {
+        check({$text: {$search: "apple"}}, limit);
+        check({$text: {$search: "apple banana"}}, limit);
+        check({$text: {$search: "apple banana cherry mango peach"}}, limit);
+        check({$text: {$search: "apple olive"}, b: 1}, limit);
+        // Negations and phrases are checked after the scoring, so they score every match.
+        check({$text: {$search: "apple banana -cherry"}}, limit);
+        check({$text: {$search: "\"apple banana\" cherry"}}, limit);
+    });
+
+    // The limit is pushed down to the text stage.
+    var explain = t.find({$text: {$search: "apple banana"}}, {score: {$meta: "textScore"}})
+                      .sort({score: {$meta: "textScore"}})
+                      .limit(10)
+                      .explain("executionStats");
+    var textOr = explain.executionStats.executionStages;
+    while (textOr.stage !== "TEXT_OR") {
+        textOr = textOr.inputStage;
+    }
+    assert.eq(10, textOr.topK, tojson(explain));
+})();
@@ -0,0 +1,105 @@
+// $near over a 2dsphere index searches the cells closest to the query point first. Check that the
+// results are complete and sorted by distance when the data is sparse and spread over the whole
+// sphere, including geometries indexed by coarse cells.
+(function() {
+    "use strict";
+
+    var t = db.geo_s2near_sparse;
+    t.drop();
+
+    var earthRadiusMeters = 6378.1 * 1000;
+
+    function toRadians(degrees) {
+        return degrees * Math.PI / 180;
+    }
+
+    function distance(a, b) {
+        var lat1 = toRadians(a[1]), lat2 = toRadians(b[1]);
+        var dLat = lat2 - lat1, dLng = toRadians(b[0] - a[0]);
+        var h = Math.pow(Math.sin(dLat / 2), 2) +
+            Math.cos(lat1) * Math.cos(lat2) * Math.pow(Math.sin(dLng / 2), 2);
+        return 2 * earthRadiusMeters * Math.asin(Math.min(1, Math.sqrt(h)));
+    }
+
+    Random.setRandomSeed();
+    var points = [];
+    for (var i = 0; i < 300; i++) {
+        var lng = Random.rand() * 360 - 180;
+        var lat = Math.asin(Random.rand() * 2 - 1) * 180 / Math.PI;
+        points.push([lng, lat]);
+        assert.writeOK(t.insert({_id: i, geo: {type: "Point", coordinates: [lng, lat]}}));
+    }
+    // Geometries indexed by cells much coarser than those of the points.
+    assert.writeOK(t.insert({
+        _id: "line",
+        geo: {type: "LineString", coordinates: [[-170, -60], [170, 60]]}
+    }));
+    assert.writeOK(t.insert({
+        _id: "polygon",
+        geo: {type: "Polygon", coordinates: [[[10, 10], [40, 10], [40, 40], [10, 40], [10, 10]]]}
+    }));
+    assert.commandWorked(t.ensureIndex({geo: "2dsphere"}));
+
+    function check(center, minDistance, maxDistance) {
+        var query = {$geometry: {type: "Point", coordinates: center}};
+        if (minDistance !== undefined) {
+            query.$minDistance = minDistance;
+        }
+        if (maxDistance !== undefined) {
+            query.$maxDistance = maxDistance;
+        }
+        var results = t.find({geo: {$near: query}}).toArray();
+
+        // Every point in the distance range is returned, closest first.
+        var lo = minDistance || 0;
+        var hi = (maxDistance === undefined) ? Infinity : maxDistance;
+        var expected = points.filter(function(p) {
+            var d = distance(center, p);
+            return d >= lo && d <= hi;
+        });
+        var returnedPoints = results.filter(function(doc) {
+            return doc.geo.type === "Point";
+        });
+        assert.eq(expected.length, returnedPoints.length, tojson(query));
+
+        var last = -1;
+        returnedPoints.forEach(function(doc) {
+            var d = distance(center, doc.geo.coordinates);
+            assert.lte(last, d + 1, tojson(query));
+            last = d;
+        });
+
+        // No document is returned twice.
+        var ids = {};
+        results.forEach(function(doc) {
+            assert(!ids.hasOwnProperty(doc._id), tojson(doc));
+            ids[doc._id] = true;
+        });
+        return ids;
+    }
+
+    var ids = check([0, 0]);
+    assert(ids.line && ids.polygon);
+    check([25, 25], 0, 1000 * 1000);
+    ids = check([25, 25], 0, 1);
+    assert(ids.polygon && !ids.line);
+    check([-120, 45], 5000 * 1000);
+    check([179.9, -89.9], 1000 * 1000, 15000 * 1000);
+    check([90, 0], undefined, 20000 * 1000);
+
+    // Limited queries return the closest points.
+    var center = [-60, -30];
+    var sorted = points.map(function(p) {
+        return distance(center, p);
+    }).sort(function(a, b) {
+        return a - b;
+    });
+    var limited = t.find({
+                       geo: {$near: {$geometry: {type: "Point", coordinates: center}}},
+                       _id: {$type: 1}
+                   }).limit(5).toArray();
+    assert.eq(5, limited.length);
+    limited.forEach(function(doc, i) {
+        assert.close(sorted[i], distance(center, doc.geo.coordinates), "", 3);
+    });
+})();
@@ -0,0 +1,37 @@
+// This test ensures that the replBufferMaxSizeBytes server parameter:
+//       1) cannot be less than 1
+//       2) is actually set to the passed in value
+//       3) cannot be altered at run time
+
+(function() {
+    "use strict";
+
+    // too low a size
+    clearRawMongoProgramOutput();
+    var mongo = MongoRunner.runMongod({setParameter: 'replBufferMaxSizeBytes=0'});
+    assert.soon(function() {
+        return rawMongoProgramOutput().match("replBufferMaxSizeBytes must be greater than 0");
+    }, "mongod started with too low a value for replBufferMaxSizeBytes");
+
+    clearRawMongoProgramOutput();
+    mongo = MongoRunner.runMongod({setParameter: 'replBufferMaxSizeBytes=-1'});
+    assert.soon(function() {
+        return rawMongoProgramOutput().match("replBufferMaxSizeBytes must be greater than 0");
+    }, "mongod started with a negative value for replBufferMaxSizeBytes");
+
+    // proper size
+    clearRawMongoProgramOutput();
+    mongo = MongoRunner.runMongod({setParameter: 'replBufferMaxSizeBytes=1048576'});
+    assert.neq(null, mongo, "mongod failed to start with a suitable replBufferMaxSizeBytes value");
+    assert(!rawMongoProgramOutput().match("replBufferMaxSizeBytes must be greater than 0"),
+           "despite accepting the replBufferMaxSizeBytes value, mongod logged an error");
+
+    // getParameter to confirm the value was set
+    var result = mongo.getDB("admin").runCommand({getParameter: 1, replBufferMaxSizeBytes: 1});
+    assert.eq(1048576, result.replBufferMaxSizeBytes, "replBufferMaxSizeBytes was not set");
+
+    // setParameter to ensure it is not possible
+    assert.commandFailed(mongo.getDB("admin").runCommand({setParameter: 1,
+                                                          replBufferMaxSizeBytes: 1}));
+    MongoRunner.stopMongod(mongo);
+}());
@@ -0,0 +1,81 @@
+// Updates only maintain the indexes over the fields they change. Check that the keys of every kind
+// of index stay correct whether or not an update touches the indexed fields.
+(function() {
+    "use strict";
+
+    var t = db.jstests_update_index_maintenance;
+    t.drop();
+
+    assert.commandWorked(t.ensureIndex({a: 1}));
+    assert.commandWorked(t.ensureIndex({"b.c": 1, d: -1}));
+    assert.commandWorked(t.ensureIndex({arr: 1}));
+    assert.commandWorked(t.ensureIndex({e: 1}, {partialFilterExpression: {f: {$gt: 0}}}));
+    assert.commandWorked(t.ensureIndex({txt: "text"}));
+
+    var arr = [];
+    for (var i = 0; i < 500; i++) {
+        arr.push(i);
+    }
+    assert.writeOK(t.insert(
+        {_id: 0, a: 1, b: {c: 1}, d: 1, arr: arr, e: 1, f: 0, txt: "cat", counter: 0}));
+
+    function countWithHint(query, hint) {
+        return t.find(query).hint(hint).itcount();
+    }
+
+    // Updates of fields outside every index.
+    assert.writeOK(t.update({_id: 0}, {$inc: {counter: 1}, $set: {other: "x"}}));
+    assert.eq(1, countWithHint({a: 1}, {a: 1}));
+    assert.eq(1, countWithHint({"b.c": 1, d: 1}, {"b.c": 1, d: -1}));
+    assert.eq(1, countWithHint({arr: 499}, {arr: 1}));
+    assert.eq(1, t.find({$text: {$search: "cat"}}).itcount());
+
+    // Updates of a field in one index leave the others intact.
+    assert.writeOK(t.update({_id: 0}, {$set: {a: 2}}));
+    assert.eq(0, countWithHint({a: 1}, {a: 1}));
+    assert.eq(1, countWithHint({a: 2}, {a: 1}));
+    assert.eq(1, countWithHint({"b.c": 1, d: 1}, {"b.c": 1, d: -1}));
+
+    // Updates of a parent of an indexed field.
+    assert.writeOK(t.update({_id: 0}, {$set: {b: {c: 2}}}));
+    assert.eq(0, countWithHint({"b.c": 1, d: 1}, {"b.c": 1, d: -1}));
+    assert.eq(1, countWithHint({"b.c": 2, d: 1}, {"b.c": 1, d: -1}));
+
+    // Updates of a large multikey array, including positional ones.
+    assert.writeOK(t.update({_id: 0}, {$pull: {arr: {$gte: 250}}, $push: {other2: 1}}));
+    assert.eq(0, countWithHint({arr: 499}, {arr: 1}));
+    assert.eq(1, countWithHint({arr: 249}, {arr: 1}));
+    assert.writeOK(t.update({_id: 0, arr: 10}, {$set: {"arr.$": 1000}}));
+    assert.eq(0, countWithHint({arr: 10}, {arr: 1}));
+    assert.eq(1, countWithHint({arr: 1000}, {arr: 1}));
+    assert.writeOK(t.update({_id: 0}, {$set: {"arr.0": -1}}));
+    assert.eq(1, countWithHint({arr: -1}, {arr: 1}));
+    assert.eq(0, countWithHint({arr: 0}, {arr: 1}));
+
+    // Updates of the field in a partial index's filter add the document to, and remove it from,
+    // that index.
+    assert.eq(0, countWithHint({e: 1, f: {$gt: 0}}, {e: 1}));
+    assert.writeOK(t.update({_id: 0}, {$set: {f: 1}}));
+    assert.eq(1, countWithHint({e: 1, f: {$gt: 0}}, {e: 1}));
+    assert.writeOK(t.update({_id: 0}, {$inc: {f: -1}}));
+    assert.eq(0, countWithHint({e: 1, f: {$gt: 0}}, {e: 1}));
+
+    // Updates of the text index's language override field.
+    assert.writeOK(t.update({_id: 0}, {$set: {txt: "cats"}}));
+    assert.eq(1, t.find({$text: {$search: "cat"}}).itcount());
+    assert.writeOK(t.update({_id: 0}, {$set: {language: "none"}}));
+    assert.eq(0, t.find({$text: {$search: "cat", $language: "none"}}).itcount());
+    assert.eq(1, t.find({$text: {$search: "cats", $language: "none"}}).itcount());
+
+    // Replacements maintain every index.
+    assert.writeOK(t.update({_id: 0}, {a: 3, b: {c: 3}, arr: [7], e: 1, f: 1, txt: "dog"}));
+    assert.eq(1, countWithHint({a: 3}, {a: 1}));
+    assert.eq(1, countWithHint({"b.c": 3, d: null}, {"b.c": 1, d: -1}));
+    assert.eq(1, countWithHint({arr: 7}, {arr: 1}));
+    assert.eq(0, countWithHint({arr: 1000}, {arr: 1}));
+    assert.eq(1, countWithHint({e: 1, f: {$gt: 0}}, {e: 1}));
+    assert.eq(1, t.find({$text: {$search: "dog"}}).itcount());
+
+    var res = t.validate(true);
+    assert(res.valid, tojson(res));
+})();
@@ -0,0 +1,47 @@
+// Concurrent j:true writers are acknowledged once their group commit is in the journal, and what
+// they were acknowledged for survives an unclean shutdown. Also checks the commit latency
+// histogram reported by serverStatus.
+(function() {
+    "use strict";
+
+    var path = MongoRunner.dataPath + "dur_group_commit";
+    resetDbpath(path);
+
+    var conn = MongoRunner.runMongod({dbpath: path, journal: "", smallfiles: ""});
+    var coll = conn.getDB("test").group_commit;
+
+    var numWriters = 8;
+    var docsPerWriter = 200;
+    var writers = [];
+    for (var w = 0; w < numWriters; w++) {
+        var code = "var coll = db.getSiblingDB('test').group_commit;" +
+            "for (var i = 0; i < " + docsPerWriter + "; i++) {" +
+            "    assert.writeOK(coll.insert({w: " + w + ", i: i, pad: new Array(1000).join('x')}," +
+            "                               {writeConcern: {j: true}}));" +
+            "}";
+        writers.push(startParallelShell(code, conn.port));
+    }
+    writers.forEach(function(join) {
+        join();
+    });
+
+    var dur = conn.getDB("admin").serverStatus().dur;
+    assert(dur.commitLatencyMs, tojson(dur));
+    var bucketNames = Object.keys(dur.commitLatencyMs);
+    assert.eq(12, bucketNames.length, tojson(dur.commitLatencyMs));
+    assert.eq("<1", bucketNames[0]);
+    assert.eq(">=1024", bucketNames[bucketNames.length - 1]);
+    assert.gte(dur.timeMs.compressJournal, 0, tojson(dur));
+
+    MongoRunner.stopMongod(conn, /*signal*/ 9);
+
+    conn = MongoRunner.runMongod(
+        {restart: true, cleanData: false, dbpath: path, journal: "", smallfiles: ""});
+    coll = conn.getDB("test").group_commit;
+    assert.eq(numWriters * docsPerWriter, coll.count());
+    for (var w = 0; w < numWriters; w++) {
+        assert.eq(docsPerWriter, coll.count({w: w}));
+    }
+
+    MongoRunner.stopMongod(conn);
+})();
@@ -0,0 +1,40 @@
+// Test that mongod writes its log file through the asynchronous log writer when asyncLogQueueSize
+// is set, reports the writer's counters in serverStatus, and writes every queued line before it
+// exits.
+(function() {
+    "use strict";
+
+    var logFileName = MongoRunner.dataPath + "async_logging.log";
+    var conn = MongoRunner.runMongod(
+        {logpath: logFileName, setParameter: {asyncLogQueueSize: 1000}});
+    assert.neq(null, conn, "mongod failed to start with asyncLogQueueSize set");
+    var db = conn.getDB("test");
+
+    // print() in server-side JavaScript writes to the log file.
+    assert.writeOK(db.async_logging.insert({}));
+    for (var i = 0; i < 100; i++) {
+        var where = "print('async_logging_" + i + "'); return true;";
+        assert.eq(1, db.async_logging.find({$where: where}).itcount());
+    }
+
+    var stats = db.serverStatus().metrics.log.async;
+    assert(stats, tojson(db.serverStatus().metrics));
+    assert.eq(0, stats.droppedLines, tojson(stats));
+    assert.gte(stats.writtenLines + stats.queuedLines, 100, tojson(stats));
+
+    MongoRunner.stopMongod(conn);
+
+    var logContents = cat(logFileName);
+    for (var i = 0; i < 100; i++) {
+        assert(new RegExp("async_logging_" + i + "$", "m").test(logContents),
+               "line " + i + " missing from the log file");
+    }
+    assert(/dbexit:/.test(logContents), "shutdown was not logged");
+
+    // An unknown overflow policy is rejected at startup.
+    conn = MongoRunner.runMongod({
+        logpath: logFileName,
+        setParameter: {asyncLogQueueSize: 1000, asyncLogOverflowPolicy: "sometimes"}
+    });
+    assert.eq(null, conn, "mongod started with an invalid asyncLogOverflowPolicy");
+})();
@@ -0,0 +1,82 @@
+// Test that the TTL monitor deletes expired documents in batches, and reports its progress for
+// each TTL index in the "ttl" section of serverStatus.
+(function() {
+    "use strict";
+    // Launch mongod with shorter TTL monitor sleep interval and batches much smaller than the
+    // number of expired documents.
+    var runner = MongoRunner.runMongod({
+        setParameter: {ttlMonitorSleepSecs: 1, ttlMonitorBatchSize: 10, ttlMonitorWorkerThreads: 2}
+    });
+    var db = runner.getDB("test");
+    var coll1 = db.ttl_batched_deletes1;
+    var coll2 = db.ttl_batched_deletes2;
+    coll1.drop();
+    coll2.drop();
+
+    var now = new Date();
+    var past = new Date(now.getTime() - 60 * 60 * 1000);
+    var bulk1 = coll1.initializeUnorderedBulkOp();
+    var bulk2 = coll2.initializeUnorderedBulkOp();
+    for (var i = 0; i < 95; i++) {
+        bulk1.insert({x: past});
+        bulk2.insert({x: past});
+    }
+    bulk1.insert({x: now});
+    assert.writeOK(bulk1.execute());
+    assert.writeOK(bulk2.execute());
+
+    assert.commandWorked(coll1.ensureIndex({x: 1}, {expireAfterSeconds: 600}));
+    assert.commandWorked(coll2.ensureIndex({x: -1}, {expireAfterSeconds: 600}));
+
+    // Wait for the TTL monitor to run at least twice (in case we weren't finished setting up our
+    // collections when it ran the first time).
+    var ttlPass = db.serverStatus().metrics.ttl.passes;
+    assert.soon(function() {
+                    return db.serverStatus().metrics.ttl.passes >= ttlPass + 2;
+                },
+                "TTL monitor didn't run before timing out.");
+
+    assert.eq(1, coll1.find().itcount(), "Wrong number of documents after TTL monitor run");
+    assert.eq(0, coll2.find().itcount(), "Wrong number of documents after TTL monitor run");
+
+    var indexes = db.serverStatus({ttl: 1}).ttl.indexes;
+    var stats1 = indexes[coll1.getFullName() + ".$x_1"];
+    var stats2 = indexes[coll2.getFullName() + ".$x_-1"];
+    assert(stats1, tojson(indexes));
+    assert(stats2, tojson(indexes));
+    assert.eq(95, stats1.deletedDocuments, tojson(stats1));
+    assert.eq(95, stats2.deletedDocuments, tojson(stats2));
+    assert.eq(0, stats1.pendingEstimate, tojson(stats1));
+    assert.eq(0, stats1.oldestExpiredAgeSecs, tojson(stats1));
+
+    // Rate limit the deletes so that a backlog takes several one second batches. Expiry dates
+    // spread over a range far in the past must not overflow the estimate of the pending documents.
+    assert.commandWorked(db.adminCommand({setParameter: 1, ttlMonitorBatchSize: 5000}));
+    assert.commandWorked(db.adminCommand({setParameter: 1, ttlMonitorMaxDeletesPerSecond: 5000}));
+    var coll3 = db.ttl_batched_deletes3;
+    coll3.drop();
+    var bulk3 = coll3.initializeUnorderedBulkOp();
+    for (var i = 0; i < 20000; i++) {
+        bulk3.insert({x: new Date(-8.6e15 + i * 4e11)});
+    }
+    assert.writeOK(bulk3.execute());
+    assert.commandWorked(coll3.ensureIndex({x: 1}, {expireAfterSeconds: 600}));
+
+    var statsKey3 = coll3.getFullName() + ".$x_1";
+    assert.soon(function() {
+        var stats3 = db.serverStatus({ttl: 1}).ttl.indexes[statsKey3];
+        return stats3 && stats3.deletedDocuments > 0;
+    }, "TTL monitor didn't start deleting the backlog before timing out.");
+    var stats3 = db.serverStatus({ttl: 1}).ttl.indexes[statsKey3];
+    assert.gte(stats3.pendingEstimate, 0, tojson(stats3));
+
+    // Disabling the TTL monitor stops the deletes of the backlog between batches.
+    assert.commandWorked(db.adminCommand({setParameter: 1, ttlMonitorEnabled: false}));
+    sleep(2000);
+    var remaining = coll3.count();
+    assert.gt(remaining, 0);
+    sleep(3000);
+    assert.eq(remaining, coll3.count(), "TTL deletes continued after disabling the monitor");
+
+    MongoRunner.stopMongod(runner);
+})();
@@ -0,0 +1,98 @@
+// Test that mapReduce runs simple counting and summing map and reduce functions without the JS
+// engine, and that their results are the same as when the JS engine runs them.
+(function() {
+    "use strict";
+
+    var coll = db.mapreduce_native;
+    coll.drop();
+
+    var bulk = coll.initializeUnorderedBulkOp();
+    for (var i = 0; i < 2000; i++) {
+        bulk.insert({
+            _id: i,
+            k: i % 7,
+            s: "key" + (i % 5),
+            nested: {k: (i % 2 === 0) ? NumberInt(i % 3) : i % 3},
+            v: (i % 4 === 0) ? NumberInt(i) : i + 0.25
+        });
+    }
+    // Documents which are mapped, or whose values are reduced, by the JS functions.
+    bulk.insert({_id: "noKey", v: 1});
+    bulk.insert({_id: "scalarParent", k: 1, nested: 5, v: 1});
+    bulk.insert({_id: "arrayKey", k: [1, 2], s: "key0", v: 1});
+    bulk.insert({_id: "objectKey", k: {a: 1}, s: ["key1"], nested: {k: 1}, v: NumberLong(5)});
+    bulk.insert({_id: "stringValue", k: 1, s: "key1", nested: {k: 1}, v: "x"});
+    assert.writeOK(bulk.execute());
+
+    var maps = [
+        function() {
+            emit(this.k, 1);
+        },
+        function() {
+            emit(this.s, this.v);
+        },
+        function() {
+            emit(this.nested.k, this.v);
+        }
+    ];
+    var reduces = [
+        function(key, values) {
+            return Array.sum(values);
+        },
+        function(key, values) {
+            var total = 0;
+            for (var i = 0; i < values.length; i++) {
+                total += values[i];
+            }
+            return total;
+        }
+    ];
+
+    function runMapReduce(map, reduce, options, useNative) {
+        assert.commandWorked(db.adminCommand(
+            {setParameter: 1, internalMapReduceUseNativeFunctions: useNative}));
+        var cmd = {mapReduce: coll.getName(), map: map, reduce: reduce};
+        Object.extend(cmd, options);
+        var res = db.runCommand(cmd);
+        assert.commandWorked(res);
+        var expectedMode = useNative ? "native" : "js";
+        assert.eq({map: expectedMode, reduce: expectedMode}, res.functions, tojson(res));
+
+        var results = res.results || db[res.result].find().toArray();
+        return results.sort(function(a, b) {
+            return bsonWoCompare({x: a._id}, {x: b._id});
+        });
+    }
+
+    try {
+        maps.forEach(function(map) {
+            reduces.forEach(function(reduce) {
+                [{out: {inline: 1}},
+                 {out: "mapreduce_native_out"},
+                 {out: {inline: 1}, query: {_id: {$gte: 100}}, sort: {_id: 1}, limit: 500},
+                 {out: {inline: 1}, finalize: function(key, value) {
+                     return {total: value};
+                 }}].forEach(function(options) {
+                    var nativeResults = runMapReduce(map, reduce, options, true);
+                    var jsResults = runMapReduce(map, reduce, options, false);
+                    assert.eq(jsResults, nativeResults, tojson(options));
+                    assert.eq(tojson(jsResults), tojson(nativeResults), tojson(options));
+                });
+            });
+        });
+
+        // Functions run with a scope are always run by the JS engine.
+        var res = db.runCommand({
+            mapReduce: coll.getName(),
+            map: maps[0],
+            reduce: reduces[0],
+            out: {inline: 1},
+            scope: {unused: 1}
+        });
+        assert.commandWorked(res);
+        assert.eq({map: "js", reduce: "js"}, res.functions, tojson(res));
+    } finally {
+        assert.commandWorked(
+            db.adminCommand({setParameter: 1, internalMapReduceUseNativeFunctions: true}));
+    }
+})();
@@ -0,0 +1,43 @@
+/**
+ *  Times inserts into a text-indexed collection, for English documents made up entirely of ASCII
+ *  and for French documents with accented characters, and reports the insert rate of each.
+ */
+
+var t = db.perf.fts_index_throughput;
+var numDocs = 20 * 1000;
+var wordsPerDoc = 100;
+
+var englishWords = ["the", "quick", "brown", "fox", "jumps", "over", "lazy", "dog", "running",
+                    "indexes", "searching", "documents", "collections", "databases", "shards",
+                    "replicated", "queries", "stemming", "tokenizers", "languages"];
+var frenchWords = ["le", "café", "était", "très", "chaud", "élève", "écoutait", "musique",
+                   "forêt", "été", "hôpital", "garçon", "naïve", "où", "fenêtre", "bibliothèque",
+                   "recherche", "donnés", "collection", "requêtes"];
+
+function makeText(words, seed) {
+    var text = [];
+    for (var i = 0; i < wordsPerDoc; i++) {
+        text.push(words[(seed * 31 + i * 7) % words.length] + (i % 13));
+    }
+    return text.join(" ");
+}
+
+function run(language, words) {
+    t.drop();
+    assert.commandWorked(t.ensureIndex({text: "text"}, {default_language: language}));
+
+    var ms = Date.timeFunc(function() {
+        var bulk = t.initializeUnorderedBulkOp();
+        for (var i = 0; i < numDocs; i++) {
+            bulk.insert({text: makeText(words, i)});
+        }
+        assert.writeOK(bulk.execute());
+    });
+
+    assert.eq(numDocs, t.count());
+    print("language: " + language + "   documents: " + numDocs + "   time: " + ms + "ms" +
+          "   docs/sec: " + Math.round(numDocs * 1000 / ms));
+}
+
+run("english", englishWords);
+run("french", frenchWords);
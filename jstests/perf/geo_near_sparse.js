@@ -0,0 +1,54 @@
+/**
+ *  Times $near queries over sparse 2dsphere data with large search radii, and reports how many
+ *  search intervals and index keys they take.
+ */
+
+var t = db.perf.geo_near_sparse;
+t.drop();
+
+var numPts = 10 * 1000;
+var bulk = t.initializeUnorderedBulkOp();
+for (var i = 0; i < numPts; i++) {
+    var lng = Math.random() * 360 - 180;
+    var lat = Math.asin(Math.random() * 2 - 1) * 180 / Math.PI;
+    bulk.insert({geo: {type: "Point", coordinates: [lng, lat]}, i: i});
+}
+assert.writeOK(bulk.execute());
+assert.commandWorked(t.ensureIndex({geo: "2dsphere"}));
+
+function stageOf(plan, stageName) {
+    if (plan.stage === stageName) {
+        return plan;
+    }
+    var children = plan.inputStages || (plan.inputStage ? [plan.inputStage] : []);
+    for (var i = 0; i < children.length; i++) {
+        var found = stageOf(children[i], stageName);
+        if (found) {
+            return found;
+        }
+    }
+    return null;
+}
+
+[10, 100, 1000].forEach(function(limit) {
+    [1000 * 1000, 10000 * 1000, 20000 * 1000].forEach(function(maxDistance) {
+        var query = {
+            geo: {
+                $near: {
+                    $geometry: {type: "Point", coordinates: [12.5, 41.9]},
+                    $maxDistance: maxDistance
+                }
+            }
+        };
+
+        var ms = Date.timeFunc(function() {
+            t.find(query).limit(limit).itcount();
+        }, 10);
+
+        var stats = t.find(query).limit(limit).explain("executionStats").executionStats;
+        var near = stageOf(stats.executionStages, "GEO_NEAR_2DSPHERE");
+        print("limit: " + limit + "   maxDistance: " + maxDistance + "   time: " + ms + "ms" +
+              "   intervals: " + near.searchIntervals.length + "   keysExamined: " +
+              stats.totalKeysExamined + "   docsExamined: " + stats.totalDocsExamined);
+    });
+});
@@ -0,0 +1,45 @@
+/**
+ *  Times $geoWithin queries that repeat the same few polygons, which are served from the
+ *  geometry cache after their first use, with and without a 2dsphere index.
+ */
+
+var t = db.perf.geo_within_repeated;
+t.drop();
+
+var numPts = 100 * 1000;
+var bulk = t.initializeUnorderedBulkOp();
+for (var i = 0; i < numPts; i++) {
+    var lng = Math.random() * 40 - 20;
+    var lat = Math.random() * 40 - 20;
+    bulk.insert({geo: {type: "Point", coordinates: [lng, lat]}});
+}
+assert.writeOK(bulk.execute());
+
+// Irregular polygons of a few degrees across, with many vertices.
+var polygons = [];
+for (var p = 0; p < 50; p++) {
+    var cx = Math.random() * 30 - 15, cy = Math.random() * 30 - 15;
+    var ring = [];
+    for (var v = 0; v < 64; v++) {
+        var angle = 2 * Math.PI * v / 64;
+        var r = 1 + Math.random();
+        ring.push([cx + r * Math.cos(angle), cy + r * Math.sin(angle)]);
+    }
+    ring.push(ring[0]);
+    polygons.push({type: "Polygon", coordinates: [ring]});
+}
+
+function run(label) {
+    var numQueries = 2000;
+    var ms = Date.timeFunc(function() {
+        for (var q = 0; q < numQueries; q++) {
+            var polygon = polygons[q % polygons.length];
+            t.find({geo: {$geoWithin: {$geometry: polygon}}}).limit(100).itcount();
+        }
+    });
+    print(label + "   queries: " + numQueries + "   time: " + ms + "ms");
+}
+
+run("no index");
+assert.commandWorked(t.ensureIndex({geo: "2dsphere"}));
+run("2dsphere index");
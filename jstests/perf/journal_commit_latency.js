@@ -0,0 +1,37 @@
+/**
+ *  Times j:true inserts from a varying number of concurrent clients on MMAPv1 with journaling,
+ *  and reports the journal's group commit latency histogram.
+ */
+
+var t = db.perf.journal_commit_latency;
+var docsPerClient = 1000;
+
+function run(numClients) {
+    t.drop();
+
+    var ms = Date.timeFunc(function() {
+        var clients = [];
+        for (var c = 0; c < numClients; c++) {
+            var code = "var t = db.getSiblingDB('" + db.getName() + "')" +
+                ".perf.journal_commit_latency;" +
+                "for (var i = 0; i < " + docsPerClient + "; i++) {" +
+                "    t.insert({c: " + c + ", i: i}, {writeConcern: {j: true}});" +
+                "}";
+            clients.push(startParallelShell(code));
+        }
+        clients.forEach(function(join) {
+            join();
+        });
+    });
+
+    var total = numClients * docsPerClient;
+    print("clients: " + numClients + "   time: " + ms + "ms   j:true inserts/sec: " +
+          Math.round(total * 1000 / ms));
+}
+
+[1, 4, 16, 64].forEach(run);
+
+var dur = db.serverStatus().dur;
+if (dur) {
+    printjson(dur.commitLatencyMs);
+}
@@ -0,0 +1,39 @@
+/**
+ *  Times counting and summing mapReduce jobs with and without running their functions natively.
+ */
+
+var t = db.perf.mapreduce_count;
+t.drop();
+
+var bulk = t.initializeUnorderedBulkOp();
+for (var i = 0; i < 500 * 1000; i++) {
+    bulk.insert({customer: i % 1000, amount: i % 100 + 0.5});
+}
+assert.writeOK(bulk.execute());
+
+function countMap() {
+    emit(this.customer, 1);
+}
+
+function sumMap() {
+    emit(this.customer, this.amount);
+}
+
+function sumReduce(key, values) {
+    return Array.sum(values);
+}
+
+[true, false].forEach(function(useNative) {
+    assert.commandWorked(
+        db.adminCommand({setParameter: 1, internalMapReduceUseNativeFunctions: useNative}));
+    [countMap, sumMap].forEach(function(map) {
+        var res;
+        var ms = Date.timeFunc(function() {
+            res = t.mapReduce(map, sumReduce, {out: {inline: 1}});
+        });
+        print("native: " + useNative + "   map: " + map.name + "   time: " + ms + "ms" +
+              "   functions: " + tojson(res.functions));
+    });
+});
+assert.commandWorked(
+    db.adminCommand({setParameter: 1, internalMapReduceUseNativeFunctions: true}));
@@ -0,0 +1,45 @@
+/**
+ *  Times small in-place updates ($inc, and $set of a same-sized value) of large documents, which
+ *  storage engines supporting damage-based updates apply without rebuilding the document.
+ */
+
+var t = db.perf.update_inplace;
+var numDocs = 1000;
+var numUpdates = 100000;
+
+function setup(docSize) {
+    t.drop();
+    var filler = new Array(docSize).join("x");
+    var bulk = t.initializeUnorderedBulkOp();
+    for (var i = 0; i < numDocs; i++) {
+        bulk.insert({_id: i, counter: 0, flag: "aaaa", filler: filler});
+    }
+    assert.writeOK(bulk.execute());
+}
+
+function run(docSize) {
+    setup(docSize);
+
+    var inc = Date.timeFunc(function() {
+        for (var i = 0; i < numUpdates; i++) {
+            t.update({_id: i % numDocs}, {$inc: {counter: 1}});
+        }
+        assert.eq(numUpdates, t.aggregate({$group: {_id: null, n: {$sum: "$counter"}}})
+                                  .toArray()[0].n);
+    });
+
+    var set = Date.timeFunc(function() {
+        for (var i = 0; i < numUpdates; i++) {
+            t.update({_id: i % numDocs}, {$set: {flag: (i % 2) ? "bbbb" : "cccc"}});
+        }
+        db.getLastError();
+    });
+
+    print("document size: " + docSize + "   $inc: " + inc + "ms   $set: " + set + "ms");
+}
+
+printjson(db.serverStatus().storageEngine);
+[128, 1024, 16 * 1024, 256 * 1024].forEach(run);
+
+var stats = db.serverStatus().metrics.operation;
+print("fastmod updates: " + stats.fastmod);
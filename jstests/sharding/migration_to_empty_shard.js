@@ -0,0 +1,56 @@
+//
+// Tests that migrating a chunk to a shard whose collection is empty creates every index of the
+// collection there, and clones all documents of a chunk which takes several _migrateClone batches.
+//
+(function() {
+    "use strict";
+
+    var st = new ShardingTest({shards: 2, mongos: 1});
+    st.stopBalancer();
+
+    var mongos = st.s0;
+    var admin = mongos.getDB("admin");
+    var coll = mongos.getCollection("test.migration_to_empty_shard");
+    var shards = mongos.getDB("config").shards.find().sort({_id: 1}).toArray();
+
+    assert.commandWorked(admin.runCommand({enableSharding: coll.getDB().getName()}));
+    st.ensurePrimaryShard(coll.getDB().getName(), shards[0]._id);
+    assert.commandWorked(admin.runCommand({shardCollection: coll.getFullName(), key: {x: 1}}));
+    assert.commandWorked(coll.ensureIndex({y: 1}));
+    assert.commandWorked(coll.ensureIndex({x: 1, z: 1}, {unique: true}));
+
+    // The documents of the migrated chunk add up to about 25MB, more than fits into one batch.
+    var padding = new Array(50 * 1024).join("x");
+    var bulk = coll.initializeUnorderedBulkOp();
+    for (var i = 0; i < 1000; i++) {
+        bulk.insert({x: i, y: i % 10, z: i, padding: i >= 500 ? padding : ""});
+    }
+    assert.writeOK(bulk.execute());
+    assert.commandWorked(admin.runCommand({split: coll.getFullName(), middle: {x: 500}}));
+
+    // The recipient has no documents of the collection yet.
+    assert.commandWorked(admin.runCommand({moveChunk: coll.getFullName(),
+                                           find: {x: 500},
+                                           to: shards[1]._id,
+                                           _waitForDelete: true}));
+
+    var recipientColl = st.shard1.getCollection(coll.getFullName());
+    assert.eq(500, recipientColl.count());
+    var indexKeys = recipientColl.getIndexes().map(function(index) {
+        return tojson(index.key);
+    }).sort();
+    assert.eq([tojson({_id: 1}), tojson({x: 1}), tojson({y: 1}), tojson({x: 1, z: 1})].sort(),
+              indexKeys);
+
+    assert.eq(1000, coll.find().itcount());
+    assert.eq(100, coll.find({y: 3}).itcount());
+
+    // Migrating a chunk back to a shard which already has documents of the collection still works.
+    assert.commandWorked(admin.runCommand({moveChunk: coll.getFullName(),
+                                           find: {x: 500},
+                                           to: shards[0]._id,
+                                           _waitForDelete: true}));
+    assert.eq(1000, coll.find().itcount());
+
+    st.stop();
+}());
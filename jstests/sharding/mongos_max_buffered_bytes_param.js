@@ -0,0 +1,22 @@
+//
+// Tests that mongos rejects values of internalQueryMongosMaxBufferedBytes which are not positive.
+//
+(function() {
+    "use strict";
+
+    var st = new ShardingTest({shards: 1, mongos: 1});
+    var admin = st.s0.getDB("admin");
+
+    assert.commandFailed(
+        admin.runCommand({setParameter: 1, internalQueryMongosMaxBufferedBytes: 0}));
+    assert.commandFailed(
+        admin.runCommand({setParameter: 1, internalQueryMongosMaxBufferedBytes: -1}));
+    assert.commandWorked(
+        admin.runCommand({setParameter: 1, internalQueryMongosMaxBufferedBytes: 1024 * 1024}));
+
+    var result = admin.runCommand({getParameter: 1, internalQueryMongosMaxBufferedBytes: 1});
+    assert.commandWorked(result);
+    assert.eq(1024 * 1024, result.internalQueryMongosMaxBufferedBytes);
+
+    st.stop();
+}());
@@ -0,0 +1,57 @@
+//
+// Tests that mongos does not re-send setShardVersion to shards whose version did not change when
+// its chunk manager is reloaded after a split or migration on another shard.
+//
+
+var st = new ShardingTest({ shards : 3, mongos : 1 });
+st.stopBalancer();
+
+var mongos = st.s0;
+var coll = mongos.getCollection("foo.bar");
+var admin = mongos.getDB("admin");
+var shards = mongos.getDB("config").shards.find().sort({ _id : 1 }).toArray();
+
+assert.commandWorked(admin.runCommand({ enableSharding : coll.getDB().getName() }));
+st.ensurePrimaryShard(coll.getDB().getName(), shards[0]._id);
+assert.commandWorked(admin.runCommand({ shardCollection : coll.getFullName(), key : { x : 1 } }));
+assert.commandWorked(admin.runCommand({ split : coll.getFullName(), middle : { x : 0 } }));
+assert.commandWorked(admin.runCommand({ split : coll.getFullName(), middle : { x : 100 } }));
+assert.commandWorked(admin.runCommand({ moveChunk : coll.getFullName(),
+                                        find : { x : 0 },
+                                        to : shards[1]._id }));
+assert.commandWorked(admin.runCommand({ moveChunk : coll.getFullName(),
+                                        find : { x : 100 },
+                                        to : shards[2]._id }));
+
+assert.writeOK(coll.insert({ x : -50 }));
+assert.writeOK(coll.insert({ x : 50 }));
+assert.writeOK(coll.insert({ x : 150 }));
+
+function ssvStats() {
+    return mongos.getDB("admin").serverStatus().metrics.sharding.setShardVersion;
+}
+
+// Sets the shard version on the connections to all three shards
+assert.eq(3, coll.count());
+
+// Splitting the chunk on the first shard reloads the chunk manager, but only changes the
+// version of that shard
+var before = ssvStats();
+assert.commandWorked(admin.runCommand({ split : coll.getFullName(), middle : { x : -10 } }));
+assert.eq(3, coll.count());
+assert.eq(3, coll.find().itcount());
+
+var after = ssvStats();
+printjson(before);
+printjson(after);
+assert.gte(after.skipped - before.skipped, 2, tojson(after));
+
+// A migration changes the versions of both shards involved, and reads still see every document
+assert.commandWorked(admin.runCommand({ moveChunk : coll.getFullName(),
+                                        find : { x : 50 },
+                                        to : shards[2]._id }));
+assert.eq(3, coll.count());
+assert.eq(3, coll.find().itcount());
+assert.gt(ssvStats().sent, after.sent);
+
+st.stop();
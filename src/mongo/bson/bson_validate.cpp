@@ -28,13 +28,14 @@
  */
 
 #include <cstring>
-#include <deque>
 #include <limits>
+#include <vector>
 
 #include "mongo/base/data_view.h"
 #include "mongo/bson/bson_validate.h"
 #include "mongo/bson/oid.h"
 #include "mongo/db/jsobj.h"
+#include "mongo/platform/bits.h"
 #include "mongo/platform/decimal128.h"
 
 namespace mongo {
@@ -54,6 +55,29 @@ Status makeError(std::string baseMsg, BSONElement idElem) {
     return Status(ErrorCodes::InvalidBSON, baseMsg);
 }
 
+/**
+ * Returns the first NUL among the 'len' bytes at 'p', or NULL if there is none.
+ *
+ * Field names are mostly shorter than what it takes for memchr to pay off, so the first 16
+ * bytes are checked 8 at a time with word operations: (w - 0x01..) & ~w & 0x80.. has its lowest
+ * set bit in the first zero byte of w, reading w as little endian.
+ */
+inline const char* findCStringEnd(const char* p, uint64_t len) {
+    const uint64_t kLowBits = 0x0101010101010101ULL;
+    const uint64_t kHighBits = 0x8080808080808080ULL;
+
+    uint64_t offset = 0;
+    for (; offset < 16 && offset + sizeof(uint64_t) <= len; offset += sizeof(uint64_t)) {
+        const uint64_t word = ConstDataView(p).read<LittleEndian<uint64_t>>(offset);
+        const uint64_t zeroBytes = (word - kLowBits) & ~word & kHighBits;
+        if (zeroBytes) {
+            return p + offset + (countTrailingZeros64(zeroBytes) >> 3);
+        }
+    }
+
+    return static_cast<const char*>(memchr(p + offset, 0, len - offset));
+}
+
 class Buffer {
 public:
     Buffer(const char* buffer, uint64_t maxLength)
@@ -71,10 +95,10 @@ public:
     }
 
     Status readCString(StringData* out) {
-        const void* x = memchr(_buffer + _position, 0, _maxLength - _position);
+        const char* x = findCStringEnd(_buffer + _position, _maxLength - _position);
         if (!x)
             return makeError("no end of c-string", _idElem);
-        uint64_t len = static_cast<uint64_t>(static_cast<const char*>(x) - (_buffer + _position));
+        uint64_t len = static_cast<uint64_t>(x - (_buffer + _position));
 
         StringData data(_buffer + _position, len);
         _position += len + 1;
@@ -121,6 +145,10 @@ public:
         return _position;
     }
 
+    uint64_t maxLength() const {
+        return _maxLength;
+    }
+
     const char* getBasePtr() const {
         return _buffer;
     }
@@ -163,12 +191,84 @@ public:
         }
     }
 
+    /**
+     * Returns the position just past the end of the object, according to its size.
+     */
+    uint64_t endPosition() const {
+        return static_cast<uint64_t>(startPosition()) + expectedSize;
+    }
+
     int expectedSize;
 
 private:
     int _startPosition;
 };
 
+/**
+ * The objects being validated, innermost last. The first levels are kept inline so that
+ * validating a typical document does not allocate.
+ */
+class ValidationFrameStack {
+public:
+    ValidationObjectFrame& push() {
+        if (_size++ < kInlineFrames)
+            return _inlineFrames[_size - 1];
+        _overflowFrames.push_back(ValidationObjectFrame());
+        return _overflowFrames.back();
+    }
+
+    void pop() {
+        if (_size-- > kInlineFrames)
+            _overflowFrames.pop_back();
+    }
+
+    ValidationObjectFrame& back() {
+        return _size > kInlineFrames ? _overflowFrames.back() : _inlineFrames[_size - 1];
+    }
+
+    const ValidationObjectFrame& back() const {
+        return _size > kInlineFrames ? _overflowFrames.back() : _inlineFrames[_size - 1];
+    }
+
+    /**
+     * Returns the frame enclosing the innermost one, which must not be the outermost frame.
+     */
+    const ValidationObjectFrame& parent() const {
+        const size_t index = _size - 2;
+        return index >= kInlineFrames ? _overflowFrames[index - kInlineFrames]
+                                      : _inlineFrames[index];
+    }
+
+    bool empty() const {
+        return _size == 0;
+    }
+
+    size_t size() const {
+        return _size;
+    }
+
+private:
+    static const size_t kInlineFrames = 32;
+
+    ValidationObjectFrame _inlineFrames[kInlineFrames];
+    std::vector<ValidationObjectFrame> _overflowFrames;
+    size_t _size = 0;
+};
+
+/**
+ * Checks the size of the innermost frame, which was just read, against the bounds of the frame
+ * enclosing it, or of the buffer. Nested objects which cannot fit are rejected before walking
+ * their elements.
+ */
+bool frameSizeFits(const ValidationFrameStack& frames, const Buffer& buffer) {
+    const ValidationObjectFrame& curr = frames.back();
+    if (curr.expectedSize < 5)
+        return false;
+    const uint64_t limit =
+        frames.size() == 1 ? buffer.maxLength() : frames.parent().endPosition();
+    return curr.endPosition() <= limit;
+}
+
 /**
  * WARNING: only pass in a non-EOO idElem if it has been fully validated already!
  */
@@ -282,7 +382,7 @@ Status validateElementInfo(Buffer* buffer, ValidationState::State* nextState, BS
 }
 
 Status validateBSONIterative(Buffer* buffer) {
-    std::deque<ValidationObjectFrame> frames;
+    ValidationFrameStack frames;
     ValidationObjectFrame* curr = NULL;
     ValidationState::State state = ValidationState::BeginObj;
 
@@ -292,13 +392,15 @@ Status validateBSONIterative(Buffer* buffer) {
     while (state != ValidationState::Done) {
         switch (state) {
             case ValidationState::BeginObj:
-                frames.push_back(ValidationObjectFrame());
-                curr = &frames.back();
+                curr = &frames.push();
                 curr->setStartPosition(buffer->position());
                 curr->setIsCodeWithScope(false);
                 if (!buffer->readNumber<int>(&curr->expectedSize)) {
                     return makeError("bson size is larger than buffer size", idElem);
                 }
+                if (!frameSizeFits(frames, *buffer)) {
+                    return makeError("bson length doesn't match what we found", idElem);
+                }
                 state = ValidationState::WithinObj;
             // fall through
             case ValidationState::WithinObj: {
@@ -332,7 +434,7 @@ Status validateBSONIterative(Buffer* buffer) {
                 if (actualLength != curr->expectedSize) {
                     return makeError("bson length doesn't match what we found", idElem);
                 }
-                frames.pop_back();
+                frames.pop();
                 if (frames.empty()) {
                     state = ValidationState::Done;
                 } else {
@@ -345,12 +447,14 @@ Status validateBSONIterative(Buffer* buffer) {
                 break;
             }
             case ValidationState::BeginCodeWScope: {
-                frames.push_back(ValidationObjectFrame());
-                curr = &frames.back();
+                curr = &frames.push();
                 curr->setStartPosition(buffer->position());
                 curr->setIsCodeWithScope(true);
                 if (!buffer->readNumber<int>(&curr->expectedSize))
                     return makeError("invalid bson CodeWScope size", idElem);
+                if (!frameSizeFits(frames, *buffer))
+                    return makeError("bson length for CodeWScope doesn't match what we found",
+                                     idElem);
                 Status status = buffer->readUTF8String(NULL);
                 if (!status.isOK())
                     return status;
@@ -363,7 +467,7 @@ Status validateBSONIterative(Buffer* buffer) {
                     return makeError("bson length for CodeWScope doesn't match what we found",
                                      idElem);
                 }
-                frames.pop_back();
+                frames.pop();
                 if (frames.empty())
                     return makeError("unnested CodeWScope", idElem);
                 curr = &frames.back();
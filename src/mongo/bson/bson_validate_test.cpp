@@ -310,6 +310,51 @@ TEST(BSONValidateFast, StringHasSomething) {
     ASSERT_NOT_OK(validateBSON(x.objdata(), x.objsize()));
 }
 
+TEST(BSONValidateFast, FieldNameLengths) {
+    // Field names both shorter and longer than the bytes scanned a word at a time.
+    for (size_t len = 0; len < 40; len++) {
+        const std::string name(len, 'f');
+        BSONObj x = BSON(name << 1 << "after" << name);
+        ASSERT_OK(validateBSON(x.objdata(), x.objsize()));
+
+        // Without the terminating NUL nor anything after it, the name has no end.
+        BufBuilder bb;
+        bb.appendNum(static_cast<int>(4 + 1 + len));
+        bb.appendChar(NumberInt);
+        bb.appendStr(name, /*withNUL*/ false);
+        ASSERT_NOT_OK(validateBSON(bb.buf(), bb.len()));
+    }
+}
+
+TEST(BSONValidateFast, DeeplyNestedObject) {
+    BSONObj x = BSON("leaf" << 1);
+    for (int i = 0; i < 100; i++) {
+        x = BSON("a" << x << "b" << BSON_ARRAY(i));
+    }
+    ASSERT_OK(validateBSON(x.objdata(), x.objsize()));
+    ASSERT_NOT_OK(validateBSON(x.objdata(), x.objsize() - 1));
+
+    // Corrupt the size of the innermost object.
+    BSONObj copy = x.copy();
+    char* leaf = const_cast<char*>(copy.objdata());
+    while (leaf[4] == Object) {
+        leaf += 4 + 1 + 2;  // size, type, "a"
+    }
+    DataView(leaf).write(tagLittleEndian(ConstDataView(leaf).read<LittleEndian<int>>() + 1));
+    ASSERT_NOT_OK(validateBSON(copy.objdata(), copy.objsize()));
+}
+
+TEST(BSONValidateFast, NestedObjectLargerThanParent) {
+    BSONObj x = BSON("a" << BSON("b" << 1) << "c" << 2);
+    BSONObj copy = x.copy();
+    char* nested = const_cast<char*>(copy["a"].value());
+    DataView(nested).write(tagLittleEndian(copy.objsize()));
+    ASSERT_NOT_OK(validateBSON(copy.objdata(), copy.objsize()));
+
+    DataView(nested).write(tagLittleEndian(4));
+    ASSERT_NOT_OK(validateBSON(copy.objdata(), copy.objsize()));
+}
+
 TEST(BSONValidateBool, BoolValuesAreValidated) {
     BSONObjBuilder bob;
     bob.append("x", false);
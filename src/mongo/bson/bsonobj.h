@@ -184,6 +184,21 @@ public:
     /** @return a new full (and owned) copy of the object. */
     BSONObj copy() const;
 
+    /** @return the buffer backing this object. Null if this object is not owned. */
+    const SharedBuffer& sharedBuffer() const {
+        return _ownedBuffer;
+    }
+
+    /**
+     * Transfers ownership of the underlying buffer to the caller and leaves this BSONObj empty.
+     * Returns a null SharedBuffer if this object is not owned.
+     */
+    SharedBuffer releaseSharedBuffer() {
+        SharedBuffer out(std::move(_ownedBuffer));
+        _objdata = BSONObj()._objdata;
+        return out;
+    }
+
     /** Readable representation of a BSON object in an extended JSON-style notation.
         This is an abbreviated representation which might be used for logging.
     */
@@ -31,6 +31,7 @@
 
 #include <cstdint>
 
+#include "mongo/base/data_view.h"
 #include "mongo/base/parse_number.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/platform/decimal128.h"
@@ -80,6 +81,55 @@ static const char* LBRACE = "{", * RBRACE = "}", * LBRACKET = "[", * RBRACKET =
                    * RPAREN = ")", * COLON = ":", * COMMA = ",", * FORWARDSLASH = "/",
                    * SINGLEQUOTE = "'", * DOUBLEQUOTE = "\"";
 
+namespace {
+
+/**
+ * Returns the first character in [p, end) which is 'quote', a backslash or a control character,
+ * or 'end' if there is none.
+ *
+ * Strings mostly consist of runs of characters which need no processing, which are skipped 8 at
+ * a time: for each byte b of a word w, (w - 0x01..) & ~w has the high bit of b set if b is zero,
+ * and (w - 0x20..) & ~w if b is below 0x20. A word with any of these bits set is then scanned
+ * one character at a time.
+ */
+const char* findStringSpecialChar(const char* p, const char* end, char quote) {
+    const uint64_t kLowBits = 0x0101010101010101ULL;
+    const uint64_t kHighBits = 0x8080808080808080ULL;
+    const uint64_t quotes = kLowBits * static_cast<unsigned char>(quote);
+    const uint64_t backslashes = kLowBits * '\\';
+
+    while (end - p >= static_cast<ptrdiff_t>(sizeof(uint64_t))) {
+        const uint64_t word = ConstDataView(p).read<uint64_t>();
+        const uint64_t quoteBytes = word ^ quotes;
+        const uint64_t backslashBytes = word ^ backslashes;
+        const uint64_t special = ((quoteBytes - kLowBits) & ~quoteBytes) |
+            ((backslashBytes - kLowBits) & ~backslashBytes) | ((word - kLowBits * 0x20) & ~word);
+        if (special & kHighBits) {
+            break;
+        }
+        p += sizeof(uint64_t);
+    }
+
+    while (p < end && *p != quote && *p != '\\' && static_cast<unsigned char>(*p) >= 0x20) {
+        ++p;
+    }
+    return p;
+}
+
+inline bool isUnquotedFieldChar(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') ||
+        c == '_' || c == '$';
+}
+
+inline bool isSpace(char c) {
+    // 'isspace()' takes an 'int' (signed), so (default signed) 'char's get sign-extended
+    // and therefore 'corrupted' unless we force them to be unsigned ... 0x80 becomes
+    // 0xffffff80 as seen by isspace when sign-extended ... we want it to be 0x00000080
+    return isspace(static_cast<unsigned char>(c));
+}
+
+}  // namespace
+
 JParse::JParse(StringData str)
     : _buf(str.rawData()), _input(_buf), _input_end(_input + str.size()) {}
 
@@ -95,6 +145,24 @@ Status JParse::parseError(StringData msg) {
 
 Status JParse::value(StringData fieldName, BSONObjBuilder& builder) {
     MONGO_JSON_DEBUG("fieldName: " << fieldName);
+
+    // Strings and numbers, the most common values, cannot be mistaken for any of the keywords
+    // below, so they are recognized by their first character without trying each keyword.
+    const char next = peekChar();
+    if (next == '"' || next == '\'') {
+        StringData valueString;
+        std::string scratch;
+        Status ret = quotedString(&valueString, &scratch);
+        if (ret != Status::OK()) {
+            return ret;
+        }
+        builder.append(fieldName, valueString);
+        return Status::OK();
+    }
+    if ((next >= '0' && next <= '9') || next == '.') {
+        return number(fieldName, builder);
+    }
+
     if (peekToken(LBRACE)) {
         Status ret = object(fieldName, builder);
         if (ret != Status::OK()) {
@@ -201,9 +269,9 @@ Status JParse::object(StringData fieldName, BSONObjBuilder& builder, bool subObj
     }
 
     // Special object
-    std::string firstField;
-    firstField.reserve(FIELD_RESERVE_SIZE);
-    Status ret = field(&firstField);
+    StringData firstField;
+    std::string firstFieldScratch;
+    Status ret = field(&firstField, &firstFieldScratch);
     if (ret != Status::OK()) {
         return ret;
     }
@@ -314,10 +382,10 @@ Status JParse::object(StringData fieldName, BSONObjBuilder& builder, bool subObj
         if (valueRet != Status::OK()) {
             return valueRet;
         }
+        std::string fieldNameScratch;
         while (readToken(COMMA)) {
-            std::string fieldName;
-            fieldName.reserve(FIELD_RESERVE_SIZE);
-            Status fieldRet = field(&fieldName);
+            StringData fieldName;
+            Status fieldRet = field(&fieldName, &fieldNameScratch);
             if (fieldRet != Status::OK()) {
                 return fieldRet;
             }
@@ -991,6 +1059,34 @@ Status JParse::regexOptCheck(StringData opt) {
 }
 
 Status JParse::number(StringData fieldName, BSONObjBuilder& builder) {
+    // Integers of up to 18 digits, which cannot overflow, are parsed here: when the digits are
+    // not followed by anything strtod would read further, strtod and strtoll below would both
+    // stop after them and the value would be stored as an integer.
+    const char* p = _input;
+    while (p < _input_end && isSpace(*p)) {
+        ++p;
+    }
+    const bool negative = p < _input_end && *p == '-';
+    const char* const digits = negative ? p + 1 : p;
+    const char* q = digits;
+    long long integer = 0;
+    while (q < _input_end && q - digits < 18 && *q >= '0' && *q <= '9') {
+        integer = integer * 10 + (*q - '0');
+        ++q;
+    }
+    if (q > digits && q < _input_end && !match(*q, DIGIT ".eExX")) {
+        if (negative) {
+            integer = -integer;
+        }
+        if (integer == static_cast<int>(integer)) {
+            builder.append(fieldName, static_cast<int>(integer));
+        } else {
+            builder.append(fieldName, integer);
+        }
+        _input = q;
+        return Status::OK();
+    }
+
     char* endptrll;
     char* endptrd;
     long long retll;
@@ -1058,6 +1154,67 @@ Status JParse::field(std::string* result) {
     }
 }
 
+Status JParse::field(StringData* result, std::string* scratch) {
+    MONGO_JSON_DEBUG("");
+    const char next = peekChar();
+    if (next == '"' || next == '\'') {
+        return quotedString(result, scratch);
+    }
+
+    // Unquoted keys have no escape sequences, so they can always be used in place
+    while (_input < _input_end && isSpace(*_input)) {
+        ++_input;
+    }
+    if (_input >= _input_end) {
+        return parseError("Field name expected");
+    }
+    if (!match(*_input, ALPHA "_$")) {
+        return parseError("First character in field must be [A-Za-z$_]");
+    }
+    const char* q = _input;
+    while (q < _input_end && isUnquotedFieldChar(*q)) {
+        ++q;
+    }
+    if (q >= _input_end) {
+        return parseError("Unexpected end of input");
+    }
+    *result = StringData(_input, q - _input);
+    _input = q;
+    return Status::OK();
+}
+
+Status JParse::quotedString(StringData* result, std::string* scratch) {
+    MONGO_JSON_DEBUG("");
+    const char* quote;
+    if (readToken(DOUBLEQUOTE)) {
+        quote = DOUBLEQUOTE;
+    } else if (readToken(SINGLEQUOTE)) {
+        quote = SINGLEQUOTE;
+    } else {
+        return parseError("Expecting quoted string");
+    }
+
+    const char* q = findStringSpecialChar(_input, _input_end, *quote);
+    if (q < _input_end && *q == *quote) {
+        *result = StringData(_input, q - _input);
+        _input = q + 1;
+        return Status::OK();
+    }
+
+    // Escape sequences, control characters and unterminated strings are left to chars()
+    scratch->assign(_input, q - _input);
+    _input = q;
+    Status ret = chars(scratch, quote);
+    if (ret != Status::OK()) {
+        return ret;
+    }
+    if (!readToken(quote)) {
+        return parseError(quote == DOUBLEQUOTE ? "Expecting '\"'" : "Expecting '''");
+    }
+    *result = *scratch;
+    return Status::OK();
+}
+
 Status JParse::quotedString(std::string* result) {
     MONGO_JSON_DEBUG("");
     if (readToken(DOUBLEQUOTE)) {
@@ -1235,6 +1392,21 @@ bool JParse::readTokenImpl(const char* token, bool advance) {
     return true;
 }
 
+char JParse::peekChar() const {
+    const char* check = _input;
+    while (check < _input_end && isSpace(*check)) {
+        ++check;
+    }
+    return check < _input_end ? *check : '\0';
+}
+
+bool JParse::atEnd() {
+    while (_input < _input_end && isSpace(*_input)) {
+        ++_input;
+    }
+    return _input >= _input_end;
+}
+
 bool JParse::readField(StringData expectedField) {
     MONGO_JSON_DEBUG("expectedField: " << expectedField);
     std::string nextField;
@@ -1285,15 +1457,12 @@ bool JParse::isArray() {
     return peekToken(LBRACKET);
 }
 
-BSONObj fromjson(const char* jsonString, int* len) {
-    MONGO_JSON_DEBUG("jsonString: " << jsonString);
-    if (jsonString[0] == '\0') {
-        if (len)
-            *len = 0;
-        return BSONObj();
-    }
-    JParse jparse(jsonString);
-    BSONObjBuilder builder;
+namespace {
+
+/**
+ * Parses the next object of 'jparse' into 'builder', throwing if it is not valid JSON.
+ */
+void parseOrThrow(JParse& jparse, BSONObjBuilder& builder) {
     Status ret = Status::OK();
     try {
         ret = jparse.parse(builder);
@@ -1308,11 +1477,40 @@ BSONObj fromjson(const char* jsonString, int* len) {
         message << "code " << ret.code() << ": " << ret.codeString() << ": " << ret.reason();
         throw MsgAssertionException(16619, message.str());
     }
+}
+
+}  // namespace
+
+BSONObj fromjson(const char* jsonString, int* len) {
+    MONGO_JSON_DEBUG("jsonString: " << jsonString);
+    if (jsonString[0] == '\0') {
+        if (len)
+            *len = 0;
+        return BSONObj();
+    }
+    JParse jparse(jsonString);
+    BSONObjBuilder builder;
+    parseOrThrow(jparse, builder);
     if (len)
         *len = jparse.offset();
     return builder.obj();
 }
 
+size_t fromjsonStream(const char* jsonString,
+                      const stdx::function<void(const BSONObj&)>& callback) {
+    JParse jparse(jsonString);
+    BufBuilder buffer;
+    size_t count = 0;
+    while (!jparse.atEnd()) {
+        buffer.reset();
+        BSONObjBuilder builder(buffer);
+        parseOrThrow(jparse, builder);
+        callback(builder.done());
+        count++;
+    }
+    return count;
+}
+
 BSONObj fromjson(const std::string& str) {
     return fromjson(str.c_str());
 }
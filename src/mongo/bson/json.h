@@ -32,6 +32,7 @@
 
 #include "mongo/bson/bsonobj.h"
 #include "mongo/base/status.h"
+#include "mongo/stdx/functional.h"
 
 namespace mongo {
 
@@ -53,6 +54,17 @@ BSONObj fromjson(const std::string& str);
 /** @param len will be size of JSON object in text chars. */
 BSONObj fromjson(const char* str, int* len = NULL);
 
+/**
+ * Parses a null terminated sequence of JSON objects separated by whitespace, such as a file with
+ * one document per line, passing each of them to 'callback' as it is parsed. The objects passed
+ * to 'callback' are only valid for the duration of the call, since their buffer is reused for the
+ * next one.
+ *
+ * @return the number of objects parsed.
+ * @throws MsgAssertionException if parsing fails, after passing 'callback' the objects before.
+ */
+size_t fromjsonStream(const char* str, const stdx::function<void(const BSONObj&)>& callback);
+
 /**
  * Tests whether the JSON string is an Array.
  *
@@ -366,6 +378,12 @@ private:
      */
     Status field(std::string* result);
 
+    /**
+     * Same as field(std::string*), but does not copy field names which need no unescaping:
+     * 'result' then points into the input buffer. Otherwise 'scratch' holds the field name.
+     */
+    Status field(StringData* result, std::string* scratch);
+
     /*
      * std::string :
      *     " "
@@ -375,6 +393,12 @@ private:
      */
     Status quotedString(std::string* result);
 
+    /**
+     * Same as quotedString(std::string*), but does not copy strings without escape sequences:
+     * 'result' then points into the input buffer. Otherwise 'scratch' holds the string.
+     */
+    Status quotedString(StringData* result, std::string* scratch);
+
     /*
      * CHARS :
      *     CHAR
@@ -443,6 +467,13 @@ private:
      */
     bool readTokenImpl(const char* token, bool advance = true);
 
+    /**
+     * @return the next non whitespace character in our buffer, or '\0' if
+     * we reach the end of our buffer.  Does not update the pointer to our
+     * buffer.
+     */
+    char peekChar() const;
+
     /**
      * @return true if the next field in our stream matches field.
      * Handles single quoted, double quoted, and unquoted field names
@@ -477,6 +508,11 @@ public:
         return (_input - _buf);
     }
 
+    /**
+     * Skips whitespace and returns true if the end of the input was reached.
+     */
+    bool atEnd();
+
 private:
     /*
      * _buf - start of our input buffer
@@ -0,0 +1,202 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/bson/key_shape_comparator.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "mongo/base/compare_numbers.h"
+#include "mongo/base/data_view.h"
+#include "mongo/bson/bsonelement.h"
+#include "mongo/bson/oid.h"
+
+namespace mongo {
+
+namespace {
+
+// Routines comparing values of a single type, which give the same results as
+// compareElementValues() does for two elements of that type.
+
+template <typename T>
+T readValue(const char* value) {
+    return ConstDataView(value).read<LittleEndian<T>>();
+}
+
+int compareNumberInts(const char** lhs, const char** rhs) {
+    const int result = compareInts(readValue<int32_t>(*lhs), readValue<int32_t>(*rhs));
+    *lhs += sizeof(int32_t);
+    *rhs += sizeof(int32_t);
+    return result;
+}
+
+int compareNumberLongs(const char** lhs, const char** rhs) {
+    const int result = compareLongs(readValue<int64_t>(*lhs), readValue<int64_t>(*rhs));
+    *lhs += sizeof(int64_t);
+    *rhs += sizeof(int64_t);
+    return result;
+}
+
+int compareNumberDoubles(const char** lhs, const char** rhs) {
+    const int result = compareDoubles(readValue<double>(*lhs), readValue<double>(*rhs));
+    *lhs += sizeof(double);
+    *rhs += sizeof(double);
+    return result;
+}
+
+int compareDates(const char** lhs, const char** rhs) {
+    // Dates are compared as signed milliseconds.
+    const int result = compareLongs(readValue<int64_t>(*lhs), readValue<int64_t>(*rhs));
+    *lhs += sizeof(int64_t);
+    *rhs += sizeof(int64_t);
+    return result;
+}
+
+int compareBools(const char** lhs, const char** rhs) {
+    const int result = compareInts(**lhs, **rhs);
+    *lhs += 1;
+    *rhs += 1;
+    return result;
+}
+
+int compareOIDs(const char** lhs, const char** rhs) {
+    const int result = memcmp(*lhs, *rhs, OID::kOIDSize);
+    *lhs += OID::kOIDSize;
+    *rhs += OID::kOIDSize;
+    return result < 0 ? -1 : (result > 0 ? 1 : 0);
+}
+
+int compareStrings(const char** lhs, const char** rhs) {
+    // The sizes include the terminating NUL. Strings may contain NULs, so memcmp is used.
+    const int32_t lhsSize = readValue<int32_t>(*lhs);
+    const int32_t rhsSize = readValue<int32_t>(*rhs);
+    int result =
+        memcmp(*lhs + sizeof(int32_t), *rhs + sizeof(int32_t), std::min(lhsSize, rhsSize));
+    if (result == 0) {
+        result = lhsSize - rhsSize;
+    }
+    *lhs += sizeof(int32_t) + lhsSize;
+    *rhs += sizeof(int32_t) + rhsSize;
+    return result < 0 ? -1 : (result > 0 ? 1 : 0);
+}
+
+/**
+ * Returns the routine comparing values of type 'type', or NULL if there is none.
+ */
+int (*compareValuesFor(BSONType type))(const char**, const char**) {
+    switch (type) {
+        case NumberInt:
+            return &compareNumberInts;
+        case NumberLong:
+            return &compareNumberLongs;
+        case NumberDouble:
+            return &compareNumberDoubles;
+        case Date:
+            return &compareDates;
+        case Bool:
+            return &compareBools;
+        case jstOID:
+            return &compareOIDs;
+        case String:
+            return &compareStrings;
+        default:
+            return NULL;
+    }
+}
+
+}  // namespace
+
+KeyShapeComparator::KeyShapeComparator(Ordering ordering, const BSONObj& sampleKey)
+    : _ordering(ordering) {
+    // Ordering only holds the directions of the first 32 fields.
+    BSONObjIterator it(sampleKey);
+    while (it.more() && _fields.size() < 32) {
+        const BSONElement elem = it.next();
+        const CompareValuesFn compareValues = compareValuesFor(elem.type());
+        if (!compareValues || elem.fieldNameSize() != 1) {
+            break;
+        }
+
+        Field field;
+        field.type = static_cast<char>(elem.type());
+        field.direction = ordering.get(_fields.size());
+        field.compareValues = compareValues;
+        _fields.push_back(field);
+    }
+}
+
+int KeyShapeComparator::compare(const BSONObj& lhs, const BSONObj& rhs) const {
+    const char* l = lhs.objdata() + sizeof(int32_t);
+    const char* r = rhs.objdata() + sizeof(int32_t);
+    for (size_t i = 0; i < _fields.size(); ++i) {
+        const Field& field = _fields[i];
+        // Check the type bytes first: a key with fewer fields ends with EOO here, and its
+        // field name byte would lie past the end of the object.
+        if (l[0] != field.type || r[0] != field.type || l[1] != '\0' || r[1] != '\0') {
+            return compareGeneric(l, r, i);
+        }
+
+        l += 2;
+        r += 2;
+        if (const int result = field.compareValues(&l, &r)) {
+            return result * field.direction;
+        }
+    }
+    return compareGeneric(l, r, _fields.size());
+}
+
+int KeyShapeComparator::compareGeneric(const char* lhs, const char* rhs, size_t fieldIndex) const {
+    // Like BSONObj::woCompare(), which lets the mask overflow past the 32nd field.
+    unsigned mask = fieldIndex < 32 ? 1u << fieldIndex : 0;
+    while (true) {
+        const BSONElement l(lhs);
+        const BSONElement r(rhs);
+        if (l.eoo()) {
+            return r.eoo() ? 0 : -1;
+        }
+        if (r.eoo()) {
+            return 1;
+        }
+
+        int result = l.woCompare(r, false);
+        if (_ordering.descending(mask)) {
+            result = -result;
+        }
+        if (result != 0) {
+            return result;
+        }
+
+        lhs += l.size();
+        rhs += r.size();
+        mask <<= 1;
+    }
+}
+
+}  // namespace mongo
@@ -0,0 +1,97 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "mongo/bson/bsonobj.h"
+#include "mongo/bson/ordering.h"
+
+namespace mongo {
+
+/**
+ * Compares keys, BSONObjs whose field names are ignored, the same way as
+ * BSONObj::woCompare(other, ordering, false).
+ *
+ * Index and sort keys mostly have the same types in the same positions, e.g. all keys of an index
+ * on {a: 1, b: 1} might be an int followed by a string, and always have empty field names. A
+ * KeyShapeComparator is made from one such sample key, and compares each leading field of that
+ * shape with a routine specialized for its type, skipping the work of finding canonical types
+ * and element sizes. Comparison falls back to the generic code from the first field of a key
+ * which does not have the sample's type or has a field name.
+ */
+class KeyShapeComparator {
+public:
+    /**
+     * The leading fields of 'sampleKey' of types with specialized routines make up the shape.
+     * An empty 'sampleKey' gives a comparator which only uses the generic code.
+     */
+    KeyShapeComparator(Ordering ordering, const BSONObj& sampleKey);
+
+    /**
+     * Returns a negative number, zero or a positive number as
+     * lhs.woCompare(rhs, ordering, false) would.
+     */
+    int compare(const BSONObj& lhs, const BSONObj& rhs) const;
+
+    /**
+     * Returns the number of leading fields compared by specialized routines for keys of the
+     * sample's shape.
+     */
+    size_t specializedFields() const {
+        return _fields.size();
+    }
+
+private:
+    // Compares the values of the same type starting at '*lhs' and '*rhs' and advances both past
+    // them. Returns -1, 0 or 1.
+    typedef int (*CompareValuesFn)(const char** lhs, const char** rhs);
+
+    struct Field {
+        // The type byte of the element, which is followed by an empty field name.
+        char type;
+
+        // 1 if ascending, -1 if descending.
+        int direction;
+
+        CompareValuesFn compareValues;
+    };
+
+    /**
+     * Compares the remaining elements of two keys starting at 'lhs' and 'rhs', the elements
+     * before which compared equal, the way BSONObj::woCompare() does.
+     */
+    int compareGeneric(const char* lhs, const char* rhs, size_t fieldIndex) const;
+
+    Ordering _ordering;
+    std::vector<Field> _fields;
+};
+
+}  // namespace mongo
@@ -0,0 +1,189 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/bson/key_shape_comparator.h"
+
+#include <cstring>
+#include <limits>
+#include <memory>
+
+#include "mongo/db/jsobj.h"
+#include "mongo/unittest/unittest.h"
+
+namespace {
+
+using namespace mongo;
+
+int sign(int x) {
+    return x < 0 ? -1 : (x > 0 ? 1 : 0);
+}
+
+/**
+ * Asserts that 'comparator' orders each pair of 'keys' the same way as woCompare().
+ */
+void assertComparesLikeWoCompare(const KeyShapeComparator& comparator,
+                                 const BSONObj& pattern,
+                                 const std::vector<BSONObj>& keys) {
+    const Ordering ordering = Ordering::make(pattern);
+    for (size_t i = 0; i < keys.size(); i++) {
+        for (size_t j = 0; j < keys.size(); j++) {
+            const int expected = sign(keys[i].woCompare(keys[j], ordering, false));
+            if (sign(comparator.compare(keys[i], keys[j])) != expected) {
+                FAIL(str::stream() << "comparing " << keys[i] << " and " << keys[j]
+                                   << " with pattern " << pattern << " should give "
+                                   << expected);
+            }
+        }
+    }
+}
+
+std::vector<BSONObj> numberAndStringKeys() {
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    std::vector<BSONObj> keys;
+    keys.push_back(BSON("" << 1 << ""
+                           << "a"));
+    keys.push_back(BSON("" << 1 << ""
+                           << "b"));
+    keys.push_back(BSON("" << 1 << ""
+                           << "ab"));
+    keys.push_back(BSON("" << 1 << "" << StringData("a\0b", StringData::LiteralTag())));
+    keys.push_back(BSON("" << -5 << ""
+                           << ""));
+    keys.push_back(BSON("" << 7 << ""
+                           << "a"));
+    keys.push_back(BSON("" << std::numeric_limits<int>::min() << ""
+                           << "z"));
+    keys.push_back(BSON("" << std::numeric_limits<int>::max() << ""
+                           << "z"));
+    // Mismatched types, which are compared generically.
+    keys.push_back(BSON("" << 1LL << ""
+                           << "a"));
+    keys.push_back(BSON("" << 1.5 << ""
+                           << "a"));
+    keys.push_back(BSON("" << nan << ""
+                           << "a"));
+    keys.push_back(BSON("" << 1 << "" << 2));
+    keys.push_back(BSON("" << 1 << "" << BSONNULL));
+    keys.push_back(BSON(""
+                        << "1"
+                        << ""
+                        << "a"));
+    // Field names, shorter and longer keys.
+    keys.push_back(BSON("x" << 1 << ""
+                            << "a"));
+    keys.push_back(BSON("" << 1 << "x"
+                           << "a"));
+    keys.push_back(BSON("" << 1));
+    keys.push_back(BSON("" << 1 << ""
+                           << "a"
+                           << "" << 0));
+    keys.push_back(BSONObj());
+    return keys;
+}
+
+TEST(KeyShapeComparator, IntAndString) {
+    const std::vector<BSONObj> keys = numberAndStringKeys();
+    const BSONObj sample = BSON("" << 0 << ""
+                                   << "");
+
+    const BSONObj patterns[] = {BSON("a" << 1 << "b" << 1),
+                                BSON("a" << 1 << "b" << -1),
+                                BSON("a" << -1 << "b" << -1)};
+    for (const BSONObj& pattern : patterns) {
+        const KeyShapeComparator comparator(Ordering::make(pattern), sample);
+        ASSERT_EQUALS(2U, comparator.specializedFields());
+        assertComparesLikeWoCompare(comparator, pattern, keys);
+    }
+}
+
+TEST(KeyShapeComparator, OtherShapes) {
+    const std::vector<BSONObj> keys = numberAndStringKeys();
+    const BSONObj pattern = BSON("a" << 1 << "b" << -1 << "c" << 1);
+    const Ordering ordering = Ordering::make(pattern);
+
+    // Sample keys of other shapes give comparators specialized for fewer or other fields.
+    assertComparesLikeWoCompare(KeyShapeComparator(ordering, BSONObj()), pattern, keys);
+    assertComparesLikeWoCompare(KeyShapeComparator(ordering, BSON("" << 1.5)), pattern, keys);
+    assertComparesLikeWoCompare(
+        KeyShapeComparator(ordering, BSON("" << 1LL << "" << 2)), pattern, keys);
+    assertComparesLikeWoCompare(
+        KeyShapeComparator(ordering, BSON("" << 1 << "" << BSONNULL)), pattern, keys);
+    assertComparesLikeWoCompare(
+        KeyShapeComparator(ordering, BSON("a" << 1 << "b" << 2)), pattern, keys);
+}
+
+TEST(KeyShapeComparator, SpecializedTypes) {
+    const OID oid1 = OID("000000000000000000000001");
+    const OID oid2 = OID("100000000000000000000000");
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+
+    std::vector<BSONObj> keys;
+    keys.push_back(BSON("" << 2LL << "" << 1.0 << "" << Date_t::fromMillisSinceEpoch(-1) << ""
+                           << true << "" << oid1));
+    keys.push_back(BSON("" << 2LL << "" << 1.0 << "" << Date_t::fromMillisSinceEpoch(1) << ""
+                           << true << "" << oid1));
+    keys.push_back(BSON("" << 2LL << "" << 1.0 << "" << Date_t::fromMillisSinceEpoch(1) << ""
+                           << false << "" << oid1));
+    keys.push_back(BSON("" << 2LL << "" << 1.0 << "" << Date_t::fromMillisSinceEpoch(1) << ""
+                           << false << "" << oid2));
+    keys.push_back(BSON("" << 2LL << "" << nan << "" << Date_t::fromMillisSinceEpoch(1) << ""
+                           << false << "" << oid2));
+    keys.push_back(BSON("" << 2LL << "" << -0.0 << "" << Date_t::fromMillisSinceEpoch(1) << ""
+                           << false << "" << oid2));
+    keys.push_back(BSON("" << -(1LL << 40) << "" << 1.0 << ""
+                           << Date_t::fromMillisSinceEpoch(1) << "" << false << "" << oid2));
+    keys.push_back(BSON("" << 2LL << "" << 2 << "" << Date_t::fromMillisSinceEpoch(1) << ""
+                           << false << "" << oid2));
+
+    const BSONObj pattern = BSON("a" << 1 << "b" << -1 << "c" << 1 << "d" << -1 << "e" << 1);
+    const KeyShapeComparator comparator(Ordering::make(pattern), keys[0]);
+    ASSERT_EQUALS(5U, comparator.specializedFields());
+    assertComparesLikeWoCompare(comparator, pattern, keys);
+}
+
+TEST(KeyShapeComparator, ShorterKeysAreNotReadPastTheirEnd) {
+    const BSONObj pattern = BSON("a" << 1 << "b" << 1);
+    const KeyShapeComparator comparator(Ordering::make(pattern), BSON("" << 0 << "" << 0));
+    ASSERT_EQUALS(2U, comparator.specializedFields());
+
+    // Copy each key into a buffer of exactly its size, so that reading past the end of a key
+    // is caught by the address sanitizer.
+    const BSONObj keys[] = {BSONObj(), BSON("" << 1), BSON("" << 1 << "" << 2)};
+    std::vector<std::unique_ptr<char[]>> buffers;
+    std::vector<BSONObj> exactKeys;
+    for (const BSONObj& key : keys) {
+        buffers.emplace_back(new char[key.objsize()]);
+        memcpy(buffers.back().get(), key.objdata(), key.objsize());
+        exactKeys.push_back(BSONObj(buffers.back().get()));
+    }
+    assertComparesLikeWoCompare(comparator, pattern, exactKeys);
+}
+
+}  // namespace
@@ -43,6 +43,7 @@
 #include "mongo/platform/decimal128.h"
 #include "mongo/util/allocator.h"
 #include "mongo/util/assert_util.h"
+#include "mongo/util/buffer_pool.h"
 
 namespace mongo {
 /* Accessing unaligned doubles on ARM generates an alignment trap and aborts with SIGBUS on Linux.
@@ -87,6 +88,35 @@ public:
     }
 };
 
+/**
+ * Allocates from the calling thread's BufferPool, so that the buffers of short-lived builders are
+ * reused instead of being malloc'ed and freed each time. Buffers remain valid to free().
+ */
+class PooledAllocator {
+public:
+    // The block size is passed through a local so that the address of the builder holding this
+    // allocator does not escape, which would keep its members from being held in registers.
+    void* Malloc(size_t sz) {
+        size_t blockSize;
+        void* p = BufferPool::allocate(sz, &blockSize);
+        _blockSize = blockSize;
+        return p;
+    }
+    void* Realloc(void* p, size_t sz) {
+        size_t blockSize = _blockSize;
+        p = BufferPool::reallocate(p, sz, &blockSize);
+        _blockSize = blockSize;
+        return p;
+    }
+    void Free(void* p) {
+        BufferPool::release(p, _blockSize);
+        _blockSize = 0;
+    }
+
+private:
+    size_t _blockSize = 0;
+};
+
 class StackAllocator {
 public:
     enum { SZ = 512 };
@@ -181,6 +211,7 @@ public:
     /* assume ownership of the buffer - you must then free() it */
     void decouple() {
         data = 0;
+        al = Allocator();  // forget the block handed off
     }
 
     void appendUChar(unsigned char j) {
@@ -318,7 +349,7 @@ private:
     friend class StringBuilderImpl<Allocator>;
 };
 
-typedef _BufBuilder<TrivialAllocator> BufBuilder;
+typedef _BufBuilder<PooledAllocator> BufBuilder;
 
 /** The StackBufBuilder builds smaller datasets on the stack instead of using malloc.
       this can be significantly faster for small bufs.  However, you can not decouple() the
@@ -40,6 +40,8 @@
 #include "mongo/client/syncclusterconnection.h"
 #include "mongo/util/exit.h"
 #include "mongo/util/log.h"
+#include "mongo/util/scopeguard.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
@@ -171,6 +173,45 @@ void PoolForHost::initializeHostName(const std::string& hostName) {
     }
 }
 
+void PoolForHost::recordCheckoutWait(uint64_t micros) {
+    _recordLatency(micros, _checkoutWaitBuckets);
+}
+
+void PoolForHost::recordConnect(uint64_t micros, bool succeeded) {
+    _recordLatency(micros, _connectTimeBuckets);
+    if (!succeeded)
+        _connectFailures++;
+}
+
+void PoolForHost::appendLatencies(BSONObjBuilder* builder) const {
+    BSONObjBuilder checkoutWaitBuilder(builder->subobjStart("checkoutWaitMs"));
+    _appendLatencies(_checkoutWaitBuckets, &checkoutWaitBuilder);
+    checkoutWaitBuilder.doneFast();
+
+    BSONObjBuilder connectTimeBuilder(builder->subobjStart("connectTimeMs"));
+    _appendLatencies(_connectTimeBuckets, &connectTimeBuilder);
+    connectTimeBuilder.doneFast();
+}
+
+void PoolForHost::_recordLatency(uint64_t micros, long long* buckets) {
+    unsigned bucket = 0;
+    for (uint64_t upperBoundMicros = 1000;
+         micros >= upperBoundMicros && bucket < NumLatencyBuckets - 1;
+         upperBoundMicros *= 2) {
+        bucket++;
+    }
+    buckets[bucket]++;
+}
+
+void PoolForHost::_appendLatencies(const long long* buckets, BSONObjBuilder* builder) {
+    for (unsigned i = 0; i < NumLatencyBuckets - 1; i++) {
+        const std::string bucketName = str::stream() << "<" << (1 << i);
+        builder->appendNumber(bucketName, buckets[i]);
+    }
+    const std::string lastBucketName = str::stream() << ">=" << (1 << (NumLatencyBuckets - 2));
+    builder->appendNumber(lastBucketName, buckets[NumLatencyBuckets - 1]);
+}
+
 // ------ DBConnectionPool ------
 
 const int PoolForHost::kPoolSizeUnlimited(-1);
@@ -178,28 +219,64 @@ const int PoolForHost::kPoolSizeUnlimited(-1);
 DBConnectionPool::DBConnectionPool()
     : _name("dbconnectionpool"),
       _maxPoolSize(PoolForHost::kPoolSizeUnlimited),
+      _minIdlePoolSize(0),
+      _maxConnectingPerHost(0),
       _hooks(new list<DBConnectionHook*>()) {}
 
+DBConnectionPool::HostPool& DBConnectionPool::_getHostPool(const string& ident,
+                                                           double socketTimeout) {
+    stdx::lock_guard<stdx::mutex> L(_mutex);
+    return _pools[PoolKey(ident, socketTimeout)];
+}
+
 DBClientBase* DBConnectionPool::_get(const string& ident, double socketTimeout) {
     uassert(17382, "Can't use connection pool during shutdown", !inShutdown());
-    stdx::lock_guard<stdx::mutex> L(_mutex);
-    PoolForHost& p = _pools[PoolKey(ident, socketTimeout)];
+    HostPool& hostPool = _getHostPool(ident, socketTimeout);
+    Timer waitTimer;
+
+    stdx::unique_lock<stdx::mutex> lk(hostPool.mutex);
+    PoolForHost& p = hostPool.pool;
     p.setMaxPoolSize(_maxPoolSize);
     p.initializeHostName(ident);
-    return p.get(this, socketTimeout);
+
+    while (true) {
+        DBClientBase* c = p.get(this, socketTimeout);
+        if (c || _maxConnectingPerHost <= 0 || hostPool.connecting < _maxConnectingPerHost) {
+            if (!c)
+                hostPool.connecting++;
+            p.recordCheckoutWait(waitTimer.micros());
+            return c;
+        }
+
+        hostPool.stateChanged.wait(lk);
+    }
+}
+
+DBClientBase* DBConnectionPool::_connect(const string& ident,
+                                         double socketTimeout,
+                                         const stdx::function<DBClientBase*()>& connectFn) {
+    HostPool& hostPool = _getHostPool(ident, socketTimeout);
+    Timer connectTimer;
+    DBClientBase* conn = NULL;
+
+    ON_BLOCK_EXIT([&] {
+        {
+            stdx::lock_guard<stdx::mutex> lk(hostPool.mutex);
+            hostPool.connecting--;
+            hostPool.pool.recordConnect(connectTimer.micros(), conn != NULL);
+            if (conn)
+                hostPool.pool.createdOne(conn);
+        }
+        hostPool.stateChanged.notify_one();
+    });
+
+    conn = connectFn();
+    return conn;
 }
 
 DBClientBase* DBConnectionPool::_finishCreate(const string& host,
                                               double socketTimeout,
                                               DBClientBase* conn) {
-    {
-        stdx::lock_guard<stdx::mutex> L(_mutex);
-        PoolForHost& p = _pools[PoolKey(host, socketTimeout)];
-        p.setMaxPoolSize(_maxPoolSize);
-        p.initializeHostName(host);
-        p.createdOne(conn);
-    }
-
     try {
         onCreate(conn);
         onHandedOut(conn);
@@ -224,7 +301,9 @@ DBClientBase* DBConnectionPool::get(const ConnectionString& url, double socketTi
     }
 
     string errmsg;
-    c = url.connect(errmsg, socketTimeout);
+    c = _connect(url.toString(),
+                 socketTimeout,
+                 [&url, &errmsg, socketTimeout] { return url.connect(errmsg, socketTimeout); });
     uassert(13328, _name + ": connect failed " + url.toString() + " : " + errmsg, c);
 
     return _finishCreate(url.toString(), socketTimeout, c);
@@ -242,10 +321,13 @@ DBClientBase* DBConnectionPool::get(const string& host, double socketTimeout) {
         return c;
     }
 
-    const ConnectionString cs(uassertStatusOK(ConnectionString::parse(host)));
-
     string errmsg;
-    c = cs.connect(errmsg, socketTimeout);
+    c = _connect(host,
+                 socketTimeout,
+                 [&host, &errmsg, socketTimeout] {
+                     const ConnectionString cs(uassertStatusOK(ConnectionString::parse(host)));
+                     return cs.connect(errmsg, socketTimeout);
+                 });
     if (!c)
         throw SocketException(SocketException::CONNECT_ERROR,
                               host,
@@ -267,8 +349,12 @@ void DBConnectionPool::onRelease(DBClientBase* conn) {
 void DBConnectionPool::release(const string& host, DBClientBase* c) {
     onRelease(c);
 
-    stdx::lock_guard<stdx::mutex> L(_mutex);
-    _pools[PoolKey(host, c->getSoTimeout())].done(this, c);
+    HostPool& hostPool = _getHostPool(host, c->getSoTimeout());
+    {
+        stdx::lock_guard<stdx::mutex> lk(hostPool.mutex);
+        hostPool.pool.done(this, c);
+    }
+    hostPool.stateChanged.notify_one();
 }
 
 
@@ -279,8 +365,8 @@ DBConnectionPool::~DBConnectionPool() {
 void DBConnectionPool::flush() {
     stdx::lock_guard<stdx::mutex> L(_mutex);
     for (PoolMap::iterator i = _pools.begin(); i != _pools.end(); i++) {
-        PoolForHost& p = i->second;
-        p.flush();
+        stdx::lock_guard<stdx::mutex> lk(i->second.mutex);
+        i->second.pool.flush();
     }
 }
 
@@ -288,7 +374,8 @@ void DBConnectionPool::clear() {
     stdx::lock_guard<stdx::mutex> L(_mutex);
     LOG(2) << "Removing connections on all pools owned by " << _name << endl;
     for (PoolMap::iterator iter = _pools.begin(); iter != _pools.end(); ++iter) {
-        iter->second.clear();
+        stdx::lock_guard<stdx::mutex> lk(iter->second.mutex);
+        iter->second.pool.clear();
     }
 }
 
@@ -299,7 +386,8 @@ void DBConnectionPool::removeHost(const string& host) {
         const string& poolHost = i->first.ident;
         if (!serverNameCompare()(host, poolHost) && !serverNameCompare()(poolHost, host)) {
             // hosts are the same
-            i->second.clear();
+            stdx::lock_guard<stdx::mutex> lk(i->second.mutex);
+            i->second.pool.clear();
         }
     }
 }
@@ -346,21 +434,28 @@ void DBConnectionPool::appendInfo(BSONObjBuilder& b) {
     {
         stdx::lock_guard<stdx::mutex> lk(_mutex);
         for (PoolMap::iterator i = _pools.begin(); i != _pools.end(); ++i) {
-            if (i->second.numCreated() == 0)
+            stdx::lock_guard<stdx::mutex> hostLk(i->second.mutex);
+            const PoolForHost& p = i->second.pool;
+            if (p.numCreated() == 0 && p.numConnectFailures() == 0)
                 continue;
 
             string s = str::stream() << i->first.ident << "::" << i->first.timeout;
 
             BSONObjBuilder temp(bb.subobjStart(s));
-            temp.append("available", i->second.numAvailable());
-            temp.appendNumber("created", i->second.numCreated());
+            temp.append("available", p.numAvailable());
+            temp.appendNumber("created", p.numCreated());
+            temp.append("connecting", i->second.connecting);
+            temp.appendNumber("connectFailures", p.numConnectFailures());
+            p.appendLatencies(&temp);
             temp.done();
 
-            avail += i->second.numAvailable();
-            created += i->second.numCreated();
+            avail += p.numAvailable();
+            created += p.numCreated();
 
-            long long& x = createdByType[i->second.type()];
-            x += i->second.numCreated();
+            if (p.numCreated() > 0) {
+                long long& x = createdByType[p.type()];
+                x += p.numCreated();
+            }
         }
     }
     bb.done();
@@ -430,9 +525,9 @@ bool DBConnectionPool::isConnectionGood(const string& hostName, DBClientBase* co
     }
 
     {
-        stdx::lock_guard<stdx::mutex> sl(_mutex);
-        PoolForHost& pool = _pools[PoolKey(hostName, conn->getSoTimeout())];
-        if (pool.isBadSocketCreationTime(conn->getSockCreationMicroSec())) {
+        HostPool& hostPool = _getHostPool(hostName, conn->getSoTimeout());
+        stdx::lock_guard<stdx::mutex> sl(hostPool.mutex);
+        if (hostPool.pool.isBadSocketCreationTime(conn->getSockCreationMicroSec())) {
             return false;
         }
     }
@@ -448,7 +543,8 @@ void DBConnectionPool::taskDoWork() {
         // but we can actually delete them outside
         stdx::lock_guard<stdx::mutex> lk(_mutex);
         for (PoolMap::iterator i = _pools.begin(); i != _pools.end(); ++i) {
-            i->second.getStaleConnections(toDelete);
+            stdx::lock_guard<stdx::mutex> hostLk(i->second.mutex);
+            i->second.pool.getStaleConnections(toDelete);
         }
     }
 
@@ -460,6 +556,83 @@ void DBConnectionPool::taskDoWork() {
             // we don't care if there was a socket error
         }
     }
+
+    if (_minIdlePoolSize > 0) {
+        _warmUp();
+    }
+}
+
+void DBConnectionPool::_warmUp() {
+    // Only hosts we already connected to are warmed up, their pools being created on first use
+    vector<std::pair<PoolKey, HostPool*>> hostPools;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        for (PoolMap::iterator i = _pools.begin(); i != _pools.end(); ++i) {
+            hostPools.push_back(std::make_pair(i->first, &i->second));
+        }
+    }
+
+    for (size_t i = 0; i < hostPools.size() && !inShutdown(); i++) {
+        const PoolKey& key = hostPools[i].first;
+        HostPool& hostPool = *hostPools[i].second;
+
+        int toCreate;
+        {
+            stdx::lock_guard<stdx::mutex> lk(hostPool.mutex);
+            if (hostPool.pool.numCreated() == 0)
+                continue;
+
+            toCreate = _minIdlePoolSize - hostPool.pool.numAvailable() - hostPool.connecting;
+            if (_maxConnectingPerHost > 0 &&
+                toCreate > _maxConnectingPerHost - hostPool.connecting)
+                toCreate = _maxConnectingPerHost - hostPool.connecting;
+            if (toCreate <= 0)
+                continue;
+
+            hostPool.connecting += toCreate;
+        }
+
+        LOG(2) << _name << " opening " << toCreate << " idle connections to " << key.ident;
+
+        for (int created = 0; created < toCreate; created++) {
+            DBClientBase* conn = NULL;
+            string errmsg;
+            try {
+                conn = _connect(key.ident,
+                                key.timeout,
+                                [&key, &errmsg] {
+                                    const ConnectionString cs(
+                                        uassertStatusOK(ConnectionString::parse(key.ident)));
+                                    return cs.connect(errmsg, key.timeout);
+                                });
+                if (conn)
+                    onCreate(conn);
+            } catch (const std::exception& ex) {
+                errmsg = ex.what();
+                delete conn;
+                conn = NULL;
+            }
+
+            if (!conn) {
+                LOG(1) << _name << " failed to open an idle connection to " << key.ident
+                       << causedBy(errmsg);
+
+                // Give back the slots reserved for the connections we won't try to open
+                {
+                    stdx::lock_guard<stdx::mutex> lk(hostPool.mutex);
+                    hostPool.connecting -= toCreate - created - 1;
+                }
+                hostPool.stateChanged.notify_all();
+                break;
+            }
+
+            {
+                stdx::lock_guard<stdx::mutex> lk(hostPool.mutex);
+                hostPool.pool.done(this, conn);
+            }
+            hostPool.stateChanged.notify_one();
+        }
+    }
 }
 
 // ------ ScopedDbConnection ------
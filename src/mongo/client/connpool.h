@@ -30,10 +30,13 @@
 #pragma once
 
 #include <cstdint>
+#include <cstring>
 #include <stack>
 
 #include "mongo/client/dbclientinterface.h"
 #include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/functional.h"
 #include "mongo/util/background.h"
 #include "mongo/util/concurrency/mutex.h"
 
@@ -54,15 +57,22 @@ public:
         : _created(0),
           _minValidCreationTimeMicroSec(0),
           _type(ConnectionString::INVALID),
-          _maxPoolSize(kPoolSizeUnlimited) {}
+          _maxPoolSize(kPoolSizeUnlimited),
+          _connectFailures(0) {
+        memset(_checkoutWaitBuckets, 0, sizeof(_checkoutWaitBuckets));
+        memset(_connectTimeBuckets, 0, sizeof(_connectTimeBuckets));
+    }
 
     PoolForHost(const PoolForHost& other)
         : _created(other._created),
           _minValidCreationTimeMicroSec(other._minValidCreationTimeMicroSec),
           _type(other._type),
-          _maxPoolSize(other._maxPoolSize) {
+          _maxPoolSize(other._maxPoolSize),
+          _connectFailures(other._connectFailures) {
         verify(_created == 0);
         verify(other._pool.size() == 0);
+        memcpy(_checkoutWaitBuckets, other._checkoutWaitBuckets, sizeof(_checkoutWaitBuckets));
+        memcpy(_connectTimeBuckets, other._connectTimeBuckets, sizeof(_connectTimeBuckets));
     }
 
     ~PoolForHost();
@@ -126,7 +136,32 @@ public:
      */
     void initializeHostName(const std::string& hostName);
 
+    /**
+     * Records how long a caller waited to be handed a connection or a slot to open one.
+     */
+    void recordCheckoutWait(uint64_t micros);
+
+    /**
+     * Records how long opening a new connection took, successful or not.
+     */
+    void recordConnect(uint64_t micros, bool succeeded);
+
+    long long numConnectFailures() const {
+        return _connectFailures;
+    }
+
+    /**
+     * Appends the checkout wait and connect time histograms, in milliseconds.
+     */
+    void appendLatencies(BSONObjBuilder* builder) const;
+
 private:
+    // Latency buckets hold counts of [0, 1), [1, 2), [2, 4) ... [512, 1024) and >= 1024 millis
+    enum { NumLatencyBuckets = 12 };
+
+    static void _recordLatency(uint64_t micros, long long* buckets);
+    static void _appendLatencies(const long long* buckets, BSONObjBuilder* builder);
+
     struct StoredConnection {
         StoredConnection(DBClientBase* c);
 
@@ -145,6 +180,10 @@ private:
 
     // The maximum number of connections we'll save in the pool
     int _maxPoolSize;
+
+    long long _connectFailures;
+    long long _checkoutWaitBuckets[NumLatencyBuckets];
+    long long _connectTimeBuckets[NumLatencyBuckets];
 };
 
 class DBConnectionHook {
@@ -201,6 +240,38 @@ public:
         _maxPoolSize = maxPoolSize;
     }
 
+    /**
+     * Returns the number of idle connections the cleaner task keeps open to each host
+     */
+    int getMinIdlePoolSize() {
+        return _minIdlePoolSize;
+    }
+
+    /**
+     * Sets the number of idle connections to keep open to each host the pool has connected to.
+     * Missing connections are opened in the background by the cleaner task, so that a burst of
+     * requests after the pool was drained does not have to connect first. 0 disables warmup.
+     */
+    void setMinIdlePoolSize(int minIdlePoolSize) {
+        _minIdlePoolSize = minIdlePoolSize;
+    }
+
+    /**
+     * Returns the maximum number of connections opened concurrently to one host
+     */
+    int getMaxConnectingPerHost() {
+        return _maxConnectingPerHost;
+    }
+
+    /**
+     * Sets the maximum number of connections opened concurrently to one host. Callers beyond the
+     * limit wait for a connection to be released or for a connect to finish, rather than all
+     * connecting at once to a host which just came back. 0 means no limit.
+     */
+    void setMaxConnectingPerHost(int maxConnectingPerHost) {
+        _maxConnectingPerHost = maxConnectingPerHost;
+    }
+
     void onCreate(DBClientBase* conn);
     void onHandedOut(DBClientBase* conn);
     void onDestroy(DBClientBase* conn);
@@ -248,10 +319,6 @@ public:
 private:
     DBConnectionPool(DBConnectionPool& p);
 
-    DBClientBase* _get(const std::string& ident, double socketTimeout);
-
-    DBClientBase* _finishCreate(const std::string& ident, double socketTimeout, DBClientBase* conn);
-
     struct PoolKey {
         PoolKey(const std::string& i, double t) : ident(i), timeout(t) {}
         std::string ident;
@@ -262,7 +329,50 @@ private:
         bool operator()(const PoolKey& a, const PoolKey& b) const;
     };
 
-    typedef std::map<PoolKey, PoolForHost, poolKeyCompare> PoolMap;  // servername -> pool
+    /**
+     * The pool for one host, with its own lock so that checkouts from different hosts do not
+     * contend. Host pools are never removed from the map, so references to them stay valid.
+     */
+    struct HostPool {
+        stdx::mutex mutex;
+
+        // Signalled when a connection is returned to 'pool' or a connect to the host finishes
+        stdx::condition_variable stateChanged;
+
+        // Number of connections being opened to the host
+        int connecting = 0;
+
+        PoolForHost pool;
+    };
+
+    typedef std::map<PoolKey, HostPool, poolKeyCompare> PoolMap;  // servername -> pool
+
+    /**
+     * Returns the pool for the given host, creating it if needed. Takes _mutex, so callers must
+     * not hold any host pool lock.
+     */
+    HostPool& _getHostPool(const std::string& ident, double socketTimeout);
+
+    /**
+     * Returns a pooled connection, or NULL after reserving a slot to open a new one, in which
+     * case the caller must open it through _connect.
+     */
+    DBClientBase* _get(const std::string& ident, double socketTimeout);
+
+    /**
+     * Runs 'connectFn' in the slot reserved by _get and records its outcome. Returns the new
+     * connection, or NULL if 'connectFn' failed.
+     */
+    DBClientBase* _connect(const std::string& ident,
+                           double socketTimeout,
+                           const stdx::function<DBClientBase*()>& connectFn);
+
+    DBClientBase* _finishCreate(const std::string& ident, double socketTimeout, DBClientBase* conn);
+
+    /**
+     * Opens connections to the hosts whose pools hold fewer than _minIdlePoolSize of them.
+     */
+    void _warmUp();
 
     stdx::mutex _mutex;
     std::string _name;
@@ -272,6 +382,14 @@ private:
     // 0 effectively disables the pool
     int _maxPoolSize;
 
+    // The number of idle connections the cleaner task keeps open per-host, 0 disables warmup
+    int _minIdlePoolSize;
+
+    // The maximum number of connections being opened at once per-host, 0 means no limit
+    int _maxConnectingPerHost;
+
+    // Guarded by _mutex, while the contents of each HostPool are guarded by its own mutex. When
+    // both are needed, _mutex is always taken first.
     PoolMap _pools;
 
     // pointers owned by me, right now they leak on shutdown
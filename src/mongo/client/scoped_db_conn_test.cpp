@@ -253,6 +253,8 @@ public:
         delete _dummyServer;
 
         globalConnPool.setMaxPoolSize(_maxPoolSizePerHost);
+        globalConnPool.setMinIdlePoolSize(0);
+        globalConnPool.setMaxConnectingPerHost(0);
     }
 
 protected:
@@ -264,6 +266,28 @@ protected:
         ASSERT_NOT_EQUALS(a, b);
     }
 
+    /**
+     * Returns the connPoolStats entry of the dummy server, which is empty until the pool
+     * connects to it. Pools are never removed, so the counters carry over between tests.
+     */
+    static BSONObj getHostStats() {
+        BSONObjBuilder builder;
+        globalConnPool.appendInfo(builder);
+        const BSONObj info = builder.obj();
+        return info.getObjectField("hosts").getObjectField(TARGET_HOST + "::0").getOwned();
+    }
+
+    /**
+     * Returns the number of latencies counted by all the buckets of a histogram.
+     */
+    static long long countLatencies(const BSONObj& hostStats, const char* histogramName) {
+        long long count = 0;
+        BSONForEach(bucket, hostStats.getObjectField(histogramName)) {
+            count += bucket.numberLong();
+        }
+        return count;
+    }
+
     /**
      * Tries to grab a series of connections from the pool, perform checks on
      * them, then put them back into the globalConnPool. After that, it checks these
@@ -432,5 +456,79 @@ TEST_F(DummyServerFixture, DontReturnConnGoneBadToPool) {
     conn1Again.done();
 }
 
+TEST_F(DummyServerFixture, HostStatsCountConnectsAndCheckouts) {
+    const BSONObj before = getHostStats();
+
+    ScopedDbConnection conn1(TARGET_HOST);
+    ScopedDbConnection conn2(TARGET_HOST);
+    conn1.done();
+    ScopedDbConnection conn3(TARGET_HOST);
+    conn2.done();
+    conn3.done();
+
+    const BSONObj after = getHostStats();
+    ASSERT_EQUALS(2, after["created"].numberLong() - before["created"].numberLong());
+    ASSERT_EQUALS(0, after["connecting"].numberInt());
+    ASSERT_EQUALS(before["connectFailures"].numberLong(), after["connectFailures"].numberLong());
+    ASSERT_EQUALS(2,
+                  countLatencies(after, "connectTimeMs") - countLatencies(before, "connectTimeMs"));
+    ASSERT_EQUALS(3,
+                  countLatencies(after, "checkoutWaitMs") -
+                      countLatencies(before, "checkoutWaitMs"));
+}
+
+TEST_F(DummyServerFixture, WarmUpOpensMinIdleConnections) {
+    globalConnPool.setMinIdlePoolSize(3);
+
+    const long long createdBefore = getHostStats()["created"].numberLong();
+
+    ScopedDbConnection conn1(TARGET_HOST);
+    conn1.done();
+
+    globalConnPool.taskDoWork();
+
+    BSONObj stats = getHostStats();
+    ASSERT_EQUALS(3, stats["available"].numberInt());
+    ASSERT_EQUALS(3, stats["created"].numberLong() - createdBefore);
+
+    // The warm connections are handed out without connecting again
+    ScopedDbConnection conn2(TARGET_HOST);
+    ScopedDbConnection conn3(TARGET_HOST);
+    ScopedDbConnection conn4(TARGET_HOST);
+    ASSERT_EQUALS(3, getHostStats()["created"].numberLong() - createdBefore);
+
+    conn2.done();
+    conn3.done();
+    conn4.done();
+
+    // Warmup is a no-op once the pool holds enough idle connections
+    globalConnPool.taskDoWork();
+    ASSERT_EQUALS(3, getHostStats()["created"].numberLong() - createdBefore);
+}
+
+TEST_F(DummyServerFixture, MaxConnectingPerHostQueuesCheckouts) {
+    globalConnPool.setMaxConnectingPerHost(1);
+
+    const long long checkoutsBefore = countLatencies(getHostStats(), "checkoutWaitMs");
+
+    const int numThreads = 8;
+    vector<stdx::thread> threads;
+    for (int i = 0; i < numThreads; i++) {
+        threads.emplace_back([] {
+            for (int j = 0; j < 10; j++) {
+                ScopedDbConnection conn(TARGET_HOST);
+                conn.done();
+            }
+        });
+    }
+    for (size_t i = 0; i < threads.size(); i++) {
+        threads[i].join();
+    }
+
+    const BSONObj stats = getHostStats();
+    ASSERT_EQUALS(0, stats["connecting"].numberInt());
+    ASSERT_EQUALS(numThreads * 10, countLatencies(stats, "checkoutWaitMs") - checkoutsBefore);
+}
+
 }  // namespace
 }  // namespace mongo
@@ -44,6 +44,7 @@
 #include "mongo/db/clientcursor.h"
 #include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/curop.h"
+#include "mongo/db/field_ref_set.h"
 #include "mongo/db/index/index_access_method.h"
 #include "mongo/db/keypattern.h"
 #include "mongo/db/matcher/expression_parser.h"
@@ -452,12 +453,34 @@ void Collection::deleteDocument(
 Counter64 moveCounter;
 ServerStatusMetricField<Counter64> moveCounterDisplay("record.moves", &moveCounter);
 
+namespace {
+
+/**
+ * Returns true if changing any of 'updatedFields' could change the keys generated by an index
+ * over 'indexedPaths'. NULL for either means that nothing is known, so the index is affected.
+ */
+bool updateAffectsIndex(const UpdateIndexData* indexedPaths, const FieldRefSet* updatedFields) {
+    if (!indexedPaths || !updatedFields) {
+        return true;
+    }
+    for (FieldRefSet::const_iterator it = updatedFields->begin(); it != updatedFields->end();
+         ++it) {
+        if (indexedPaths->mightBeIndexed((*it)->dottedField())) {
+            return true;
+        }
+    }
+    return false;
+}
+
+}  // namespace
+
 StatusWith<RecordId> Collection::updateDocument(OperationContext* txn,
                                                 const RecordId& oldLocation,
                                                 const Snapshotted<BSONObj>& oldDoc,
                                                 const BSONObj& newDoc,
                                                 bool enforceQuota,
                                                 bool indexesAffected,
+                                                const FieldRefSet* updatedFields,
                                                 OpDebug* debug,
                                                 oplogUpdateEntryArgs& args) {
     {
@@ -488,12 +511,16 @@ StatusWith<RecordId> Collection::updateDocument(OperationContext* txn,
 
     // At the end of this step, we will have a map of UpdateTickets, one per index, which
     // represent the index updates needed to be done, based on the changes between oldDoc and
-    // newDoc.
+    // newDoc. Indexes over none of the updated fields get no ticket, as their keys can't change.
     OwnedPointerMap<IndexDescriptor*, UpdateTicket> updateTickets;
     if (indexesAffected) {
         IndexCatalog::IndexIterator ii = _indexCatalog.getIndexIterator(txn, true);
         while (ii.more()) {
             IndexDescriptor* descriptor = ii.next();
+            if (!updateAffectsIndex(_infoCache.indexKeys(txn, descriptor->indexName()),
+                                    updatedFields)) {
+                continue;
+            }
             IndexCatalogEntry* entry = ii.catalogEntry(descriptor);
             IndexAccessMethod* iam = ii.accessMethod(descriptor);
 
@@ -555,10 +582,14 @@ StatusWith<RecordId> Collection::updateDocument(OperationContext* txn,
         IndexCatalog::IndexIterator ii = _indexCatalog.getIndexIterator(txn, true);
         while (ii.more()) {
             IndexDescriptor* descriptor = ii.next();
+            auto ticket = updateTickets.map().find(descriptor);
+            if (ticket == updateTickets.map().end()) {
+                continue;
+            }
             IndexAccessMethod* iam = ii.accessMethod(descriptor);
 
             int64_t updatedKeys;
-            Status ret = iam->update(txn, *updateTickets.mutableMap()[descriptor], &updatedKeys);
+            Status ret = iam->update(txn, *ticket->second, &updatedKeys);
             if (!ret.isOK())
                 return StatusWith<RecordId>(ret);
             if (debug)
@@ -597,12 +628,13 @@ bool Collection::updateWithDamagesSupported() const {
     return _recordStore->updateWithDamagesSupported();
 }
 
-Status Collection::updateDocumentWithDamages(OperationContext* txn,
-                                             const RecordId& loc,
-                                             const Snapshotted<RecordData>& oldRec,
-                                             const char* damageSource,
-                                             const mutablebson::DamageVector& damages,
-                                             oplogUpdateEntryArgs& args) {
+StatusWith<RecordData> Collection::updateDocumentWithDamages(
+    OperationContext* txn,
+    const RecordId& loc,
+    const Snapshotted<RecordData>& oldRec,
+    const char* damageSource,
+    const mutablebson::DamageVector& damages,
+    oplogUpdateEntryArgs& args) {
     dassert(txn->lockState()->isCollectionLockedForMode(ns().toString(), MODE_IX));
     invariant(oldRec.snapshotId() == txn->recoveryUnit()->getSnapshotId());
     invariant(updateWithDamagesSupported());
@@ -610,14 +642,14 @@ Status Collection::updateDocumentWithDamages(OperationContext* txn,
     // Broadcast the mutation so that query results stay correct.
     _cursorManager.invalidateDocument(txn, loc, INVALIDATION_MUTATION);
 
-    Status status =
+    StatusWith<RecordData> newRec =
         _recordStore->updateWithDamages(txn, loc, oldRec.value(), damageSource, damages);
 
-    if (status.isOK()) {
+    if (newRec.isOK()) {
         args.ns = ns().ns();
         getGlobalServiceContext()->getOpObserver()->onUpdate(txn, args);
     }
-    return status;
+    return newRec;
 }
 
 bool Collection::_enforceQuota(bool userEnforeQuota) const {
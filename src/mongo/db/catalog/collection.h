@@ -56,6 +56,7 @@ namespace mongo {
 class CollectionCatalogEntry;
 class DatabaseCatalogEntry;
 class ExtentManager;
+class FieldRefSet;
 class IndexCatalog;
 class MatchExpression;
 class MultiIndexBlock;
@@ -245,6 +246,8 @@ public:
      * updates the document @ oldLocation with newDoc
      * if the document fits in the old space, it is put there
      * if not, it is moved
+     * if 'indexesAffected' is set and 'updatedFields' is non-NULL, only the indexes over one of
+     * the updated fields are maintained; otherwise every index is
      * @return the post update location of the doc (may or may not be the same as oldLocation)
      */
     StatusWith<RecordId> updateDocument(OperationContext* txn,
@@ -253,6 +256,7 @@ public:
                                         const BSONObj& newDoc,
                                         bool enforceQuota,
                                         bool indexesAffected,
+                                        const FieldRefSet* updatedFields,
                                         OpDebug* debug,
                                         oplogUpdateEntryArgs& args);
 
@@ -261,13 +265,14 @@ public:
     /**
      * Not allowed to modify indexes.
      * Illegal to call if updateWithDamagesSupported() returns false.
+     * @return the contents of the updated document
      */
-    Status updateDocumentWithDamages(OperationContext* txn,
-                                     const RecordId& loc,
-                                     const Snapshotted<RecordData>& oldRec,
-                                     const char* damageSource,
-                                     const mutablebson::DamageVector& damages,
-                                     oplogUpdateEntryArgs& args);
+    StatusWith<RecordData> updateDocumentWithDamages(OperationContext* txn,
+                                                     const RecordId& loc,
+                                                     const Snapshotted<RecordData>& oldRec,
+                                                     const char* damageSource,
+                                                     const mutablebson::DamageVector& damages,
+                                                     oplogUpdateEntryArgs& args);
 
     // -----------
 
@@ -30,6 +30,8 @@
 
 #pragma once
 
+#include <map>
+#include <string>
 
 #include "mongo/db/query/plan_cache.h"
 #include "mongo/db/query/query_settings.h"
@@ -73,6 +75,13 @@ public:
     */
     const UpdateIndexData& indexKeys(OperationContext* txn) const;
 
+    /**
+     * Get the set of paths that the index named 'indexName' generates keys from, or NULL if no
+     * such index was known when the cache was last reset. Updates which only touch fields that
+     * are not indexed by an index need not maintain that index.
+     */
+    const UpdateIndexData* indexKeys(OperationContext* txn, StringData indexName) const;
+
     // ---------------------
 
     /**
@@ -90,6 +99,7 @@ private:
     // ---  index keys cache
     bool _keysComputed;
     UpdateIndexData _indexedPaths;
+    std::map<std::string, UpdateIndexData> _indexedPathsByIndex;
 
     // A cache for query plans.
     std::unique_ptr<PlanCache> _planCache;
@@ -56,6 +56,7 @@
 #include "mongo/db/query/query_planner.h"
 #include "mongo/db/range_preserver.h"
 #include "mongo/db/repl/replication_coordinator_global.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/s/collection_metadata.h"
 #include "mongo/db/s/sharded_connection_info.h"
 #include "mongo/db/s/sharding_state.h"
@@ -83,6 +84,13 @@ using std::vector;
 
 namespace mr {
 
+// Run map and reduce functions recognized by parseNativeMapFunction() and
+// parseNativeReduceFunction() without the JS engine.
+MONGO_EXPORT_SERVER_PARAMETER(internalMapReduceUseNativeFunctions, bool, true);
+
+// Mappers that support batches are handed at most this many bytes of documents at a time.
+const int kMaxMapBatchBytes = 4 * 1024 * 1024;
+
 AtomicUInt32 Config::JOB_NUMBER;
 
 JSFunction::JSFunction(const std::string& type, const BSONElement& e) {
@@ -120,6 +128,16 @@ void JSMapper::map(const BSONObj& o) {
         uasserted(9014, str::stream() << "map invoke failed: " << s->getError());
 }
 
+/**
+ * Applies the map function to each object, with a single call into the JS engine
+ */
+void JSMapper::mapBatch(const BSONList& docs) {
+    Scope* s = _func.scope();
+    verify(s);
+    if (s->invokeBatch(_func.func(), &_params, docs, NULL))
+        uasserted(28772, str::stream() << "map invoke failed: " << s->getError());
+}
+
 /**
  * Applies the finalize function to a tuple obj (key, val)
  * Returns tuple obj {_id: key, value: newval}
@@ -192,6 +210,146 @@ BSONObj JSReducer::finalReduce(const BSONList& tuples, Finalizer* finalizer) {
     return res;
 }
 
+void NativeMapper::init(State* state) {
+    _jsMapper.init(state);
+    _state = state;
+}
+
+namespace {
+
+/**
+ * Returns the field at "path" of "o", or EOO if any field on the path is missing or any but the
+ * last is not an object.
+ */
+BSONElement getNativePathElement(const BSONObj& o, const std::string& path) {
+    BSONObj obj = o;
+    size_t start = 0;
+    while (true) {
+        size_t dot = path.find('.', start);
+        BSONElement e = obj[StringData(path).substr(start, dot - start)];
+        if (dot == std::string::npos)
+            return e;
+        if (e.type() != Object)
+            return BSONElement();
+        obj = e.embeddedObject();
+        start = dot + 1;
+    }
+}
+
+}  // namespace
+
+/**
+ * Emits natively when the key and value of "o" come out of the JS engine unchanged, except for
+ * NumberInts, which JS emits as doubles.
+ */
+void NativeMapper::map(const BSONObj& o) {
+    BSONElement key = getNativePathElement(o, _function.keyPath);
+    switch (key.type()) {
+        case NumberDouble:
+        case NumberInt:
+        case String:
+        case jstOID:
+        case Bool:
+        case Date:
+        case jstNULL:
+            break;
+        default:
+            ++_numJSMaps;
+            _jsMapper.map(o);
+            return;
+    }
+
+    double value = _function.value;
+    if (!_function.valuePath.empty()) {
+        BSONElement valueElement = getNativePathElement(o, _function.valuePath);
+        if (valueElement.type() != NumberDouble && valueElement.type() != NumberInt) {
+            ++_numJSMaps;
+            _jsMapper.map(o);
+            return;
+        }
+        value = valueElement.numberDouble();
+    }
+
+    BSONObjBuilder b(key.size() + 16);
+    if (key.type() == NumberInt)
+        b.append("0", key.numberDouble());
+    else
+        b.appendAs(key, "0");
+    b.append("1", value);
+    BSONObj args = b.obj();
+
+    uassert(28770,
+            "an emit can't be more than half max bson size",
+            args.objsize() < (BSONObjMaxUserSize / 2));
+    _state->emit(args);
+}
+
+void NativeSumReducer::init(State* state) {
+    _jsReducer.init(state);
+}
+
+bool NativeSumReducer::_sum(const BSONList& tuples, double* sum) const {
+    uassert(28771, "need values", tuples.size());
+
+    double s = 0;
+    for (size_t i = 0; i < tuples.size(); ++i) {
+        BSONObjIterator it(tuples[i]);
+        it.next();
+        BSONElement value = it.next();
+        if (value.type() != NumberDouble)
+            return false;
+
+        // Add in the same order as the JS function, so the sum rounds the same way.
+        if (i == 0 && !_function.sumStartsAtZero)
+            s = value._numberDouble();
+        else
+            s += value._numberDouble();
+    }
+    *sum = s;
+    return true;
+}
+
+BSONObj NativeSumReducer::reduce(const BSONList& tuples) {
+    if (tuples.size() <= 1)
+        return tuples[0];
+
+    double sum;
+    if (!_sum(tuples, &sum)) {
+        BSONObj res = _jsReducer.reduce(tuples);
+        numReduces += _jsReducer.numReduces;
+        _jsReducer.numReduces = 0;
+        return res;
+    }
+    ++numReduces;
+
+    BSONObjBuilder b;
+    b.appendAs(tuples[0].firstElement(), "0");
+    b.append("1", sum);
+    return b.obj();
+}
+
+BSONObj NativeSumReducer::finalReduce(const BSONList& tuples, Finalizer* finalizer) {
+    double sum;
+    if (tuples.size() == 1 || !_sum(tuples, &sum)) {
+        BSONObj res = _jsReducer.finalReduce(tuples, finalizer);
+        numReduces += _jsReducer.numReduces;
+        _jsReducer.numReduces = 0;
+        return res;
+    }
+    ++numReduces;
+
+    BSONObjBuilder b;
+    b.appendAs(tuples[0].firstElement(), "_id");
+    b.append("value", sum);
+    BSONObj res = b.obj();
+
+    if (finalizer) {
+        res = finalizer->finalize(res);
+    }
+
+    return res;
+}
+
 /**
  * actually applies a reduce, to a list of tuples (key, value).
  * After the call, tuples will hold a single tuple {"0": key, "1": value}
@@ -301,8 +459,26 @@ Config::Config(const string& _dbname, const BSONObj& cmdObj) {
         if (cmdObj["scope"].type() == Object)
             scopeSetup = cmdObj["scope"].embeddedObjectUserCheck();
 
-        mapper.reset(new JSMapper(cmdObj["map"]));
-        reducer.reset(new JSReducer(cmdObj["reduce"]));
+        // Functions which refer to a scope might find anything under the names they use.
+        const bool canRunNative = internalMapReduceUseNativeFunctions && !jsMode &&
+            scopeSetup.isEmpty() && cmdObj["map"].type() != CodeWScope &&
+            cmdObj["reduce"].type() != CodeWScope;
+
+        NativeMapFunction nativeMapFunction;
+        nativeMap =
+            canRunNative && parseNativeMapFunction(cmdObj["map"]._asCode(), &nativeMapFunction);
+        if (nativeMap)
+            mapper.reset(new NativeMapper(cmdObj["map"], nativeMapFunction));
+        else
+            mapper.reset(new JSMapper(cmdObj["map"]));
+
+        NativeReduceFunction nativeReduceFunction;
+        nativeReduce = canRunNative &&
+            parseNativeReduceFunction(cmdObj["reduce"]._asCode(), &nativeReduceFunction);
+        if (nativeReduce)
+            reducer.reset(new NativeSumReducer(cmdObj["reduce"], nativeReduceFunction));
+        else
+            reducer.reset(new JSReducer(cmdObj["reduce"]));
         if (cmdObj["finalize"].type() && cmdObj["finalize"].trueValue())
             finalizer.reset(new JSFinalizer(cmdObj["finalize"]));
 
@@ -1404,6 +1580,13 @@ public:
 
                 Timer mt;
 
+                // Mappers that support it are handed batches of documents, so that the JS engine
+                // is called once per batch. Batches end where the in-memory state is checked
+                // below, every 100 documents.
+                const bool mapInBatches = config.mapper->supportsBatch();
+                BSONList batch;
+                int batchBytes = 0;
+
                 // go through each doc
                 BSONObj o;
                 while (PlanExecutor::ADVANCED == exec->getNext(&o, NULL)) {
@@ -1416,18 +1599,40 @@ public:
                         }
                     }
 
+                    numInputs++;
+                    pm.hit();
+                    const bool reachedLimit = config.limit && numInputs >= config.limit;
+
                     // do map
-                    if (config.verbose)
-                        mt.reset();
-                    config.mapper->map(o);
-                    if (config.verbose)
-                        mapTime += mt.micros();
+                    if (mapInBatches) {
+                        // the executor may yield before the batch is mapped
+                        batch.push_back(o.getOwned());
+                        batchBytes += o.objsize();
+                        if (numInputs % 100 == 0 || batchBytes >= kMaxMapBatchBytes ||
+                            reachedLimit) {
+                            if (config.verbose)
+                                mt.reset();
+                            config.mapper->mapBatch(batch);
+                            batch.clear();
+                            batchBytes = 0;
+                            if (config.verbose)
+                                mapTime += mt.micros();
+                        }
+                    } else {
+                        if (config.verbose)
+                            mt.reset();
+                        config.mapper->map(o);
+                        if (config.verbose)
+                            mapTime += mt.micros();
+                    }
+
+                    if (reachedLimit)
+                        break;
 
                     // Check if the state accumulated so far needs to be written to a
                     // collection. This may yield the DB lock temporarily and then
                     // acquire it again.
                     //
-                    numInputs++;
                     if (numInputs % 100 == 0) {
                         Timer t;
 
@@ -1461,11 +1666,14 @@ public:
 
                         txn->checkForInterrupt();
                     }
+                }
 
-                    pm.hit();
-
-                    if (config.limit && numInputs >= config.limit)
-                        break;
+                if (!batch.empty()) {
+                    if (config.verbose)
+                        mt.reset();
+                    config.mapper->mapBatch(batch);
+                    if (config.verbose)
+                        mapTime += mt.micros();
                 }
             }
             pm.finished();
@@ -1498,6 +1706,10 @@ public:
             countsBuilder.appendNumber("reduce", state.numReduces());
             timingBuilder.appendNumber("reduceTime", reduceTime / 1000);
             timingBuilder.append("mode", state.jsMode() ? "js" : "mixed");
+            if (config.nativeMap) {
+                timingBuilder.appendNumber(
+                    "jsMaps", static_cast<NativeMapper*>(config.mapper.get())->numJSMaps());
+            }
 
             long long finalCount = state.postProcessCollection(txn, op, pm);
             state.appendResults(result);
@@ -1508,6 +1720,9 @@ public:
             if (config.verbose)
                 result.append("timing", timingBuilder.obj());
             result.append("counts", countsBuilder.obj());
+            result.append("functions",
+                          BSON("map" << (config.nativeMap ? "native" : "js") << "reduce"
+                                     << (config.nativeReduce ? "native" : "js")));
 
             if (finalCount == 0 && shouldHaveData) {
                 result.append("cmd", cmd);
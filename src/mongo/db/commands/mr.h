@@ -63,6 +63,23 @@ public:
 
     virtual void map(const BSONObj& o) = 0;
 
+    /**
+     * Whether mapBatch() maps documents more cheaply than calling map() on each of them. Only
+     * then are the documents of a mapReduce collected into batches.
+     */
+    virtual bool supportsBatch() const {
+        return false;
+    }
+
+    /**
+     * Maps each of "docs", in order.
+     */
+    virtual void mapBatch(const BSONList& docs) {
+        for (const BSONObj& o : docs) {
+            map(o);
+        }
+    }
+
 protected:
     Mapper() = default;
 };
@@ -136,6 +153,10 @@ class JSMapper : public Mapper {
 public:
     JSMapper(const BSONElement& code) : _func("_map", code) {}
     virtual void map(const BSONObj& o);
+    virtual bool supportsBatch() const {
+        return true;
+    }
+    virtual void mapBatch(const BSONList& docs);
     virtual void init(State* state);
 
 private:
@@ -174,6 +195,81 @@ private:
     JSFunction _func;
 };
 
+// ------------  native function implementations -----------
+
+/**
+ * A map function of the form
+ *     function() { emit(this.<keyPath>, <value>); }
+ * where <value> is a number or this.<valuePath>.
+ */
+struct NativeMapFunction {
+    std::string keyPath;
+    std::string valuePath;  // empty if the emitted value is the constant 'value'
+    double value = 0;
+};
+
+/**
+ * A reduce function which returns the sum of its values, such as
+ *     function(key, values) { return Array.sum(values); }
+ */
+struct NativeReduceFunction {
+    // true if the function adds the values to 0 rather than to the first value
+    bool sumStartsAtZero = false;
+};
+
+/**
+ * Recognize map and reduce functions which can run without the JS engine. Return false if
+ * "code" has any other form.
+ */
+bool parseNativeMapFunction(StringData code, NativeMapFunction* out);
+bool parseNativeReduceFunction(StringData code, NativeReduceFunction* out);
+
+/**
+ * Runs a NativeMapFunction. Documents for which emitting natively might not produce exactly
+ * what the JS function emits, such as documents missing the key, are mapped by the JS function.
+ */
+class NativeMapper : public Mapper {
+public:
+    NativeMapper(const BSONElement& code, const NativeMapFunction& function)
+        : _function(function), _jsMapper(code) {}
+    virtual void map(const BSONObj& o);
+    virtual void init(State* state);
+
+    /** number of documents mapped by the JS function */
+    long long numJSMaps() const {
+        return _numJSMaps;
+    }
+
+private:
+    const NativeMapFunction _function;
+    JSMapper _jsMapper;
+    State* _state = nullptr;
+    long long _numJSMaps = 0;
+};
+
+/**
+ * Runs a NativeReduceFunction. Values are summed natively when they are all doubles, which is
+ * what JS numbers are emitted as, and by the JS function otherwise.
+ */
+class NativeSumReducer : public Reducer {
+public:
+    NativeSumReducer(const BSONElement& code, const NativeReduceFunction& function)
+        : _function(function), _jsReducer(code) {}
+    virtual void init(State* state);
+
+    virtual BSONObj reduce(const BSONList& tuples);
+    virtual BSONObj finalReduce(const BSONList& tuples, Finalizer* finalizer);
+
+private:
+    /**
+     * Sums the values of "tuples" into "sum". Returns false if any of them is not a double.
+     */
+    bool _sum(const BSONList& tuples, double* sum) const;
+
+    const NativeReduceFunction _function;
+    JSReducer _jsReducer;
+};
+
 // -----------------
 
 
@@ -214,6 +310,10 @@ public:
     std::unique_ptr<Reducer> reducer;
     std::unique_ptr<Finalizer> finalizer;
 
+    // true if the map or reduce function is a NativeMapper or NativeSumReducer
+    bool nativeMap;
+    bool nativeReduce;
+
     BSONObj mapParams;
     BSONObj scopeSetup;
 
@@ -28,6 +28,11 @@
 
 #include "mongo/db/commands/mr.h"
 
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <map>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -132,5 +137,275 @@ void addPrivilegesRequiredForMapReduce(Command* commandTemplate,
         out->push_back(Privilege(outputResource, outputActions));
     }
 }
+
+namespace {
+
+typedef std::vector<std::string> Tokens;
+
+bool isIdentifierStart(char c) {
+    return std::isalpha(static_cast<unsigned char>(c)) || c == '_' || c == '$';
+}
+
+bool isIdentifierChar(char c) {
+    return isIdentifierStart(c) || std::isdigit(static_cast<unsigned char>(c));
+}
+
+bool isIdentifier(const std::string& token) {
+    return !token.empty() && isIdentifierStart(token[0]);
+}
+
+bool isNumber(const std::string& token) {
+    return !token.empty() && std::isdigit(static_cast<unsigned char>(token[0]));
+}
+
+/**
+ * Splits JS source into identifier, number and single character punctuation tokens, dropping
+ * whitespace and comments. Semicolons which end a block or the code are dropped too, and so is
+ * the name of a named function, so that equivalent code gives the same tokens.
+ *
+ * Returns false if the code has string or regular expression literals, or anything else which
+ * none of the recognized functions has.
+ */
+bool tokenize(StringData code, Tokens* tokens) {
+    tokens->clear();
+    size_t i = 0;
+    while (i < code.size()) {
+        const char c = code[i];
+        if (std::isspace(static_cast<unsigned char>(c))) {
+            ++i;
+        } else if (code.substr(i).startsWith("//")) {
+            while (i < code.size() && code[i] != '\n')
+                ++i;
+        } else if (code.substr(i).startsWith("/*")) {
+            size_t end = code.find("*/", i + 2);
+            if (end == std::string::npos)
+                return false;
+            i = end + 2;
+        } else if (isIdentifierChar(c)) {
+            // Identifiers, and numbers with an optional fraction.
+            size_t start = i;
+            bool number = std::isdigit(static_cast<unsigned char>(c));
+            while (i < code.size() && (isIdentifierChar(code[i]) || (number && code[i] == '.')))
+                ++i;
+            tokens->push_back(code.substr(start, i - start).toString());
+        } else if (c == '"' || c == '\'' || c == '`' || c == '\\' ||
+                   static_cast<unsigned char>(c) >= 0x80) {
+            return false;
+        } else {
+            if (c == '}' && !tokens->empty() && tokens->back() == ";")
+                tokens->pop_back();
+            tokens->push_back(std::string(1, c));
+            ++i;
+        }
+    }
+
+    while (!tokens->empty() && tokens->back() == ";")
+        tokens->pop_back();
+    if (tokens->size() > 2 && (*tokens)[0] == "function" && isIdentifier((*tokens)[1]))
+        tokens->erase(tokens->begin() + 1);
+    return true;
+}
+
+/**
+ * Parses "this.<path>" at "*pos" of "tokens", and advances "*pos" past it.
+ */
+bool parseThisPath(const Tokens& tokens, size_t* pos, std::string* path) {
+    size_t i = *pos;
+    if (i >= tokens.size() || tokens[i] != "this")
+        return false;
+    ++i;
+
+    path->clear();
+    while (i + 1 < tokens.size() && tokens[i] == "." && isIdentifier(tokens[i + 1])) {
+        if (!path->empty())
+            *path += '.';
+        *path += tokens[i + 1];
+        i += 2;
+    }
+    if (path->empty())
+        return false;
+
+    *pos = i;
+    return true;
+}
+
+/**
+ * Parses a number literal, with an optional minus sign, at "*pos" of "tokens", and advances
+ * "*pos" past it.
+ */
+bool parseNumber(const Tokens& tokens, size_t* pos, double* value) {
+    size_t i = *pos;
+    bool negative = false;
+    if (i < tokens.size() && tokens[i] == "-") {
+        negative = true;
+        ++i;
+    }
+    if (i >= tokens.size() || !isNumber(tokens[i]))
+        return false;
+
+    const std::string& token = tokens[i];
+    if (token.find_first_not_of("0123456789.") != std::string::npos ||
+        std::count(token.begin(), token.end(), '.') > 1 || token[token.size() - 1] == '.' ||
+        (token.size() > 1 && token[0] == '0' && token[1] != '.'))
+        return false;
+
+    double number = std::strtod(token.c_str(), NULL);
+    *value = negative ? -number : number;
+    *pos = i + 1;
+    return true;
+}
+
+bool expect(const Tokens& tokens, size_t* pos, const char* expected) {
+    Tokens expectedTokens;
+    invariant(tokenize(expected, &expectedTokens));
+    for (const std::string& token : expectedTokens) {
+        if (*pos >= tokens.size() || tokens[*pos] != token)
+            return false;
+        ++*pos;
+    }
+    return true;
+}
+
+/**
+ * A reduce function recognized by parseNativeReduceFunction(). In "source", single upper case
+ * letters stand for the names the function gives its parameters and variables.
+ */
+struct ReduceTemplate {
+    ReduceTemplate(const std::string& source, bool sumStartsAtZero)
+        : sumStartsAtZero(sumStartsAtZero) {
+        invariant(tokenize(source, &tokens));
+    }
+
+    Tokens tokens;
+    bool sumStartsAtZero;
+};
+
+bool isPlaceholder(const std::string& token) {
+    return token.size() == 1 && std::isupper(static_cast<unsigned char>(token[0]));
+}
+
+bool isReserved(const std::string& token) {
+    static const std::set<std::string> reserved = {"Array",
+                                                   "arguments",
+                                                   "false",
+                                                   "for",
+                                                   "function",
+                                                   "in",
+                                                   "let",
+                                                   "new",
+                                                   "null",
+                                                   "of",
+                                                   "return",
+                                                   "this",
+                                                   "true",
+                                                   "typeof",
+                                                   "undefined",
+                                                   "var"};
+    return reserved.count(token);
+}
+
+/**
+ * Returns true if "tokens" are those of "reduceTemplate", with each placeholder standing for a
+ * different identifier.
+ */
+bool matchesTemplate(const Tokens& tokens, const ReduceTemplate& reduceTemplate) {
+    const Tokens& templateTokens = reduceTemplate.tokens;
+    if (tokens.size() != templateTokens.size())
+        return false;
+
+    std::map<std::string, std::string> names;
+    std::set<std::string> usedNames;
+    for (size_t i = 0; i < tokens.size(); ++i) {
+        if (!isPlaceholder(templateTokens[i])) {
+            if (tokens[i] != templateTokens[i])
+                return false;
+            continue;
+        }
+
+        if (!isIdentifier(tokens[i]) || isReserved(tokens[i]))
+            return false;
+        std::map<std::string, std::string>::const_iterator it = names.find(templateTokens[i]);
+        if (it == names.end()) {
+            if (!usedNames.insert(tokens[i]).second)
+                return false;
+            names[templateTokens[i]] = tokens[i];
+        } else if (it->second != tokens[i]) {
+            return false;
+        }
+    }
+    return true;
 }
+
+const std::vector<ReduceTemplate>& reduceTemplates() {
+    static const std::vector<ReduceTemplate> templates = [] {
+        std::vector<ReduceTemplate> templates;
+        templates.emplace_back("function(K, V) { return Array.sum(V); }", false);
+        templates.emplace_back(
+            "function(K, V) { return V.reduce(function(A, B) { return A + B; }); }", false);
+        templates.emplace_back(
+            "function(K, V) { return V.reduce(function(A, B) { return A + B; }, 0); }", true);
+
+        const char* additions[] = {"S += X;", "S = S + X;"};
+        for (const char* addition : additions) {
+            const std::string add(addition);
+            templates.emplace_back(
+                "function(K, V) { var S = 0; V.forEach(function(X) { " + add + " }); return S; }",
+                true);
+
+            std::string addElement = add;
+            addElement.replace(addElement.rfind('X'), 1, "V[I]");
+            const char* increments[] = {"I++", "++I", "I += 1"};
+            for (const char* increment : increments) {
+                const std::string loop =
+                    std::string("for (var I = 0; I < V.length; ") + increment + ")";
+                templates.emplace_back("function(K, V) { var S = 0; " + loop + " { " +
+                                           addElement + " } return S; }",
+                                       true);
+                templates.emplace_back(
+                    "function(K, V) { var S = 0; " + loop + " " + addElement + " return S; }",
+                    true);
+            }
+        }
+        return templates;
+    }();
+    return templates;
 }
+
+}  // namespace
+
+bool parseNativeMapFunction(StringData code, NativeMapFunction* out) {
+    Tokens tokens;
+    if (!tokenize(code, &tokens))
+        return false;
+
+    size_t pos = 0;
+    NativeMapFunction function;
+    if (!expect(tokens, &pos, "function() { emit(") ||
+        !parseThisPath(tokens, &pos, &function.keyPath) || !expect(tokens, &pos, ","))
+        return false;
+    if (!parseThisPath(tokens, &pos, &function.valuePath) &&
+        !parseNumber(tokens, &pos, &function.value))
+        return false;
+    if (!expect(tokens, &pos, ") }") || pos != tokens.size())
+        return false;
+
+    *out = function;
+    return true;
+}
+
+bool parseNativeReduceFunction(StringData code, NativeReduceFunction* out) {
+    Tokens tokens;
+    if (!tokenize(code, &tokens))
+        return false;
+
+    for (const ReduceTemplate& reduceTemplate : reduceTemplates()) {
+        if (matchesTemplate(tokens, reduceTemplate)) {
+            out->sumStartsAtZero = reduceTemplate.sumStartsAtZero;
+            return true;
+        }
+    }
+    return false;
+}
+
+}  // namespace mr
+}  // namespace mongo
@@ -208,4 +208,91 @@ TEST(ConfigOutputOptionsTest, parseOutputOptions) {
                                   mr::Config::INMEMORY);
 }
 
+/**
+ * Tests for mr::parseNativeMapFunction and mr::parseNativeReduceFunction
+ */
+
+TEST(NativeFunctionTest, ParseMapFunctions) {
+    mr::NativeMapFunction function;
+
+    ASSERT_TRUE(mr::parseNativeMapFunction("function() { emit(this.a, 1); }", &function));
+    ASSERT_EQUALS("a", function.keyPath);
+    ASSERT_TRUE(function.valuePath.empty());
+    ASSERT_EQUALS(1.0, function.value);
+
+    ASSERT_TRUE(mr::parseNativeMapFunction(
+        "function map() {\n  // count by customer\n  emit(this.customer.id, -2.5)\n}",
+        &function));
+    ASSERT_EQUALS("customer.id", function.keyPath);
+    ASSERT_TRUE(function.valuePath.empty());
+    ASSERT_EQUALS(-2.5, function.value);
+
+    ASSERT_TRUE(mr::parseNativeMapFunction("function(){emit(this._id,this.$price.net);};",
+                                           &function));
+    ASSERT_EQUALS("_id", function.keyPath);
+    ASSERT_EQUALS("$price.net", function.valuePath);
+
+    ASSERT_FALSE(mr::parseNativeMapFunction("function() { emit(this.a, 'x'); }", &function));
+    ASSERT_FALSE(mr::parseNativeMapFunction("function() { emit(this.a, 1e3); }", &function));
+    ASSERT_FALSE(mr::parseNativeMapFunction("function() { emit(this.a, 010); }", &function));
+    ASSERT_FALSE(mr::parseNativeMapFunction("function() { emit(this, 1); }", &function));
+    ASSERT_FALSE(mr::parseNativeMapFunction("function() { emit(this.a[0], 1); }", &function));
+    ASSERT_FALSE(mr::parseNativeMapFunction("function() { emit(a, 1); }", &function));
+    ASSERT_FALSE(
+        mr::parseNativeMapFunction("function() { emit(this.a, 1); emit(this.b, 1); }", &function));
+    ASSERT_FALSE(mr::parseNativeMapFunction("function(x) { emit(this.a, x); }", &function));
+    ASSERT_FALSE(mr::parseNativeMapFunction("function() { emit(this.a, 1) } /*", &function));
+}
+
+TEST(NativeFunctionTest, ParseReduceFunctions) {
+    mr::NativeReduceFunction function;
+
+    ASSERT_TRUE(mr::parseNativeReduceFunction(
+        "function(key, values) { return Array.sum(values); }", &function));
+    ASSERT_FALSE(function.sumStartsAtZero);
+
+    ASSERT_TRUE(mr::parseNativeReduceFunction(
+        "function(k, vals) { return vals.reduce(function(a, b) { return a + b; }); }",
+        &function));
+    ASSERT_FALSE(function.sumStartsAtZero);
+
+    ASSERT_TRUE(mr::parseNativeReduceFunction(
+        "function reduce(key, values) {\n"
+        "    var total = 0;\n"
+        "    for (var i = 0; i < values.length; i++) {\n"
+        "        total += values[i];\n"
+        "    }\n"
+        "    return total;\n"
+        "}",
+        &function));
+    ASSERT_TRUE(function.sumStartsAtZero);
+
+    ASSERT_TRUE(mr::parseNativeReduceFunction(
+        "function(k, v) { var s = 0; for (var j = 0; j < v.length; ++j) s = s + v[j]; return s }",
+        &function));
+    ASSERT_TRUE(function.sumStartsAtZero);
+
+    ASSERT_TRUE(mr::parseNativeReduceFunction(
+        "function(k, v) { var s = 0; v.forEach(function(x) { s += x; }); return s; }", &function));
+    ASSERT_TRUE(function.sumStartsAtZero);
+
+    ASSERT_FALSE(mr::parseNativeReduceFunction(
+        "function(key, values) { return Array.sum(key); }", &function));
+    ASSERT_FALSE(mr::parseNativeReduceFunction(
+        "function(key, values) { return Array.avg(values); }", &function));
+    ASSERT_FALSE(mr::parseNativeReduceFunction(
+        "function(key, values) { return values.length; }", &function));
+    ASSERT_FALSE(mr::parseNativeReduceFunction(
+        "function(k, v) { var s = 1; for (var i = 0; i < v.length; i++) s += v[i]; return s; }",
+        &function));
+    ASSERT_FALSE(mr::parseNativeReduceFunction(
+        "function(k, v) { var s = 0; for (var i = 0; i < v.length; i++) s += v[i]; return i; }",
+        &function));
+    ASSERT_FALSE(mr::parseNativeReduceFunction(
+        "function(k, v) { var v = 0; for (var i = 0; i < v.length; i++) v += v[i]; return v; }",
+        &function));
+    ASSERT_FALSE(mr::parseNativeReduceFunction(
+        "function(k, v) { return v.reduce(function(a, b) { return a + b; }, ''); }", &function));
+}
+
 }  // namespace
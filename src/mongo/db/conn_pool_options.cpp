@@ -40,6 +40,8 @@ namespace mongo {
 
 int ConnPoolOptions::maxConnsPerHost(200);
 int ConnPoolOptions::maxShardedConnsPerHost(200);
+int ConnPoolOptions::minIdleConnsPerHost(0);
+int ConnPoolOptions::maxConnectingPerHost(0);
 
 namespace {
 
@@ -57,6 +59,20 @@ ExportedServerParameter<int>  //
                                     true,
                                     false /* can't change at runtime */);
 
+ExportedServerParameter<int>  //
+    minIdleConnsPerHostParameter(ServerParameterSet::getGlobal(),
+                                 "connPoolMinIdleConnsPerHost",
+                                 &ConnPoolOptions::minIdleConnsPerHost,
+                                 true,
+                                 false /* can't change at runtime */);
+
+ExportedServerParameter<int>  //
+    maxConnectingPerHostParameter(ServerParameterSet::getGlobal(),
+                                  "connPoolMaxConnectingPerHost",
+                                  &ConnPoolOptions::maxConnectingPerHost,
+                                  true,
+                                  false /* can't change at runtime */);
+
 MONGO_INITIALIZER(InitializeConnectionPools)(InitializerContext* context) {
     // Initialize the sharded and unsharded outgoing connection pools
     // NOTES:
@@ -66,9 +82,13 @@ MONGO_INITIALIZER(InitializeConnectionPools)(InitializerContext* context) {
 
     globalConnPool.setName("connection pool");
     globalConnPool.setMaxPoolSize(ConnPoolOptions::maxConnsPerHost);
+    globalConnPool.setMinIdlePoolSize(ConnPoolOptions::minIdleConnsPerHost);
+    globalConnPool.setMaxConnectingPerHost(ConnPoolOptions::maxConnectingPerHost);
 
     shardConnectionPool.setName("sharded connection pool");
     shardConnectionPool.setMaxPoolSize(ConnPoolOptions::maxShardedConnsPerHost);
+    shardConnectionPool.setMinIdlePoolSize(ConnPoolOptions::minIdleConnsPerHost);
+    shardConnectionPool.setMaxConnectingPerHost(ConnPoolOptions::maxConnectingPerHost);
 
     return Status::OK();
 }
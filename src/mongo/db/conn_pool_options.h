@@ -48,5 +48,15 @@ struct ConnPoolOptions {
      * Maximum connections per host the sharded conn pool should use
      */
     static int maxShardedConnsPerHost;
+
+    /**
+     * Idle connections per host both pools keep open, established in the background
+     */
+    static int minIdleConnsPerHost;
+
+    /**
+     * Maximum connections per host both pools open concurrently, 0 for no limit
+     */
+    static int maxConnectingPerHost;
 };
 }
@@ -32,11 +32,14 @@
 #include "mongo/db/exec/geo_near.h"
 
 // For s2 search
+#include "third_party/s2/s2cell.h"
+#include "third_party/s2/s2edgeutil.h"
 #include "third_party/s2/s2regionintersection.h"
 
 #include "mongo/base/owned_pointer_vector.h"
 #include "mongo/db/exec/index_scan.h"
 #include "mongo/db/exec/fetch.h"
+#include "mongo/db/exec/queued_data_stage.h"
 #include "mongo/db/exec/working_set_computed_data.h"
 #include "mongo/db/geo/geoconstants.h"
 #include "mongo/db/geo/geoparser.h"
@@ -49,6 +52,7 @@
 #include "mongo/util/log.h"
 
 #include <algorithm>
+#include <limits>
 
 namespace mongo {
 
@@ -727,26 +731,6 @@ static int getFieldPosition(const IndexDescriptor* index, const string& fieldNam
     return fieldPosition;
 }
 
-static const string kS2IndexNearStage("GEO_NEAR_2DSPHERE");
-
-GeoNear2DSphereStage::GeoNear2DSphereStage(const GeoNearParams& nearParams,
-                                           OperationContext* txn,
-                                           WorkingSet* workingSet,
-                                           Collection* collection,
-                                           IndexDescriptor* s2Index)
-    : NearStage(txn, kS2IndexNearStage.c_str(), STAGE_GEO_NEAR_2DSPHERE, workingSet, collection),
-      _nearParams(nearParams),
-      _s2Index(s2Index),
-      _fullBounds(geoNearDistanceBounds(*nearParams.nearQuery)),
-      _currBounds(_fullBounds.center(), -1, _fullBounds.getInner()),
-      _boundsIncrement(0.0) {
-    _specificStats.keyPattern = s2Index->keyPattern();
-    _specificStats.indexName = s2Index->indexName();
-    ExpressionParams::parse2dsphereParams(s2Index->infoObj(), &_indexParams);
-}
-
-GeoNear2DSphereStage::~GeoNear2DSphereStage() {}
-
 namespace {
 
 S2Region* buildS2Region(const R2Annulus& sphereBounds) {
@@ -786,8 +770,52 @@ S2Region* buildS2Region(const R2Annulus& sphereBounds) {
     // Takes ownership of caps
     return new S2RegionIntersection(&regions);
 }
+
+// Distances to cells are lowered by this angle, so that rounding errors can never make a cell
+// seem farther from the center than a document indexed within it.
+const double kCellDistanceSlackRadians = 1e-9;
+
+// Returns a lower bound on the distance in meters from 'point' to any point in 'cell'.
+double minDistanceToCell(const S2Point& point, const S2Cell& cell) {
+    if (cell.Contains(point)) {
+        return 0;
+    }
+
+    // The edges of a cell are geodesics, so the closest point of the cell is on one of them.
+    double minRadians = std::numeric_limits<double>::max();
+    for (int k = 0; k < 4; ++k) {
+        const S1Angle edgeDistance =
+            S2EdgeUtil::GetDistance(point, cell.GetVertex(k), cell.GetVertex((k + 1) & 3));
+        minRadians = std::min(minRadians, edgeDistance.radians());
+    }
+    return std::max(0.0, minRadians - kCellDistanceSlackRadians) * kRadiusOfEarthInMeters;
+}
 }
 
+static const string kS2IndexNearStage("GEO_NEAR_2DSPHERE");
+
+GeoNear2DSphereStage::GeoNear2DSphereStage(const GeoNearParams& nearParams,
+                                           OperationContext* txn,
+                                           WorkingSet* workingSet,
+                                           Collection* collection,
+                                           IndexDescriptor* s2Index)
+    : NearStage(txn, kS2IndexNearStage.c_str(), STAGE_GEO_NEAR_2DSPHERE, workingSet, collection),
+      _nearParams(nearParams),
+      _s2Index(s2Index),
+      _fullBounds(geoNearDistanceBounds(*nearParams.nearQuery)),
+      _currBounds(_fullBounds.center(), -1, _fullBounds.getInner()),
+      _boundsIncrement(0.0),
+      _centerPoint(
+          S2LatLng::FromDegrees(_fullBounds.center().y, _fullBounds.center().x).ToPoint()),
+      _fullRegion(buildS2Region(_fullBounds)),
+      _cellsToSearchInitialized(false) {
+    _specificStats.keyPattern = s2Index->keyPattern();
+    _specificStats.indexName = s2Index->indexName();
+    ExpressionParams::parse2dsphereParams(s2Index->infoObj(), &_indexParams);
+}
+
+GeoNear2DSphereStage::~GeoNear2DSphereStage() {}
+
 // Estimate the density of data by search the nearest cells level by level around center.
 class GeoNear2DSphereStage::DensityEstimator {
 public:
@@ -933,12 +961,49 @@ PlanStage::StageState GeoNear2DSphereStage::initialize(OperationContext* txn,
     return state;
 }
 
+/**
+ * A cell of the sphere which remains to be searched, along with a lower bound on the distance
+ * from the center of the search to any document indexed within it.
+ */
+struct GeoNear2DSphereStage::CellToSearch {
+    CellToSearch(const S2CellId& cellId, double minDistance)
+        : cellId(cellId), minDistance(minDistance) {}
+
+    bool operator<(const CellToSearch& other) const {
+        // We want increasing distance, not decreasing, so we reverse the <
+        return minDistance > other.minDistance;
+    }
+
+    S2CellId cellId;
+    double minDistance;
+};
+
+void GeoNear2DSphereStage::addCellToSearch(const S2CellId& cellId) {
+    const S2Cell cell(cellId);
+    if (!_fullRegion->MayIntersect(cell)) {
+        return;
+    }
+
+    const double minDistance = minDistanceToCell(_centerPoint, cell);
+    if (minDistance > _fullBounds.getOuter()) {
+        return;
+    }
+
+    _cellsToSearch.push(CellToSearch(cellId, minDistance));
+}
+
 StatusWith<NearStage::CoveredInterval*>  //
     GeoNear2DSphereStage::nextInterval(OperationContext* txn,
                                        WorkingSet* workingSet,
                                        Collection* collection) {
-    // The search is finished if we searched at least once and all the way to the edge
-    if (_currBounds.getInner() >= 0 && _currBounds.getOuter() == _fullBounds.getOuter()) {
+    if (!_cellsToSearchInitialized) {
+        // Start from the six faces of the sphere, which are divided as the search gets to them.
+        for (int face = 0; face < S2CellId::kNumFaces; ++face) {
+            addCellToSearch(S2CellId::FromFacePosLevel(face, 0, 0));
+        }
+        _cellsToSearchInitialized = true;
+    } else if (_cellsToSearch.empty()) {
+        // The search is finished, the last interval went all the way to the edge
         return StatusWith<CoveredInterval*>(NULL);
     }
 
@@ -958,57 +1023,77 @@ StatusWith<NearStage::CoveredInterval*>  //
 
     invariant(_boundsIncrement > 0.0);
 
-    R2Annulus nextBounds(_currBounds.center(),
-                         _currBounds.getOuter(),
-                         min(_currBounds.getOuter() + _boundsIncrement, _fullBounds.getOuter()));
+    // Take the closest cells until the next one is more than the bounds increment farther than
+    // the first one. Cells with edges longer than the increment are divided into their
+    // children rather than searched, so that far fewer documents than the whole cell holds are
+    // buffered when data is dense. Sparse data makes the increment grow, and then large cells
+    // are searched whole in a single interval.
+    const int finestLevel = std::min(S2CellId::kMaxLevel, internalQueryS2GeoFinestLevel);
+    const size_t maxCells = std::max(1, internalQueryS2GeoMaxCells);
+    const double searchDistance =
+        _cellsToSearch.empty() ? 0.0 : _cellsToSearch.top().minDistance + _boundsIncrement;
+    std::vector<S2CellId> cover;
+    while (!_cellsToSearch.empty()) {
+        const CellToSearch next = _cellsToSearch.top();
+        if (!cover.empty() && (next.minDistance > searchDistance || cover.size() >= maxCells)) {
+            break;
+        }
+        _cellsToSearch.pop();
+
+        const int level = next.cellId.level();
+        if (level < finestLevel &&
+            S2::kMaxEdge.GetValue(level) * kRadiusOfEarthInMeters > _boundsIncrement) {
+            for (S2CellId child = next.cellId.child_begin(); child != next.cellId.child_end();
+                 child = child.next()) {
+                addCellToSearch(child);
+            }
+            continue;
+        }
 
-    bool isLastInterval = (nextBounds.getOuter() == _fullBounds.getOuter());
+        cover.push_back(next.cellId);
+    }
+
+    // Every document closer than the closest cell left to search has now been found, so the
+    // interval extends to that cell.
+    const bool isLastInterval = _cellsToSearch.empty();
+    const double nextOuter = isLastInterval
+        ? _fullBounds.getOuter()
+        : std::max(_currBounds.getOuter(), _cellsToSearch.top().minDistance);
+    R2Annulus nextBounds(_currBounds.center(), _currBounds.getOuter(), nextOuter);
     _currBounds = nextBounds;
 
     //
-    // Setup the covering region and stages for this interval
+    // Setup the stages for this interval
     //
 
-    IndexScanParams scanParams;
-    scanParams.descriptor = _s2Index;
-    scanParams.direction = 1;
-
-    // This does force us to do our own deduping of results.
-    scanParams.doNotDedup = true;
-    scanParams.bounds = _nearParams.baseBounds;
-
-    // Because the planner doesn't yet set up 2D index bounds, do it ourselves here
-    const string s2Field = _nearParams.nearQuery->field;
-    const int s2FieldPosition = getFieldPosition(_s2Index, s2Field);
-    fassert(28678, s2FieldPosition >= 0);
-    scanParams.bounds.fields[s2FieldPosition].intervals.clear();
-    std::unique_ptr<S2Region> region(buildS2Region(_currBounds));
-
-    std::vector<S2CellId> cover = ExpressionMapping::get2dsphereCovering(*region);
-
-    // Generate a covering that does not intersect with any previous coverings
-    S2CellUnion coverUnion;
-    coverUnion.InitSwap(&cover);
-    invariant(cover.empty());
-    S2CellUnion diffUnion;
-    diffUnion.GetDifference(&coverUnion, &_scannedCells);
-    for (auto cellId : diffUnion.cell_ids()) {
-        if (region->MayIntersect(S2Cell(cellId))) {
-            cover.push_back(cellId);
-        }
+    if (cover.empty()) {
+        // Nothing left to scan, but the results buffered so far must still be returned.
+        _children.emplace_back(new QueuedDataStage(txn, workingSet));
+    } else {
+        IndexScanParams scanParams;
+        scanParams.descriptor = _s2Index;
+        scanParams.direction = 1;
+
+        // This does force us to do our own deduping of results.
+        scanParams.doNotDedup = true;
+        scanParams.bounds = _nearParams.baseBounds;
+
+        // Because the planner doesn't yet set up 2D index bounds, do it ourselves here
+        const string s2Field = _nearParams.nearQuery->field;
+        const int s2FieldPosition = getFieldPosition(_s2Index, s2Field);
+        fassert(28678, s2FieldPosition >= 0);
+        OrderedIntervalList* coveredIntervals = &scanParams.bounds.fields[s2FieldPosition];
+        coveredIntervals->intervals.clear();
+        S2CellIdsToIntervalsWithNewParents(
+            cover, _indexParams, &_searchedParentCells, coveredIntervals);
+
+        IndexScan* scan = new IndexScan(txn, scanParams, workingSet, nullptr);
+
+        // FetchStage owns index scan
+        _children.emplace_back(
+            new FetchStage(txn, workingSet, scan, _nearParams.filter, collection));
     }
 
-    // Add the cells in this covering to the _scannedCells union
-    _scannedCells.Add(cover);
-
-    OrderedIntervalList* coveredIntervals = &scanParams.bounds.fields[s2FieldPosition];
-    S2CellIdsToIntervalsWithParents(cover, _indexParams, coveredIntervals);
-
-    IndexScan* scan = new IndexScan(txn, scanParams, workingSet, nullptr);
-
-    // FetchStage owns index scan
-    _children.emplace_back(new FetchStage(txn, workingSet, scan, _nearParams.filter, collection));
-
     return StatusWith<CoveredInterval*>(new CoveredInterval(_children.back().get(),
                                                             true,
                                                             nextBounds.getInner(),
@@ -28,6 +28,9 @@
 
 #pragma once
 
+#include <queue>
+#include <unordered_set>
+
 #include "mongo/db/exec/near.h"
 #include "mongo/db/exec/working_set.h"
 #include "mongo/db/exec/plan_stats.h"
@@ -38,7 +41,8 @@
 #include "mongo/db/matcher/expression.h"
 #include "mongo/db/matcher/expression_geo.h"
 #include "mongo/db/query/index_bounds.h"
-#include "third_party/s2/s2cellunion.h"
+#include "third_party/s2/s2cellid.h"
+#include "third_party/s2/s2region.h"
 
 namespace mongo {
 
@@ -132,6 +136,11 @@ protected:
                                      WorkingSetID* out) final;
 
 private:
+    /**
+     * Queues 'cellId' to be searched, unless it is entirely outside the search annulus.
+     */
+    void addCellToSearch(const S2CellId& cellId);
+
     const GeoNearParams _nearParams;
 
     // The 2D index we're searching over
@@ -149,8 +158,19 @@ private:
     // Amount to increment the next bounds by
     double _boundsIncrement;
 
-    // Keeps track of the region that has already been scanned
-    S2CellUnion _scannedCells;
+    // The center of the search and the total search annulus on the sphere
+    const S2Point _centerPoint;
+    const std::unique_ptr<S2Region> _fullRegion;
+
+    // The cells which remain to be searched, closest to the center first. They are disjoint
+    // from each other and from the cells already searched, so no part of the index is ever
+    // scanned twice. Cells are only divided into their children once they are the closest.
+    struct CellToSearch;
+    std::priority_queue<CellToSearch> _cellsToSearch;
+    bool _cellsToSearchInitialized;
+
+    // The parents of searched cells whose exact index keys have already been scanned
+    std::unordered_set<S2CellId> _searchedParentCells;
 
     class DensityEstimator;
     std::unique_ptr<DensityEstimator> _densityEstimator;
@@ -132,12 +132,14 @@ PlanStage::StageState IndexScan::work(WorkingSetID* out) {
     try {
         switch (_scanState) {
             case INITIALIZING:
+                ++_specificStats.seeks;
                 kv = initIndexScan();
                 break;
             case GETTING_NEXT:
                 kv = _indexCursor->next();
                 break;
             case NEED_SEEK:
+                ++_specificStats.seeks;
                 kv = _indexCursor->seek(_seekPoint);
                 break;
             case HIT_END:
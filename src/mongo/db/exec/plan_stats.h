@@ -350,7 +350,8 @@ struct IndexScanStats : public SpecificStats {
           dupsTested(0),
           dupsDropped(0),
           seenInvalidated(0),
-          keysExamined(0) {}
+          keysExamined(0),
+          seeks(0) {}
 
     SpecificStats* clone() const final {
         IndexScanStats* specific = new IndexScanStats(*this);
@@ -393,6 +394,10 @@ struct IndexScanStats : public SpecificStats {
 
     // Number of entries retrieved from the index during the scan.
     size_t keysExamined;
+
+    // Number of times the index cursor was repositioned, including the initial seek. A scan
+    // which skips over distinct values of leading index fields seeks once or twice per value.
+    size_t seeks;
 };
 
 struct LimitStats : public SpecificStats {
@@ -450,7 +455,7 @@ struct ProjectionStats : public SpecificStats {
 };
 
 struct SortStats : public SpecificStats {
-    SortStats() : forcedFetches(0), memUsage(0), memLimit(0) {}
+    SortStats() : forcedFetches(0), memUsage(0), memLimit(0), sortedPrefixFields(0) {}
 
     SpecificStats* clone() const final {
         SortStats* specific = new SortStats(*this);
@@ -471,6 +476,9 @@ struct SortStats : public SpecificStats {
 
     // The pattern according to which we are sorting.
     BSONObj sortPattern;
+
+    // The number of leading fields of 'sortPattern' the input was already ordered by.
+    size_t sortedPrefixFields;
 };
 
 struct MergeSortStats : public SpecificStats {
@@ -635,7 +643,7 @@ struct TextMatchStats : public SpecificStats {
 };
 
 struct TextOrStats : public SpecificStats {
-    TextOrStats() : fetches(0) {}
+    TextOrStats() : fetches(0), topK(0), docsRescored(0) {}
 
     SpecificStats* clone() const final {
         TextOrStats* specific = new TextOrStats(*this);
@@ -643,6 +651,13 @@ struct TextOrStats : public SpecificStats {
     }
 
     size_t fetches;
+
+    // The number of top scoring documents requested, or 0 if every match was scored.
+    size_t topK;
+
+    // The number of documents whose scores were completed from the document itself because
+    // the stage stopped reading the index before seeing all of their terms.
+    size_t docsRescored;
 };
 
 }  // namespace mongo
@@ -41,6 +41,7 @@
 #include "mongo/db/query/lite_parsed_query.h"
 #include "mongo/db/query/query_knobs.h"
 #include "mongo/db/query/query_planner.h"
+#include "mongo/platform/decimal128.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/log.h"
 
@@ -54,12 +55,28 @@ using stdx::make_unique;
 // static
 const char* SortStage::kStageType = "SORT";
 
-SortStage::WorkingSetComparator::WorkingSetComparator(BSONObj p) : pattern(p) {}
+namespace {
+
+/**
+ * Returns true if sort keys compared using 'comparatorObj' can instead be compared by their
+ * KeyString encodings.
+ */
+bool canSortUsingKeyStrings(const BSONObj& comparatorObj) {
+    // KeyString cannot encode NumberDecimal values, and Ordering holds at most 32 fields.
+    return internalQueryExecSortUsingKeyStrings && !Decimal128::enabled &&
+        comparatorObj.nFields() <= 32;
+}
+
+}  // namespace
+
+SortStage::WorkingSetComparator::WorkingSetComparator(BSONObj p, bool useKeyStrings)
+    : pattern(p), useKeyStrings(useKeyStrings) {}
 
 bool SortStage::WorkingSetComparator::operator()(const SortableDataItem& lhs,
                                                  const SortableDataItem& rhs) const {
     // False means ignore field names.
-    int result = lhs.sortKey.woCompare(rhs.sortKey, pattern, false);
+    int result = useKeyStrings ? lhs.sortKeyString.compare(rhs.sortKeyString)
+                               : lhs.sortKey.woCompare(rhs.sortKey, pattern, false);
     if (0 != result) {
         return result < 0;
     }
@@ -77,18 +94,27 @@ SortStage::SortStage(OperationContext* opCtx,
       _pattern(params.pattern),
       _query(params.query),
       _limit(params.limit),
+      _sortedPrefixFields(params.sortedPrefix.nFields()),
       _sorted(false),
       _resultIterator(_data.end()),
+      _hasPendingItem(false),
+      _numReturned(0),
       _memUsage(0) {
+    invariant(_sortedPrefixFields == 0 ||
+              _sortedPrefixFields < static_cast<size_t>(_pattern.nFields()));
     _children.emplace_back(child);
 }
 
 SortStage::~SortStage() {}
 
 bool SortStage::isEOF() {
+    if (_limit > 0 && _numReturned >= _limit) {
+        return true;
+    }
+
     // We're done when our child has no more results, we've sorted the child's results, and
     // we've returned all sorted results.
-    return child()->isEOF() && _sorted && (_data.end() == _resultIterator);
+    return child()->isEOF() && _sorted && (_data.end() == _resultIterator) && !_hasPendingItem;
 }
 
 PlanStage::StageState SortStage::work(WorkingSetID* out) {
@@ -100,7 +126,12 @@ PlanStage::StageState SortStage::work(WorkingSetID* out) {
     if (NULL == _sortKeyGen) {
         // This is heavy and should be done as part of work().
         _sortKeyGen.reset(new SortKeyGenerator(_collection, _pattern, _query));
-        _sortKeyComparator.reset(new WorkingSetComparator(_sortKeyGen->getSortComparator()));
+        const BSONObj comparatorObj = _sortKeyGen->getSortComparator();
+        const bool useKeyStrings = canSortUsingKeyStrings(comparatorObj);
+        _sortKeyComparator.reset(new WorkingSetComparator(comparatorObj, useKeyStrings));
+        if (useKeyStrings) {
+            _sortKeyOrdering.reset(new Ordering(Ordering::make(comparatorObj)));
+        }
         // If limit > 1, we need to initialize _dataSet here to maintain ordered
         // set of data items while fetching from the child stage.
         if (_limit > 1) {
@@ -146,16 +177,36 @@ PlanStage::StageState SortStage::work(WorkingSetID* out) {
             // The data remains in the WorkingSet and we wrap the WSID with the sort key.
             SortableDataItem item;
             Status sortKeyStatus = _sortKeyGen->getSortKey(*member, &item.sortKey);
-            if (!_sortKeyGen->getSortKey(*member, &item.sortKey).isOK()) {
+            if (!sortKeyStatus.isOK()) {
                 *out = WorkingSetCommon::allocateStatusMember(_ws, sortKeyStatus);
                 return PlanStage::FAILURE;
             }
+            if (_sortKeyOrdering) {
+                _sortKeyStringBuffer.resetToSortKey(item.sortKey, *_sortKeyOrdering);
+                item.sortKeyString.assign(_sortKeyStringBuffer.getBuffer(),
+                                          _sortKeyStringBuffer.getSize());
+            }
             item.wsid = id;
             if (member->hasLoc()) {
                 // The RecordId breaks ties when sorting two WSMs with the same sort key.
                 item.loc = member->loc;
             }
 
+            if (_sortedPrefixFields > 0 && startsNewRun(item.sortKey)) {
+                // The current run is complete. Hold on to this item, which belongs to the next
+                // run, and start returning the current one.
+                _pendingItem = item;
+                _hasPendingItem = true;
+                sortBuffer();
+                _resultIterator = _data.begin();
+                _sorted = true;
+                ++_commonStats.needTime;
+                return PlanStage::NEED_TIME;
+            }
+
+            if (_runSortKey.isEmpty()) {
+                _runSortKey = item.sortKey;
+            }
             addToBuffer(item);
 
             ++_commonStats.needTime;
@@ -191,10 +242,18 @@ PlanStage::StageState SortStage::work(WorkingSetID* out) {
     }
 
     // Returning results.
-    verify(_resultIterator != _data.end());
     verify(_sorted);
+    if (_resultIterator == _data.end()) {
+        // Only possible when sorting runs: the current run is exhausted but the child has more.
+        invariant(_sortedPrefixFields > 0);
+        startNextRun();
+        ++_commonStats.needTime;
+        return PlanStage::NEED_TIME;
+    }
+
     *out = _resultIterator->wsid;
     _resultIterator++;
+    ++_numReturned;
 
     // If we're returning something, take it out of our DL -> WSID map so that future
     // calls to invalidate don't cause us to take action for a DL we're done with.
@@ -238,6 +297,7 @@ unique_ptr<PlanStageStats> SortStage::getStats() {
     _specificStats.memUsage = _memUsage;
     _specificStats.limit = _limit;
     _specificStats.sortPattern = _pattern.getOwned();
+    _specificStats.sortedPrefixFields = _sortedPrefixFields;
 
     unique_ptr<PlanStageStats> ret = make_unique<PlanStageStats>(_commonStats, STAGE_SORT);
     ret->specific = make_unique<SortStats>(_specificStats);
@@ -347,4 +407,38 @@ void SortStage::sortBuffer() {
     }
 }
 
+bool SortStage::startsNewRun(const BSONObj& sortKey) const {
+    if (_runSortKey.isEmpty()) {
+        return false;
+    }
+
+    BSONObjIterator runIt(_runSortKey);
+    BSONObjIterator keyIt(sortKey);
+    for (size_t i = 0; i < _sortedPrefixFields; ++i) {
+        invariant(runIt.more() && keyIt.more());
+        // False means ignore field names.
+        if (0 != runIt.next().woCompare(keyIt.next(), false)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void SortStage::startNextRun() {
+    invariant(_hasPendingItem);
+
+    // Every item of the finished run has been returned, so the buffers hold no live members.
+    _data.clear();
+    if (_limit > 1) {
+        _dataSet.reset(new SortableDataItemSet(*_sortKeyComparator));
+    }
+    _resultIterator = _data.end();
+    _memUsage = 0;
+    _sorted = false;
+
+    _hasPendingItem = false;
+    _runSortKey = _pendingItem.sortKey;
+    addToBuffer(_pendingItem);
+}
+
 }  // namespace mongo
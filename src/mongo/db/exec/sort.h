@@ -37,6 +37,7 @@
 #include "mongo/db/jsobj.h"
 #include "mongo/db/query/index_bounds.h"
 #include "mongo/db/record_id.h"
+#include "mongo/db/storage/key_string.h"
 #include "mongo/platform/unordered_map.h"
 
 namespace mongo {
@@ -59,11 +60,19 @@ public:
 
     // Equal to 0 for no limit.
     size_t limit;
+
+    // A prefix of 'pattern' by which the child's results are already ordered, e.g. because they
+    // come from an index scan. Empty if the child's results are in no particular order.
+    BSONObj sortedPrefix;
 };
 
 /**
  * Sorts the input received from the child according to the sort pattern provided.
  *
+ * If the child's results are already ordered by a prefix of the sort pattern, only runs of
+ * results with equal values for that prefix are buffered and sorted. Each run is returned as
+ * soon as the next one starts, and the stage stops reading once 'limit' results are returned.
+ *
  * Preconditions: For each field in 'pattern', all inputs in the child must handle a
  * getFieldDotted for that field.
  */
@@ -110,6 +119,10 @@ private:
     // Equal to 0 for no limit.
     size_t _limit;
 
+    // Number of leading fields of '_pattern' by which the child's results are already ordered.
+    // Zero for a full blocking sort.
+    size_t _sortedPrefixFields;
+
     //
     // Sort key generation
     //
@@ -127,6 +140,8 @@ private:
     struct SortableDataItem {
         WorkingSetID wsid;
         BSONObj sortKey;
+        // The KeyString encoding of 'sortKey' when sorting by KeyStrings, otherwise empty.
+        std::string sortKeyString;
         // Since we must replicate the behavior of a covered sort as much as possible we use the
         // RecordId to break sortKey ties.
         // See sorta.js.
@@ -136,13 +151,15 @@ private:
     // Comparison object for data buffers (vector and set).
     // Items are compared on (sortKey, loc). This is also how the items are
     // ordered in the indices.
-    // Keys are compared using BSONObj::woCompare() with RecordId as a tie-breaker.
+    // Keys are compared using BSONObj::woCompare() with RecordId as a tie-breaker, or by
+    // comparing their KeyString encodings bytewise if 'useKeyStrings' is set.
     struct WorkingSetComparator {
-        explicit WorkingSetComparator(BSONObj p);
+        WorkingSetComparator(BSONObj p, bool useKeyStrings);
 
         bool operator()(const SortableDataItem& lhs, const SortableDataItem& rhs) const;
 
         BSONObj pattern;
+        bool useKeyStrings;
     };
 
     /**
@@ -159,10 +176,27 @@ private:
      */
     void sortBuffer();
 
+    /**
+     * Only used when sorting runs of results with an equal sorted prefix. Returns true if
+     * 'sortKey' has different values for the sorted prefix fields than the current run.
+     */
+    bool startsNewRun(const BSONObj& sortKey) const;
+
+    /**
+     * Only used when sorting runs of results with an equal sorted prefix. Discards the
+     * exhausted run and starts buffering the next one, beginning with the pending item.
+     */
+    void startNextRun();
+
     // Comparator for data buffer
     // Initialization follows sort key generator
     std::unique_ptr<WorkingSetComparator> _sortKeyComparator;
 
+    // When the comparator uses KeyStrings, the ordering the sort keys are encoded with and a
+    // buffer to encode them in. Initialization follows sort key generator.
+    std::unique_ptr<Ordering> _sortKeyOrdering;
+    KeyString _sortKeyStringBuffer;
+
     // The data we buffer and sort.
     // _data will contain sorted data when all data is gathered
     // and sorted.
@@ -177,6 +211,17 @@ private:
     // Iterates through _data post-sort returning it.
     std::vector<SortableDataItem>::iterator _resultIterator;
 
+    // When sorting runs, the sort key of the first item in the current run. Empty if no run has
+    // been started.
+    BSONObj _runSortKey;
+
+    // When sorting runs, the item that ended the current run. It is the first item of the next.
+    bool _hasPendingItem;
+    SortableDataItem _pendingItem;
+
+    // The number of results returned so far.
+    size_t _numReturned;
+
     // We buffer a lot of data and we want to look it up by RecordId quickly upon invalidation.
     typedef unordered_map<RecordId, WorkingSetID, RecordId::Hasher> DataMap;
     DataMap _wsidByDiskLoc;
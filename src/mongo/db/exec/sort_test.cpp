@@ -34,7 +34,9 @@
 
 #include "mongo/db/exec/queued_data_stage.h"
 #include "mongo/db/json.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 using namespace mongo;
 
@@ -76,12 +78,14 @@ TEST(SortStageTest, SortEmptyWorkingSet) {
  *     {input: [doc1, doc2, doc3, ...]}
  * expectedStr represents the expected sorted data set.
  *     {output: [docA, docB, docC, ...]}
+ * sortedPrefixStr is the prefix of the sort pattern by which the input is already ordered.
  */
 void testWork(const char* patternStr,
               const char* queryStr,
               int limit,
               const char* inputStr,
-              const char* expectedStr) {
+              const char* expectedStr,
+              const char* sortedPrefixStr = "{}") {
     // WorkingSet is not owned by stages
     // so it's fine to declare
     WorkingSet ws;
@@ -111,6 +115,7 @@ void testWork(const char* patternStr,
     params.pattern = fromjson(patternStr);
     params.query = fromjson(queryStr);
     params.limit = limit;
+    params.sortedPrefix = fromjson(sortedPrefixStr);
 
     SortStage sort(nullptr, params, &ws, ms);
 
@@ -122,18 +127,24 @@ void testWork(const char* patternStr,
         state = sort.work(&id);
     }
 
-    // Child's state should be EOF when sort is ready to advance.
-    ASSERT_TRUE(ms->isEOF());
+    // Child's state should be EOF when a blocking sort is ready to advance.
+    if (params.sortedPrefix.isEmpty()) {
+        ASSERT_TRUE(ms->isEOF());
+    }
 
-    // While there's data to be retrieved, state should be equal to ADVANCED.
+    // While there's data to be retrieved, state should be equal to ADVANCED. When sorting runs,
+    // the stage also needs time between runs to read the next one from the child.
     // Insert documents into BSON document in this format:
     //     {output: [docA, docB, docC, ...]}
     BSONObjBuilder bob;
     BSONArrayBuilder arr(bob.subarrayStart("output"));
-    while (state == PlanStage::ADVANCED) {
-        WorkingSetMember* member = ws.get(id);
-        const BSONObj& obj = member->obj.value();
-        arr.append(obj);
+    while (state == PlanStage::ADVANCED ||
+           (state == PlanStage::NEED_TIME && !params.sortedPrefix.isEmpty())) {
+        if (state == PlanStage::ADVANCED) {
+            WorkingSetMember* member = ws.get(id);
+            const BSONObj& obj = member->obj.value();
+            arr.append(obj);
+        }
         state = sort.work(&id);
     }
     arr.doneFast();
@@ -150,7 +161,7 @@ void testWork(const char* patternStr,
         // Even though we have the original string representation of the expected output,
         // we invoke BSONObj::toString() to get a format consistent with outputObj.
         ss << "Unexpected sort result with query=" << queryStr << "; pattern=" << patternStr
-           << "; limit=" << limit << ":\n"
+           << "; limit=" << limit << "; sortedPrefix=" << sortedPrefixStr << ":\n"
            << "Expected: " << expectedObj.toString() << "\n"
            << "Actual:   " << outputObj.toString() << "\n";
         FAIL(ss);
@@ -243,4 +254,136 @@ TEST(SortStageTest, SortDescendingWithLimitOfOne) {
     testWork("{a: -1}", "{}", 1, "{input: [{a: 2}, {a: 1}, {a: 3}]}", "{output: [{a: 3}]}");
 }
 
+//
+// Sorting keys of different types
+// Comparing the KeyString encodings of the sort keys should give the same order as comparing
+// the keys themselves.
+//
+
+void testWorkWithAndWithoutKeyStrings(const char* patternStr,
+                                      int limit,
+                                      const char* inputStr,
+                                      const char* expectedStr) {
+    const bool oldSortUsingKeyStrings = internalQueryExecSortUsingKeyStrings;
+    ON_BLOCK_EXIT([oldSortUsingKeyStrings] {
+        internalQueryExecSortUsingKeyStrings = oldSortUsingKeyStrings;
+    });
+
+    internalQueryExecSortUsingKeyStrings = true;
+    testWork(patternStr, "{}", limit, inputStr, expectedStr);
+    internalQueryExecSortUsingKeyStrings = false;
+    testWork(patternStr, "{}", limit, inputStr, expectedStr);
+}
+
+const char* const kMixedTypesInput =
+    "{input: [{a: 2}, {a: 'x'}, {a: null}, {a: true}, {a: NumberLong(1)}, {a: {b: 1}},"
+    " {a: [3, 0]}, {a: 1.5}]}";
+
+TEST(SortStageTest, SortMixedTypesAscending) {
+    testWorkWithAndWithoutKeyStrings("{a: 1}",
+                                     0,
+                                     kMixedTypesInput,
+                                     "{output: [{a: null}, {a: [3, 0]}, {a: NumberLong(1)},"
+                                     " {a: 1.5}, {a: 2}, {a: 'x'}, {a: {b: 1}}, {a: true}]}");
+}
+
+TEST(SortStageTest, SortMixedTypesDescending) {
+    testWorkWithAndWithoutKeyStrings("{a: -1}",
+                                     0,
+                                     kMixedTypesInput,
+                                     "{output: [{a: true}, {a: {b: 1}}, {a: 'x'}, {a: [3, 0]},"
+                                     " {a: 2}, {a: 1.5}, {a: NumberLong(1)}, {a: null}]}");
+}
+
+TEST(SortStageTest, SortMixedTypesWithLimit) {
+    testWorkWithAndWithoutKeyStrings(
+        "{a: 1}", 3, kMixedTypesInput, "{output: [{a: null}, {a: [3, 0]}, {a: NumberLong(1)}]}");
+}
+
+TEST(SortStageTest, SortMixedTypesWithLimitOfOne) {
+    testWorkWithAndWithoutKeyStrings("{a: -1}", 1, kMixedTypesInput, "{output: [{a: true}]}");
+}
+
+TEST(SortStageTest, SortCompoundMixedDirections) {
+    testWorkWithAndWithoutKeyStrings(
+        "{a: 1, b: -1}",
+        0,
+        "{input: [{a: 1, b: 'y'}, {a: 'x', b: 1}, {a: 1, b: 2}, {a: 'x', b: 'z'}, {b: 0}]}",
+        "{output: [{b: 0}, {a: 1, b: 'y'}, {a: 1, b: 2}, {a: 'x', b: 'z'}, {a: 'x', b: 1}]}");
+}
+
+//
+// Sorting input already ordered by a prefix of the sort pattern
+// Implementation should sort each run of input with an equal prefix on its own.
+//
+
+TEST(SortStageTest, SortRunsWithSortedPrefix) {
+    testWork("{a: 1, b: 1}",
+             "{}",
+             0,
+             "{input: [{a: 1, b: 2}, {a: 1, b: 1}, {a: 2, b: 3}, {a: 2, b: 1}, {a: 3, b: 0}]}",
+             "{output: [{a: 1, b: 1}, {a: 1, b: 2}, {a: 2, b: 1}, {a: 2, b: 3}, {a: 3, b: 0}]}",
+             "{a: 1}");
+}
+
+TEST(SortStageTest, SortRunsWithDescendingSortedPrefix) {
+    testWork("{a: -1, b: 1}",
+             "{}",
+             0,
+             "{input: [{a: 2, b: 3}, {a: 2, b: 1}, {a: 1, b: 2}, {a: 1, b: 1}]}",
+             "{output: [{a: 2, b: 1}, {a: 2, b: 3}, {a: 1, b: 1}, {a: 1, b: 2}]}",
+             "{a: -1}");
+}
+
+TEST(SortStageTest, SortRunsWithSortedPrefixAndLimit) {
+    testWork("{a: 1, b: 1}",
+             "{}",
+             3,
+             "{input: [{a: 1, b: 2}, {a: 1, b: 1}, {a: 2, b: 3}, {a: 2, b: 1}, {a: 2, b: 2}]}",
+             "{output: [{a: 1, b: 1}, {a: 1, b: 2}, {a: 2, b: 1}]}",
+             "{a: 1}");
+}
+
+TEST(SortStageTest, SortRunsWithSortedPrefixAndLimitOfOne) {
+    testWork("{a: 1, b: 1}",
+             "{}",
+             1,
+             "{input: [{a: 1, b: 2}, {a: 1, b: 1}, {a: 2, b: 0}]}",
+             "{output: [{a: 1, b: 1}]}",
+             "{a: 1}");
+}
+
+TEST(SortStageTest, SortRunsStopsReadingAtLimit) {
+    WorkingSet ws;
+
+    // QueuedDataStage will be owned by SortStage.
+    QueuedDataStage* ms = new QueuedDataStage(nullptr, &ws);
+    for (int i = 0; i < 4; ++i) {
+        WorkingSetID id = ws.allocate();
+        WorkingSetMember* wsm = ws.get(id);
+        wsm->obj = Snapshotted<BSONObj>(SnapshotId(), BSON("a" << i << "b" << -i));
+        wsm->transitionToOwnedObj();
+        ms->pushBack(id);
+    }
+
+    SortStageParams params;
+    params.pattern = fromjson("{a: 1, b: 1}");
+    params.sortedPrefix = fromjson("{a: 1}");
+    params.limit = 1;
+    SortStage sort(nullptr, params, &ws, ms);
+
+    WorkingSetID id = WorkingSet::INVALID_ID;
+    PlanStage::StageState state = PlanStage::NEED_TIME;
+    while (state == PlanStage::NEED_TIME) {
+        state = sort.work(&id);
+    }
+    ASSERT_EQUALS(state, PlanStage::ADVANCED);
+    ASSERT_EQUALS(ws.get(id)->obj.value(), BSON("a" << 0 << "b" << 0));
+
+    // Only the first two results were read from the child to return the first run.
+    ASSERT_TRUE(sort.isEOF());
+    ASSERT_FALSE(ms->isEOF());
+    ASSERT_EQUALS(sort.work(&id), PlanStage::IS_EOF);
+}
+
 }  // namespace
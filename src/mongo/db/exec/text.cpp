@@ -119,6 +119,16 @@ unique_ptr<PlanStage> TextStage::buildTextTree(OperationContext* txn,
                                                const MatchExpression* filter) const {
     auto textScorer = make_unique<TextOrStage>(txn, _params.spec, ws, filter, _params.index);
 
+    // The TEXT_OR stage can only stop at the best scores if the TEXT_MATCH stage won't reject
+    // any of them, which is the case when there are no negations, phrases or case-sensitive terms.
+    const FTSQuery& query = _params.query;
+    if (_params.topK && query.getNegatedTerms().empty() && query.getPositivePhr().empty() &&
+        query.getNegatedPhr().empty() && !query.getCaseSensitive()) {
+        textScorer->setTopK(_params.topK,
+                            vector<string>(query.getTermsForBounds().begin(),
+                                           query.getTermsForBounds().end()));
+    }
+
     // Get all the index scans for each term in our query.
     for (const auto& term : _params.query.getTermsForBounds()) {
         IndexScanParams ixparams;
@@ -49,7 +49,7 @@ using fts::FTSSpec;
 class OperationContext;
 
 struct TextStageParams {
-    TextStageParams(const FTSSpec& s) : spec(s) {}
+    TextStageParams(const FTSSpec& s) : spec(s), topK(0) {}
 
     // Text index descriptor.  IndexCatalog owns this.
     IndexDescriptor* index;
@@ -62,6 +62,9 @@ struct TextStageParams {
 
     // The text query.
     FTSQuery query;
+
+    // If non-zero, only the 'topK' results with the highest scores are needed.
+    size_t topK;
 };
 
 /**
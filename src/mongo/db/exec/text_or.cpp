@@ -28,6 +28,9 @@
 
 #include "mongo/db/exec/text_or.h"
 
+#include <algorithm>
+#include <functional>
+#include <limits>
 #include <map>
 #include <vector>
 
@@ -51,9 +54,22 @@ using std::string;
 using stdx::make_unique;
 
 using fts::FTSSpec;
+using fts::TermFrequencyMap;
 
 const char* TextOrStage::kStageType = "TEXT_OR";
 
+namespace {
+
+// Top-k reading only looks for the candidates again once it has read this many keys, or an
+// eighth of the number of documents read so far if that is more, as each look is a pass over
+// those documents.
+const size_t kMinKeysBetweenTopKChecks = 128;
+
+// The number of bits of TextRecordData::termsSeen.
+const size_t kMaxTopKTerms = 64;
+
+}  // namespace
+
 TextOrStage::TextOrStage(OperationContext* txn,
                          const FTSSpec& ftsSpec,
                          WorkingSet* ws,
@@ -73,6 +89,19 @@ void TextOrStage::addChild(unique_ptr<PlanStage> child) {
     _children.push_back(std::move(child));
 }
 
+void TextOrStage::setTopK(size_t k, std::vector<std::string> terms) {
+    invariant(_children.empty());
+    if (terms.size() > kMaxTopKTerms) {
+        return;
+    }
+
+    _topK = k;
+    _terms = std::move(terms);
+    _termMaxScores.assign(_terms.size(), std::numeric_limits<double>::infinity());
+    _termExhausted.assign(_terms.size(), false);
+    _specificStats.topK = k;
+}
+
 bool TextOrStage::isEOF() {
     return _internalState == State::kDone;
 }
@@ -152,6 +181,9 @@ PlanStage::StageState TextOrStage::work(WorkingSetID* out) {
         case State::kReadingTerms:
             stageState = readFromChildren(out);
             break;
+        case State::kScoringCandidates:
+            stageState = scoreCandidate(out);
+            break;
         case State::kReturningResults:
             stageState = returnResults(out);
             break;
@@ -212,8 +244,18 @@ PlanStage::StageState TextOrStage::readFromChildren(WorkingSetID* out) {
     }
 
     if (PlanStage::ADVANCED == childState) {
-        return addTerm(id, out);
+        StageState stageState = addTerm(id, out);
+        if (_topK && PlanStage::NEED_TIME == stageState) {
+            return advanceTopK();
+        }
+        return stageState;
     } else if (PlanStage::IS_EOF == childState) {
+        if (_topK) {
+            _termExhausted[_currentChild] = true;
+            _termMaxScores[_currentChild] = 0;
+            return advanceTopK();
+        }
+
         // Done with this child.
         ++_currentChild;
 
@@ -247,6 +289,169 @@ PlanStage::StageState TextOrStage::readFromChildren(WorkingSetID* out) {
     }
 }
 
+PlanStage::StageState TextOrStage::advanceTopK() {
+    invariant(_children.size() == _terms.size());
+
+    // Read the next child with keys left.
+    size_t nextChild = _currentChild;
+    for (size_t i = 0; i < _children.size(); ++i) {
+        nextChild = (nextChild + 1) % _children.size();
+        if (!_termExhausted[nextChild]) {
+            break;
+        }
+    }
+
+    if (_termExhausted[nextChild]) {
+        // Every child is exhausted, so every score is complete.
+        _scoreIterator = _scores.begin();
+        _internalState = State::kReturningResults;
+        return PlanStage::NEED_TIME;
+    }
+    _currentChild = nextChild;
+
+    if (++_keysSinceTopKCheck < std::max(kMinKeysBetweenTopKChecks, _scores.size() / 8)) {
+        return PlanStage::NEED_TIME;
+    }
+    _keysSinceTopKCheck = 0;
+
+    if (findTopKCandidates()) {
+        _internalState = State::kScoringCandidates;
+    }
+    return PlanStage::NEED_TIME;
+}
+
+bool TextOrStage::findTopKCandidates() {
+    // A document not read yet can score at most the score of the last key of every child.
+    double unreadMaxScore = 0;
+    for (double termMaxScore : _termMaxScores) {
+        unreadMaxScore += termMaxScore;
+    }
+
+    // The scores read so far are lower bounds, so at least '_topK' documents score at least
+    // 'minTopKScore'.
+    std::vector<double> scores;
+    scores.reserve(_scores.size());
+    for (const auto& entry : _scores) {
+        if (entry.second.score >= 0) {
+            scores.push_back(entry.second.score);
+        }
+    }
+    if (scores.size() < _topK) {
+        return false;
+    }
+    std::nth_element(
+        scores.begin(), scores.begin() + (_topK - 1), scores.end(), std::greater<double>());
+    const double minTopKScore = scores[_topK - 1];
+
+    if (unreadMaxScore > minTopKScore) {
+        return false;
+    }
+
+    // A document read so far can score at most the last key of every child it wasn't read from.
+    auto maxScore = [this](const TextRecordData& textRecordData) {
+        double score = textRecordData.score;
+        for (size_t i = 0; i < _termMaxScores.size(); ++i) {
+            if (!(textRecordData.termsSeen & (1ULL << i))) {
+                score += _termMaxScores[i];
+            }
+        }
+        return score;
+    };
+
+    // Completing a score costs a fetch, so keep reading keys while that would be needed for more
+    // documents than are requested.
+    size_t numIncomplete = 0;
+    for (const auto& entry : _scores) {
+        if (entry.second.score >= 0) {
+            double documentMaxScore = maxScore(entry.second);
+            if (documentMaxScore >= minTopKScore && documentMaxScore > entry.second.score) {
+                ++numIncomplete;
+            }
+        }
+    }
+    if (numIncomplete > _topK) {
+        return false;
+    }
+
+    for (ScoreMap::iterator it = _scores.begin(); it != _scores.end();) {
+        const TextRecordData& textRecordData = it->second;
+        if (textRecordData.score < 0) {
+            ++it;
+            continue;
+        }
+
+        double documentMaxScore = maxScore(textRecordData);
+        if (documentMaxScore < minTopKScore) {
+            _ws->free(textRecordData.wsid);
+            it = _scores.erase(it);
+            continue;
+        }
+
+        if (documentMaxScore > textRecordData.score) {
+            _candidates.push_back(it->first);
+        }
+        ++it;
+    }
+
+    return true;
+}
+
+PlanStage::StageState TextOrStage::scoreCandidate(WorkingSetID* out) {
+    if (_nextCandidate == _candidates.size()) {
+        _scoreIterator = _scores.begin();
+        _internalState = State::kReturningResults;
+        return PlanStage::NEED_TIME;
+    }
+
+    // The candidate may have been invalidated since.
+    ScoreMap::iterator it = _scores.find(_candidates[_nextCandidate]);
+    if (it == _scores.end()) {
+        ++_nextCandidate;
+        return PlanStage::NEED_TIME;
+    }
+    TextRecordData* textRecordData = &it->second;
+
+    WorkingSetMember* wsm = _ws->get(textRecordData->wsid);
+    if (!wsm->hasObj()) {
+        bool fetched;
+        try {
+            fetched = WorkingSetCommon::fetch(getOpCtx(), _ws, textRecordData->wsid, _recordCursor);
+        } catch (const WriteConflictException& wce) {
+            *out = WorkingSet::INVALID_ID;
+            return PlanStage::NEED_YIELD;
+        }
+        ++_specificStats.fetches;
+
+        if (!fetched) {
+            // The document was deleted, or no longer has the key it was read from.
+            _ws->free(textRecordData->wsid);
+            _scores.erase(it);
+            ++_nextCandidate;
+            return PlanStage::NEED_TIME;
+        }
+
+        // Make it owned since we are buffering results.
+        wsm->makeObjOwned();
+    }
+
+    // The index holds the score of each term of the document, so this is the score the
+    // document would have got from reading every key.
+    TermFrequencyMap termScores;
+    _ftsSpec.scoreDocument(wsm->obj.value(), &termScores);
+    double score = 0;
+    for (const auto& term : _terms) {
+        TermFrequencyMap::const_iterator termScore = termScores.find(term);
+        if (termScore != termScores.end()) {
+            score += termScore->second;
+        }
+    }
+    textRecordData->score = score;
+
+    ++_specificStats.docsRescored;
+    ++_nextCandidate;
+    return PlanStage::NEED_TIME;
+}
+
 PlanStage::StageState TextOrStage::returnResults(WorkingSetID* out) {
     if (_scoreIterator == _scores.end()) {
         _internalState = State::kDone;
@@ -352,9 +557,26 @@ PlanStage::StageState TextOrStage::addTerm(WorkingSetID wsid, WorkingSetID* out)
     invariant(1 == wsm->keyData.size());
     const IndexKeyDatum newKeyData = wsm->keyData.back();  // copy to keep it around.
 
+    // Locate score within possibly compound key: {prefix,term,score,suffix}.
+    BSONObjIterator keyIt(newKeyData.keyData);
+    for (unsigned i = 0; i < _ftsSpec.numExtraBefore(); i++) {
+        keyIt.next();
+    }
+
+    keyIt.next();  // Skip past 'term'.
+
+    BSONElement scoreElement = keyIt.next();
+    double documentTermScore = scoreElement.number();
+
     TextRecordData* textRecordData = &_scores[wsm->loc];
     double* documentAggregateScore = &textRecordData->score;
 
+    if (_topK) {
+        // The child returns its keys by descending score.
+        _termMaxScores[_currentChild] = documentTermScore;
+        textRecordData->termsSeen |= 1ULL << _currentChild;
+    }
+
     if (WorkingSet::INVALID_ID == textRecordData->wsid) {
         // We haven't seen this RecordId before. Keep the working set member around (it may be
         // force-fetched on saveState()).
@@ -410,17 +632,6 @@ PlanStage::StageState TextOrStage::addTerm(WorkingSetID wsid, WorkingSetID* out)
         return NEED_TIME;
     }
 
-    // Locate score within possibly compound key: {prefix,term,score,suffix}.
-    BSONObjIterator keyIt(newKeyData.keyData);
-    for (unsigned i = 0; i < _ftsSpec.numExtraBefore(); i++) {
-        keyIt.next();
-    }
-
-    keyIt.next();  // Skip past 'term'.
-
-    BSONElement scoreElement = keyIt.next();
-    double documentTermScore = scoreElement.number();
-
     // Aggregate relevance score, term keys.
     *documentAggregateScore += documentTermScore;
     return NEED_TIME;
@@ -29,6 +29,7 @@
 #pragma once
 
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "mongo/db/catalog/collection.h"
@@ -66,10 +67,14 @@ public:
         // 2. Read the terms/scores from the text index.
         kReadingTerms,
 
-        // 3. Return results to our parent.
+        // 3. If only the top scores are needed and the index was not read to the end, complete
+        // the scores of the documents which may be among them.
+        kScoringCandidates,
+
+        // 4. Return results to our parent.
         kReturningResults,
 
-        // 4. Finished.
+        // 5. Finished.
         kDone,
     };
 
@@ -82,6 +87,17 @@ public:
 
     void addChild(unique_ptr<PlanStage> child);
 
+    /**
+     * Only return the 'k' documents with the highest scores, along with any documents tied with
+     * them. 'terms' are the query terms scanned by each child, in the order of the children.
+     *
+     * The children are read in turns rather than one after the other. Since each child returns
+     * the keys of its term by descending score, the score of its last key bounds the score any
+     * document can still get from that term, and reading stops once no document left unseen
+     * can make it into the top 'k'. Only valid if the parent doesn't reject any document.
+     */
+    void setTopK(size_t k, std::vector<std::string> terms);
+
     bool isEOF() final;
 
     StageState work(WorkingSetID* out) final;
@@ -121,6 +137,24 @@ private:
      */
     StageState addTerm(WorkingSetID wsid, WorkingSetID* out);
 
+    /**
+     * Helper called from readFromChildren when only the top scores are needed. Moves on to the
+     * next child with keys left, and checks whether reading can stop.
+     */
+    StageState advanceTopK();
+
+    /**
+     * Returns true if the documents which can be among the top 'k' are known, in which case the
+     * other documents are dropped and those whose scores are incomplete are queued in
+     * _candidates.
+     */
+    bool findTopKCandidates();
+
+    /**
+     * Worker for kScoringCandidates. Fetches a candidate and computes its score from the document.
+     */
+    StageState scoreCandidate(WorkingSetID* out);
+
     /**
      * Worker for kReturningResults. Returns a wsm with RecordID and Score.
      */
@@ -144,15 +178,28 @@ private:
      *  Map each buffered record id to this data.
      */
     struct TextRecordData {
-        TextRecordData() : wsid(WorkingSet::INVALID_ID), score(0.0) {}
+        TextRecordData() : wsid(WorkingSet::INVALID_ID), score(0.0), termsSeen(0) {}
         WorkingSetID wsid;
         double score;
+        // Bit i is set if a key was read for this document from child i. Only kept for top-k.
+        uint64_t termsSeen;
     };
 
     typedef unordered_map<RecordId, TextRecordData, RecordId::Hasher> ScoreMap;
     ScoreMap _scores;
     ScoreMap::const_iterator _scoreIterator;
 
+    // Top-k state, see setTopK(). _topK is 0 if every document is scored.
+    size_t _topK = 0;
+    std::vector<std::string> _terms;
+    // The score of the last key read from each child, or 0 if the child is exhausted.
+    std::vector<double> _termMaxScores;
+    std::vector<bool> _termExhausted;
+    size_t _keysSinceTopKCheck = 0;
+    // Documents whose scores must be completed in kScoringCandidates.
+    std::vector<RecordId> _candidates;
+    size_t _nextCandidate = 0;
+
     TextOrStats _specificStats;
 
     // Members needed only for using the TextMatchableDocument.
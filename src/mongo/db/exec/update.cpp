@@ -523,20 +523,21 @@ BSONObj UpdateStage::transformAndUpdate(const Snapshotted<BSONObj>& oldObj, Reco
             // Don't actually do the write if this is an explain.
             if (!request->isExplain()) {
                 invariant(_collection);
-                newObj = oldObj.value();
                 const RecordData oldRec(oldObj.value().objdata(), oldObj.value().objsize());
-                BSONObj idQuery = driver->makeOplogEntryQuery(newObj, request->isMulti());
+                BSONObj idQuery = driver->makeOplogEntryQuery(oldObj.value(), request->isMulti());
                 oplogUpdateEntryArgs args;
                 args.update = logObj;
                 args.criteria = idQuery;
                 args.fromMigrate = request->isFromMigration();
-                _collection->updateDocumentWithDamages(
+                StatusWith<RecordData> newRec = _collection->updateDocumentWithDamages(
                     getOpCtx(),
                     loc,
                     Snapshotted<RecordData>(oldObj.snapshotId(), oldRec),
                     source,
                     _damages,
                     args);
+                uassertStatusOK(newRec.getStatus());
+                newObj = newRec.getValue().releaseToBson();
             }
 
             _specificStats.fastmod = true;
@@ -558,12 +559,16 @@ BSONObj UpdateStage::transformAndUpdate(const Snapshotted<BSONObj>& oldObj, Reco
                 args.update = logObj;
                 args.criteria = idQuery;
                 args.fromMigrate = request->isFromMigration();
+                // A replacement may change any field, so every index must be maintained.
+                const FieldRefSet* indexedUpdatedFields =
+                    driver->isDocReplacement() ? NULL : &updatedFields;
                 StatusWith<RecordId> res = _collection->updateDocument(getOpCtx(),
                                                                        loc,
                                                                        oldObj,
                                                                        newObj,
                                                                        true,
                                                                        driver->modsAffectIndices(),
+                                                                       indexedUpdatedFields,
                                                                        _params.opDebug,
                                                                        args);
                 uassertStatusOK(res.getStatus());
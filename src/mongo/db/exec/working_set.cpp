@@ -40,11 +40,7 @@ WorkingSet::MemberHolder::~MemberHolder() {}
 
 WorkingSet::WorkingSet() : _freeList(INVALID_ID) {}
 
-WorkingSet::~WorkingSet() {
-    for (size_t i = 0; i < _data.size(); i++) {
-        delete _data[i].member;
-    }
-}
+WorkingSet::~WorkingSet() {}
 
 WorkingSetID WorkingSet::allocate() {
     if (_freeList == INVALID_ID) {
@@ -52,9 +48,13 @@ WorkingSetID WorkingSet::allocate() {
         // vector::resize being amortized O(1) for efficient allocation. Note that the free list
         // remains empty until something is returned by a call to free().
         WorkingSetID id = _data.size();
+        const size_t block = id / kMembersPerBlock;
+        if (block == _memberBlocks.size()) {
+            _memberBlocks.emplace_back(new WorkingSetMember[kMembersPerBlock]);
+        }
         _data.resize(_data.size() + 1);
         _data.back().nextFreeOrSelf = id;
-        _data.back().member = new WorkingSetMember();
+        _data.back().member = &_memberBlocks[block][id % kMembersPerBlock];
         return id;
     }
 
@@ -93,7 +93,10 @@ bool WorkingSet::isFlagged(WorkingSetID id) const {
 
 void WorkingSet::clear() {
     for (size_t i = 0; i < _data.size(); i++) {
-        delete _data[i].member;
+        WorkingSetMember* member = _data[i].member;
+        member->clear();
+        member->isSuspicious = false;
+        member->_fetcher.reset();
     }
     _data.clear();
 
@@ -147,6 +150,20 @@ void WorkingSetMember::clear() {
     }
 
     keyData.clear();
+
+    // Hang on to the buffer of an owned object if we were its last owner, so that the next
+    // makeObjOwned() on this member can copy into it instead of allocating.
+    BSONObj& value = obj.value();
+    if (value.isOwned()) {
+        const size_t bytes = value.objsize();
+        const bool startsAtBuffer = value.objdata() == value.sharedBuffer().get();
+        SharedBuffer buffer = value.releaseSharedBuffer();
+        if (startsAtBuffer && !buffer.isShared() && bytes <= kMaxRecycledBufferBytes &&
+            bytes > _recycledBufferBytes) {
+            _recycledBuffer = std::move(buffer);
+            _recycledBufferBytes = bytes;
+        }
+    }
     obj.reset();
     _state = WorkingSetMember::INVALID;
 }
@@ -175,9 +192,21 @@ bool WorkingSetMember::hasOwnedObj() const {
 
 void WorkingSetMember::makeObjOwned() {
     invariant(_state == LOC_AND_OBJ);
-    if (!obj.value().isOwned()) {
-        obj.setValue(obj.value().getOwned());
+    if (obj.value().isOwned()) {
+        return;
     }
+
+    const size_t bytes = obj.value().objsize();
+    if (_recycledBuffer.get() && bytes <= _recycledBufferBytes) {
+        // Nobody else references the recycled buffer, so it is safe to overwrite it.
+        invariant(!_recycledBuffer.isShared());
+        memcpy(_recycledBuffer.get(), obj.value().objdata(), bytes);
+        _recycledBufferBytes = 0;
+        obj.setValue(BSONObj(std::move(_recycledBuffer)));
+        return;
+    }
+
+    obj.setValue(obj.value().getOwned());
 }
 
 bool WorkingSetMember::hasComputed(const WorkingSetComputedDataType type) const {
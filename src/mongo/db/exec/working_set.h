@@ -28,6 +28,7 @@
 
 #pragma once
 
+#include <memory>
 #include <vector>
 #include <unordered_set>
 
@@ -36,6 +37,7 @@
 #include "mongo/db/record_id.h"
 #include "mongo/db/storage/snapshot.h"
 #include "mongo/platform/unordered_set.h"
+#include "mongo/util/shared_buffer.h"
 
 namespace mongo {
 
@@ -113,7 +115,8 @@ public:
     const unordered_set<WorkingSetID>& getFlagged() const;
 
     /**
-     * Removes and deallocates all members of this working set.
+     * Removes all members of this working set. The memory backing the members is kept so that
+     * it can be reused by subsequent calls to allocate().
      */
     void clear();
 
@@ -151,10 +154,18 @@ private:
         WorkingSetMember* member;
     };
 
+    // WorkingSetMembers are carved out of blocks of this many members rather than allocated
+    // one at a time. Member 'i' lives at slot i % kMembersPerBlock of block i / kMembersPerBlock.
+    static const size_t kMembersPerBlock = 64;
+
     // All WorkingSetIDs are indexes into this, except for INVALID_ID.
     // Elements are added to _freeList rather than removed when freed.
     std::vector<MemberHolder> _data;
 
+    // Owns the memory for every member ever handed out by this working set. Survives clear() so
+    // that members, and the buffers they have cached, are recycled across plan runs.
+    std::vector<std::unique_ptr<WorkingSetMember[]>> _memberBlocks;
+
     // Index into _data, forming a linked-list using MemberHolder::nextFreeOrSelf as the next
     // link. INVALID_ID is the list terminator since 0 is a valid index.
     // If _freeList == INVALID_ID, the free list is empty and all elements in _data are in use.
@@ -290,6 +301,9 @@ public:
     /**
      * Ensures that 'obj' is owned BSON. Only valid to call on a working set member in LOC_AND_OBJ
      * state. No-op if 'obj' is already owned.
+     *
+     * The copy reuses the buffer of a previously held owned object when this member was its
+     * only remaining owner and it is large enough, avoiding an allocation per document.
      */
     void makeObjOwned();
 
@@ -334,6 +348,14 @@ private:
     std::unique_ptr<WorkingSetComputedData> _computed[WSM_COMPUTED_NUM_TYPES];
 
     std::unique_ptr<RecordFetcher> _fetcher;
+
+    // Buffers larger than this are released rather than cached for reuse.
+    static const size_t kMaxRecycledBufferBytes = 16 * 1024;
+
+    // The buffer of an owned object that this member used to hold and no one else references.
+    // '_recycledBufferBytes' is the number of usable data bytes in '_recycledBuffer'.
+    SharedBuffer _recycledBuffer;
+    size_t _recycledBufferBytes = 0;
 };
 
 }  // namespace mongo
@@ -154,4 +154,63 @@ TEST_F(WorkingSetFixture, getDottedFieldFromIndex) {
     ASSERT_FALSE(member->getFieldDotted("y", &elt));
 }
 
+TEST_F(WorkingSetFixture, makeObjOwnedReusesUnsharedBuffer) {
+    BSONObj first = BSON("x" << 1 << "y" << 2);
+    ws->transitionToLocAndObj(id);
+    member->obj = Snapshotted<BSONObj>(SnapshotId(), BSONObj(first.objdata()));
+    member->makeObjOwned();
+    const char* ownedData = member->obj.value().objdata();
+    ws->free(id);
+
+    // The freed member is handed out again; its old buffer should back the next owned copy.
+    BSONObj second = BSON("x" << 3);
+    WorkingSetID newId = ws->allocate();
+    ASSERT_EQUALS(id, newId);
+    ws->transitionToLocAndObj(newId);
+    member->obj = Snapshotted<BSONObj>(SnapshotId(), BSONObj(second.objdata()));
+    member->makeObjOwned();
+    ASSERT_TRUE(member->obj.value().isOwned());
+    ASSERT_EQUALS(ownedData, member->obj.value().objdata());
+    ASSERT_EQUALS(second, member->obj.value());
+}
+
+TEST_F(WorkingSetFixture, makeObjOwnedDoesNotReuseSharedBuffer) {
+    BSONObj first = BSON("x" << 1 << "y" << 2);
+    ws->transitionToLocAndObj(id);
+    member->obj = Snapshotted<BSONObj>(SnapshotId(), BSONObj(first.objdata()));
+    member->makeObjOwned();
+
+    // Someone else still references the owned copy, so it must not be overwritten.
+    BSONObj escaped = member->obj.value();
+    ws->free(id);
+
+    BSONObj second = BSON("x" << 3);
+    WorkingSetID newId = ws->allocate();
+    ws->transitionToLocAndObj(newId);
+    member->obj = Snapshotted<BSONObj>(SnapshotId(), BSONObj(second.objdata()));
+    member->makeObjOwned();
+    ASSERT_NOT_EQUALS(escaped.objdata(), member->obj.value().objdata());
+    ASSERT_EQUALS(first, escaped);
+    ASSERT_EQUALS(second, member->obj.value());
+}
+
+TEST_F(WorkingSetFixture, clearResetsMembers) {
+    for (int i = 0; i < 100; ++i) {
+        WorkingSetID newId = ws->allocate();
+        ws->get(newId)->obj = Snapshotted<BSONObj>(SnapshotId(), BSON("x" << i));
+        ws->transitionToOwnedObj(newId);
+    }
+
+    ws->clear();
+
+    // Ids are handed out from zero again and members come back in the initial state.
+    for (int i = 0; i < 101; ++i) {
+        WorkingSetID newId = ws->allocate();
+        ASSERT_EQUALS(WorkingSetID(i), newId);
+        ASSERT_EQUALS(WorkingSetMember::INVALID, ws->get(newId)->getState());
+        ASSERT_TRUE(ws->get(newId)->obj.value().isEmpty());
+        ASSERT_FALSE(ws->get(newId)->isSuspicious);
+    }
+}
+
 }  // namespace
@@ -30,6 +30,9 @@
 
 #include "mongo/db/fts/fts_unicode_tokenizer.h"
 
+#include <cstdint>
+#include <cstring>
+
 #include "mongo/db/fts/fts_query.h"
 #include "mongo/db/fts/fts_spec.h"
 #include "mongo/db/fts/stemmer.h"
@@ -44,8 +47,86 @@ namespace fts {
 
 using std::string;
 
+namespace {
+
+/**
+ * The properties of each ASCII character that tokenizing depends on, as computed by the codepoint
+ * functions for the general path.
+ */
+class AsciiTables {
+public:
+    AsciiTables() {
+        for (char32_t c = 0; c < 128; ++c) {
+            _isDelimiter[0][c] =
+                unicode::codepointIsDelimiter(c, unicode::DelimiterListLanguage::kEnglish);
+            _isDelimiter[1][c] =
+                unicode::codepointIsDelimiter(c, unicode::DelimiterListLanguage::kNotEnglish);
+            _isDiacritic[c] = unicode::codepointIsDiacritic(c);
+
+            char32_t lower = unicode::codepointToLower(c, unicode::CaseFoldMode::kNormal);
+            char32_t noDiacritics = unicode::codepointRemoveDiacritics(c);
+            invariant(lower < 128 && noDiacritics < 128);
+            _toLower[c] = static_cast<char>(lower);
+            _removeDiacritics[c] = static_cast<char>(noDiacritics);
+        }
+    }
+
+    bool isDelimiter(char c, unicode::DelimiterListLanguage lang) const {
+        return _isDelimiter[lang == unicode::DelimiterListLanguage::kEnglish ? 0 : 1][int(c)];
+    }
+
+    bool isDiacritic(char c) const {
+        return _isDiacritic[int(c)];
+    }
+
+    char toLower(char c) const {
+        return _toLower[int(c)];
+    }
+
+    char removeDiacritics(char c) const {
+        return _removeDiacritics[int(c)];
+    }
+
+private:
+    bool _isDelimiter[2][128];
+    bool _isDiacritic[128];
+    char _toLower[128];
+    char _removeDiacritics[128];
+};
+
+const AsciiTables asciiTables;
+
+/**
+ * Returns whether 'str' consists only of ASCII characters, checking eight bytes at a time.
+ */
+bool isAscii(StringData str) {
+    const char* data = str.rawData();
+    const size_t size = str.size();
+    const uint64_t highBits = 0x8080808080808080ULL;
+
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+        uint64_t chunk;
+        std::memcpy(&chunk, data + i, sizeof(chunk));
+        if (chunk & highBits) {
+            return false;
+        }
+    }
+    for (; i < size; ++i) {
+        if (static_cast<unsigned char>(data[i]) & 0x80) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
 UnicodeFTSTokenizer::UnicodeFTSTokenizer(const FTSLanguage* language)
-    : _language(language), _stemmer(language), _stopWords(StopWords::getStopWords(language)) {
+    : _language(language),
+      _stemmer(language),
+      _stopWords(StopWords::getStopWords(language)),
+      _isAscii(false) {
     if (_language->str() == "english") {
         _delimListLanguage = unicode::DelimiterListLanguage::kEnglish;
     } else {
@@ -62,6 +143,20 @@ UnicodeFTSTokenizer::UnicodeFTSTokenizer(const FTSLanguage* language)
 void UnicodeFTSTokenizer::reset(StringData document, Options options) {
     _options = options;
     _pos = 0;
+
+    // Turkish case folding maps the ASCII letter I outside of ASCII, so Turkish documents always
+    // take the general path.
+    _isAscii = _caseFoldMode == unicode::CaseFoldMode::kNormal && isAscii(document);
+    if (_isAscii) {
+        _asciiDocument.assign(document.rawData(), document.size());
+
+        // Like the UTF-8 decoding of the general path, stop at the first null character.
+        _asciiDocument.resize(std::strlen(_asciiDocument.c_str()));
+
+        _skipAsciiDelimiters();
+        return;
+    }
+
     _document = unicode::String(document);
 
     // Skip any leading delimiters (and handle the case where the document is entirely delimiters).
@@ -69,6 +164,10 @@ void UnicodeFTSTokenizer::reset(StringData document, Options options) {
 }
 
 bool UnicodeFTSTokenizer::moveNext() {
+    if (_isAscii) {
+        return _moveNextAscii();
+    }
+
     while (true) {
         if (_pos >= _document.size()) {
             _stem = "";
@@ -110,6 +209,62 @@ bool UnicodeFTSTokenizer::moveNext() {
     }
 }
 
+bool UnicodeFTSTokenizer::_moveNextAscii() {
+    while (true) {
+        if (_pos >= _asciiDocument.size()) {
+            _stem = "";
+            return false;
+        }
+
+        size_t start = _pos++;
+        while (_pos < _asciiDocument.size() &&
+               !asciiTables.isDelimiter(_asciiDocument[_pos], _delimListLanguage)) {
+            ++_pos;
+        }
+        StringData token(_asciiDocument.data() + start, _pos - start);
+
+        _skipAsciiDelimiters();
+
+        _word.resize(token.size());
+        for (size_t i = 0; i < token.size(); ++i) {
+            _word[i] = asciiTables.toLower(token[i]);
+        }
+
+        if ((_options & kFilterStopWords) && _stopWords->isStopWord(_word)) {
+            continue;
+        }
+
+        if (_options & kGenerateCaseSensitiveTokens) {
+            _word.assign(token.rawData(), token.size());
+        }
+
+        _stem = _stemmer.stem(_word);
+
+        if (!(_options & kGenerateDiacriticSensitiveTokens)) {
+            if (isAscii(_stem)) {
+                size_t length = 0;
+                for (char c : _stem) {
+                    if (!asciiTables.isDiacritic(c)) {
+                        _stem[length++] = asciiTables.removeDiacritics(c);
+                    }
+                }
+                _stem.resize(length);
+            } else {
+                _stem = unicode::String(_stem).removeDiacritics().toString();
+            }
+        }
+
+        return true;
+    }
+}
+
+void UnicodeFTSTokenizer::_skipAsciiDelimiters() {
+    while (_pos < _asciiDocument.size() &&
+           asciiTables.isDelimiter(_asciiDocument[_pos], _delimListLanguage)) {
+        ++_pos;
+    }
+}
+
 StringData UnicodeFTSTokenizer::get() const {
     return _stem;
 }
@@ -53,6 +53,9 @@ class StopWords;
  *
  * For each word returns a stem version of a word optimized for full text indexing.
  * Optionally supports returning case sensitive search terms.
+ *
+ * Documents made up entirely of ASCII characters are tokenized directly on their bytes, without
+ * decoding them to UTF-32, and produce the same tokens as the general path.
  */
 class UnicodeFTSTokenizer final : public FTSTokenizer {
     MONGO_DISALLOW_COPYING(UnicodeFTSTokenizer);
@@ -73,6 +76,13 @@ private:
      */
     void _skipDelimiters();
 
+    /**
+     * The ASCII-only equivalents of moveNext() and _skipDelimiters(), which operate on
+     * _asciiDocument rather than _document.
+     */
+    bool _moveNextAscii();
+    void _skipAsciiDelimiters();
+
     unicode::DelimiterListLanguage _delimListLanguage;
     unicode::CaseFoldMode _caseFoldMode;
 
@@ -83,6 +93,12 @@ private:
     unicode::String _document;
     size_t _pos;
 
+    // Whether the current document is tokenized by the ASCII fast path, in which case it is held
+    // in _asciiDocument instead of _document.
+    bool _isAscii;
+    std::string _asciiDocument;
+    std::string _word;
+
     Options _options;
 
     std::string _stem;
@@ -240,5 +240,27 @@ TEST(FtsUnicodeTokenizer, FrenchStopWordsAndDiacriticSensitive) {
     ASSERT_EQUALS("excit", terms[4]);
 }
 
+// Ensure that ASCII documents, which are tokenized without decoding them, produce the same tokens
+// as when they are part of a document that also contains non-ASCII characters.
+TEST(FtsUnicodeTokenizer, AsciiMatchesNonAscii) {
+    const char* asciiDocument =
+        "  The QUICK brown fox's Running,jumping--and_LEAPING over`the ^lazy^ dogs' 42 Kennels! ";
+    const std::string mixedDocument = std::string(asciiDocument) + " cr\xc3\xa8me";
+
+    for (const char* language : {"english", "french", "german", "none"}) {
+        for (FTSTokenizer::Options options = 0; options < 8; ++options) {
+            std::vector<std::string> asciiTerms = tokenizeString(asciiDocument, language, options);
+            std::vector<std::string> mixedTerms =
+                tokenizeString(mixedDocument.c_str(), language, options);
+
+            ASSERT_FALSE(asciiTerms.empty());
+            ASSERT_EQUALS(asciiTerms.size() + 1, mixedTerms.size());
+            for (size_t i = 0; i < asciiTerms.size(); ++i) {
+                ASSERT_EQUALS(asciiTerms[i], mixedTerms[i]);
+            }
+        }
+    }
+}
+
 }  // namespace fts
 }  // namespace mongo
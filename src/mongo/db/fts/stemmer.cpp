@@ -28,11 +28,15 @@
 *    it in the license file.
 */
 
+#include <boost/thread/tss.hpp>
 #include <cstdlib>
+#include <memory>
 #include <string>
 
 #include "mongo/db/fts/stemmer.h"
+#include "mongo/util/assert_util.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/string_map.h"
 
 namespace mongo {
 
@@ -40,32 +44,82 @@ namespace fts {
 
 using std::string;
 
-Stemmer::Stemmer(const FTSLanguage* language) {
-    _stemmer = NULL;
-    if (language->str() != "none")
-        _stemmer = sb_stemmer_new(language->str().c_str(), "UTF_8");
-}
+namespace {
+
+/**
+ * A libstemmer instance for one language, and the stems it recently produced. Only ever used by
+ * the thread that created it, since libstemmer instances are not thread safe.
+ */
+class LanguageStemmer {
+    MONGO_DISALLOW_COPYING(LanguageStemmer);
 
-Stemmer::~Stemmer() {
-    if (_stemmer) {
-        sb_stemmer_delete(_stemmer);
-        _stemmer = NULL;
+public:
+    explicit LanguageStemmer(const string& language)
+        : _stemmer(sb_stemmer_new(language.c_str(), "UTF_8")) {}
+
+    ~LanguageStemmer() {
+        if (_stemmer) {
+            sb_stemmer_delete(_stemmer);
+        }
     }
-}
 
-string Stemmer::stem(StringData word) const {
-    if (!_stemmer)
-        return word.toString();
+    string stem(StringData word) {
+        if (!_stemmer)
+            return word.toString();
+
+        StringMap<string>::const_iterator it = _stems.find(word);
+        if (it != _stems.end())
+            return it->second;
+
+        const sb_symbol* sb_sym =
+            sb_stemmer_stem(_stemmer, (const sb_symbol*)word.rawData(), word.size());
 
-    const sb_symbol* sb_sym =
-        sb_stemmer_stem(_stemmer, (const sb_symbol*)word.rawData(), word.size());
+        if (sb_sym == NULL) {
+            // out of memory
+            invariant(false);
+        }
 
-    if (sb_sym == NULL) {
-        // out of memory
-        invariant(false);
+        string stemmed((const char*)(sb_sym), sb_stemmer_length(_stemmer));
+
+        if (_stems.size() >= Stemmer::kMaxCachedStems)
+            _stems = StringMap<string>();
+        _stems[word] = stemmed;
+        return stemmed;
     }
 
-    return string((const char*)(sb_sym), sb_stemmer_length(_stemmer));
+private:
+    struct sb_stemmer* const _stemmer;
+    StringMap<string> _stems;
+};
+
+typedef StringMap<std::shared_ptr<LanguageStemmer>> LanguageStemmerMap;
+
+boost::thread_specific_ptr<LanguageStemmerMap> threadStemmers;
+
+LanguageStemmer* getLanguageStemmer(const FTSLanguage* language) {
+    LanguageStemmerMap* stemmers = threadStemmers.get();
+    if (!stemmers) {
+        stemmers = new LanguageStemmerMap();
+        threadStemmers.reset(stemmers);
+    }
+
+    std::shared_ptr<LanguageStemmer>& stemmer = (*stemmers)[language->str()];
+    if (!stemmer)
+        stemmer = std::make_shared<LanguageStemmer>(language->str());
+    return stemmer.get();
+}
+
+}  // namespace
+
+Stemmer::Stemmer(const FTSLanguage* language) : _language(language) {}
+
+Stemmer::~Stemmer() {}
+
+string Stemmer::stem(StringData word) const {
+    if (_language->str() == "none")
+        return word.toString();
+
+    return getLanguageStemmer(_language)->stem(word);
 }
 }
 }
@@ -45,18 +45,28 @@ namespace fts {
  * maintains case
  * but works
  * running/Running -> run/Run
+ *
+ * The underlying libstemmer instances are kept per thread and per language, along with a bounded
+ * cache of recent stems, so constructing a Stemmer is cheap and stemming a word seen recently on
+ * the same thread does not call into libstemmer.
  */
 class Stemmer {
     MONGO_DISALLOW_COPYING(Stemmer);
 
 public:
+    /**
+     * Maximum number of stems cached per thread for each language. The cache is emptied when it
+     * fills up.
+     */
+    static const size_t kMaxCachedStems = 10000;
+
     Stemmer(const FTSLanguage* language);
     ~Stemmer();
 
     std::string stem(StringData word) const;
 
 private:
-    struct sb_stemmer* _stemmer;
+    const FTSLanguage* const _language;
 };
 }
 }
@@ -33,6 +33,8 @@
 
 #include "mongo/db/fts/fts_spec.h"
 #include "mongo/db/fts/stemmer.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/util/mongoutils/str.h"
 
 namespace mongo {
 namespace fts {
@@ -48,5 +50,21 @@ TEST(English, Caps) {
     ASSERT_EQUALS("unit", s.stem("united"));
     ASSERT_EQUALS("Unite", s.stem("United"));
 }
+
+// Stems are cached per thread, and the caches are emptied once full.
+TEST(English, CachedStems) {
+    Stemmer s(&languageEnglishV2);
+    for (size_t i = 0; i < Stemmer::kMaxCachedStems + 10; ++i) {
+        const std::string word = str::stream() << "run" << i;
+        ASSERT_EQUALS(word, s.stem(word));
+        ASSERT_EQUALS("run", s.stem("running"));
+    }
+
+    std::string otherThreadStem;
+    stdx::thread otherThread(
+        [&] { otherThreadStem = Stemmer(&languageEnglishV2).stem("running"); });
+    otherThread.join();
+    ASSERT_EQUALS("run", otherThreadStem);
+}
 }
 }
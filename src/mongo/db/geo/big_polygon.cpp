@@ -58,6 +58,10 @@ double BigSimplePolygon::GetArea() const {
     return _loop->GetArea();
 }
 
+int BigSimplePolygon::NumVertices() const {
+    return _loop->num_vertices();
+}
+
 bool BigSimplePolygon::Contains(const S2Polygon& polygon) const {
     const S2Polygon& polyBorder = GetPolygonBorder();
 
@@ -58,6 +58,8 @@ public:
 
     double GetArea() const;
 
+    int NumVertices() const;
+
     bool Contains(const S2Polygon& polygon) const;
 
     bool Contains(const S2Polyline& line) const;
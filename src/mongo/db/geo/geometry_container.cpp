@@ -31,6 +31,9 @@
 #include "mongo/db/geo/geoconstants.h"
 #include "mongo/db/geo/geoparser.h"
 #include "mongo/util/mongoutils/str.h"
+#include "third_party/s2/s2.h"
+#include "third_party/s2/s2cap.h"
+#include "third_party/s2/s2regioncoverer.h"
 
 namespace mongo {
 
@@ -80,6 +83,138 @@ const S2Region& GeometryContainer::getS2Region() const {
     }
 }
 
+std::vector<S2CellId> GeometryContainer::getS2Covering(int minLevel,
+                                                       int maxLevel,
+                                                       int maxCells) const {
+    stdx::lock_guard<stdx::mutex> lock(_s2CoveringMutex);
+    if (minLevel != _s2CoveringMinLevel || maxLevel != _s2CoveringMaxLevel ||
+        maxCells != _s2CoveringMaxCells) {
+        S2RegionCoverer coverer;
+        coverer.set_min_level(minLevel);
+        coverer.set_max_level(maxLevel);
+        coverer.set_max_cells(maxCells);
+
+        _s2Covering.clear();
+        coverer.GetCovering(getS2Region(), &_s2Covering);
+        _s2CoveringMinLevel = minLevel;
+        _s2CoveringMaxLevel = maxLevel;
+        _s2CoveringMaxCells = maxCells;
+    }
+    return _s2Covering;
+}
+
+// Bound the work of computing an interior covering, and the size of the result. Interior cells
+// are at most kInteriorCoveringMaxLevelsBelowSize levels finer than the geometry's own size:
+// finer cells add little area but make the coverer test many more cells along the edges.
+static const int kInteriorCoveringMaxCells = 64;
+static const int kInteriorCoveringMaxLevelsBelowSize = 5;
+
+void GeometryContainer::computeS2InteriorCovering() {
+    // Only polygons and caps have an interior. Geometry collections are left out, as contains()
+    // only considers their polygons while their region includes the cells of their points.
+    bool hasInterior = (NULL != _polygon && FLAT != _polygon->crs) ||
+        (NULL != _cap && SPHERE == _cap->crs) || NULL != _multiPolygon;
+    if (!hasInterior) {
+        return;
+    }
+
+    const S2Region& region = getS2Region();
+    int sizeLevel = S2::kAvgEdge.GetClosestLevel(2 * region.GetCapBound().angle().radians());
+    int maxLevel = sizeLevel + kInteriorCoveringMaxLevelsBelowSize;
+
+    S2RegionCoverer coverer;
+    coverer.set_max_level(maxLevel < S2CellId::kMaxLevel ? maxLevel : S2CellId::kMaxLevel);
+    coverer.set_max_cells(kInteriorCoveringMaxCells);
+    _s2InteriorCovering.reset(new S2CellUnion());
+    coverer.GetInteriorCellUnion(region, _s2InteriorCovering.get());
+}
+
+// A vertex costs its S2Point, an entry in its loop's vertex map and a few entries in the edge
+// index of its loop or polyline. Both indexes are built lazily by repeated queries.
+static const size_t kApproximateBytesPerVertex = 192;
+
+static size_t vertexCount(const S2Polygon& polygon) {
+    return polygon.num_vertices();
+}
+
+static size_t vertexCount(const S2Polyline& line) {
+    return line.num_vertices();
+}
+
+template <typename Shape>
+static size_t vertexCount(const std::vector<Shape*>& shapes) {
+    size_t count = 0;
+    for (size_t i = 0; i < shapes.size(); ++i) {
+        count += vertexCount(*shapes[i]);
+    }
+    return count;
+}
+
+static size_t vertexCount(const LineWithCRS& line) {
+    return vertexCount(line.line);
+}
+
+static size_t vertexCount(const PolygonWithCRS& polygon) {
+    size_t count = polygon.oldPolygon.size();
+    if (NULL != polygon.s2Polygon) {
+        count += vertexCount(*polygon.s2Polygon);
+    }
+    if (NULL != polygon.bigPolygon) {
+        // The loop, and the border polygon and line built from it, each hold every vertex.
+        count += 3 * polygon.bigPolygon->NumVertices();
+    }
+    return count;
+}
+
+static size_t vertexCount(const MultiPointWithCRS& multiPoint) {
+    return multiPoint.points.size();
+}
+
+static size_t vertexCount(const MultiLineWithCRS& multiLine) {
+    return vertexCount(multiLine.lines.vector());
+}
+
+static size_t vertexCount(const MultiPolygonWithCRS& multiPolygon) {
+    return vertexCount(multiPolygon.polygons.vector());
+}
+
+size_t GeometryContainer::getApproximateSize() const {
+    size_t vertices = 0;
+    if (NULL != _point || NULL != _cap) {
+        vertices = 1;
+    } else if (NULL != _box) {
+        vertices = 4;
+    } else if (NULL != _line) {
+        vertices = vertexCount(*_line);
+    } else if (NULL != _polygon) {
+        vertices = vertexCount(*_polygon);
+    } else if (NULL != _multiPoint) {
+        vertices = vertexCount(*_multiPoint);
+    } else if (NULL != _multiLine) {
+        vertices = vertexCount(*_multiLine);
+    } else if (NULL != _multiPolygon) {
+        vertices = vertexCount(*_multiPolygon);
+    } else if (NULL != _geometryCollection) {
+        vertices = _geometryCollection->points.size() +
+            vertexCount(_geometryCollection->lines.vector()) +
+            vertexCount(_geometryCollection->polygons.vector()) +
+            vertexCount(_geometryCollection->multiPoints.vector()) +
+            vertexCount(_geometryCollection->multiLines.vector()) +
+            vertexCount(_geometryCollection->multiPolygons.vector());
+    }
+
+    size_t size = sizeof(GeometryContainer) + vertices * kApproximateBytesPerVertex;
+    if (NULL != _s2InteriorCovering) {
+        size += _s2InteriorCovering->num_cells() * sizeof(S2CellId);
+    }
+    stdx::lock_guard<stdx::mutex> lock(_s2CoveringMutex);
+    return size + _s2Covering.capacity() * sizeof(S2CellId);
+}
+
+bool GeometryContainer::containsInInterior(const S2Point& otherPoint) const {
+    return NULL != _s2InteriorCovering && _s2InteriorCovering->Contains(otherPoint);
+}
+
 bool GeometryContainer::hasR2Region() const {
     return _cap || _box || _point || (_polygon && _polygon->crs == FLAT) ||
         (_multiPoint && FLAT == _multiPoint->crs);
@@ -261,7 +396,8 @@ bool GeometryContainer::contains(const GeometryContainer& otherContainer) const
 
     // Iterate over the other thing and see if we contain it all.
     if (NULL != otherContainer._point) {
-        return contains(otherContainer._point->cell, otherContainer._point->point);
+        return containsInInterior(otherContainer._point->point) ||
+            contains(otherContainer._point->cell, otherContainer._point->point);
     }
 
     if (NULL != otherContainer._line) {
@@ -275,7 +411,8 @@ bool GeometryContainer::contains(const GeometryContainer& otherContainer) const
 
     if (NULL != otherContainer._multiPoint) {
         for (size_t i = 0; i < otherContainer._multiPoint->points.size(); ++i) {
-            if (!contains(otherContainer._multiPoint->cells[i],
+            if (!containsInInterior(otherContainer._multiPoint->points[i]) &&
+                !contains(otherContainer._multiPoint->cells[i],
                           otherContainer._multiPoint->points[i])) {
                 return false;
             }
@@ -525,7 +662,8 @@ bool GeometryContainer::contains(const S2Polygon& otherPolygon) const {
 
 bool GeometryContainer::intersects(const GeometryContainer& otherContainer) const {
     if (NULL != otherContainer._point) {
-        return intersects(otherContainer._point->cell);
+        return containsInInterior(otherContainer._point->point) ||
+            intersects(otherContainer._point->cell);
     } else if (NULL != otherContainer._line) {
         return intersects(otherContainer._line->line);
     } else if (NULL != otherContainer._polygon) {
@@ -29,9 +29,13 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 #include "mongo/base/disallow_copying.h"
 #include "mongo/db/geo/shapes.h"
+#include "mongo/stdx/mutex.h"
+#include "third_party/s2/s2cellid.h"
+#include "third_party/s2/s2cellunion.h"
 #include "third_party/s2/s2regionunion.h"
 
 namespace mongo {
@@ -112,6 +116,26 @@ public:
     bool hasS2Region() const;
     const S2Region& getS2Region() const;
 
+    /**
+     * Returns a covering of the S2 region built with the given coverer parameters. The last
+     * covering built is memoized, since a query geometry shared through the geometry cache is
+     * covered again by every query using it.
+     */
+    std::vector<S2CellId> getS2Covering(int minLevel, int maxLevel, int maxCells) const;
+
+    /**
+     * Computes the cells lying entirely inside this geometry. Once computed, contains() and
+     * intersects() accept points inside those cells without an exact test. Only worthwhile for
+     * geometries matched against many documents; does nothing for geometries without area.
+     */
+    void computeS2InteriorCovering();
+
+    /**
+     * Returns the approximate number of bytes held by this geometry and its coverings, including
+     * the edge indexes S2 builds once the geometry is matched against many documents.
+     */
+    size_t getApproximateSize() const;
+
     // Region which can be used to generate a covering of the query object in euclidean space.
     bool hasR2Region() const;
     const R2Region& getR2Region() const;
@@ -140,6 +164,7 @@ private:
     // Used when 'this' has a polygon somewhere, either in _polygon or _multiPolygon or
     // _geometryCollection.
     bool contains(const S2Cell& otherCell, const S2Point& otherPoint) const;
+    bool containsInInterior(const S2Point& otherPoint) const;
     bool contains(const S2Polyline& otherLine) const;
     bool contains(const S2Polygon& otherPolygon) const;
 
@@ -160,6 +185,16 @@ private:
     // TODO: _s2Region is currently generated immediately - don't necessarily need to do this
     std::unique_ptr<S2RegionUnion> _s2Region;
     std::unique_ptr<R2Region> _r2Region;
+
+    // Cells entirely inside the geometry, see computeS2InteriorCovering().
+    std::unique_ptr<S2CellUnion> _s2InteriorCovering;
+
+    // The last covering returned by getS2Covering() and the parameters it was built with.
+    mutable stdx::mutex _s2CoveringMutex;
+    mutable std::vector<S2CellId> _s2Covering;
+    mutable int _s2CoveringMinLevel = -1;
+    mutable int _s2CoveringMaxLevel = -1;
+    mutable int _s2CoveringMaxCells = -1;
 };
 
 }  // namespace mongo
@@ -36,6 +36,7 @@
 
 #include "mongo/base/error_codes.h"
 #include "mongo/base/status.h"
+#include "mongo/bson/key_shape_comparator.h"
 #include "mongo/db/client.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/curop.h"
@@ -65,15 +66,21 @@ int oldCompare(const BSONObj& l, const BSONObj& r, const Ordering& o);
 
 class BtreeExternalSortComparison {
 public:
-    BtreeExternalSortComparison(const BSONObj& ordering, int version)
-        : _ordering(Ordering::make(ordering)), _version(version) {
+    /**
+     * Keys of the same shape as 'sampleKey', which is usually the first key inserted, are
+     * compared fastest.
+     */
+    BtreeExternalSortComparison(const BSONObj& ordering, int version, const BSONObj& sampleKey)
+        : _ordering(Ordering::make(ordering)),
+          _keyComparator(_ordering, sampleKey),
+          _version(version) {
         invariant(version == 1 || version == 0);
     }
 
     typedef std::pair<BSONObj, RecordId> Data;
 
     int operator()(const Data& l, const Data& r) const {
-        int x = (_version == 1 ? l.first.woCompare(r.first, _ordering, /*considerfieldname*/ false)
+        int x = (_version == 1 ? _keyComparator.compare(l.first, r.first)
                                : oldCompare(l.first, r.first, _ordering));
         if (x) {
             return x;
@@ -83,6 +90,7 @@ public:
 
 private:
     const Ordering _ordering;
+    const KeyShapeComparator _keyComparator;  // Compares keys like woCompare() for version 1.
     const int _version;
 };
 
@@ -186,23 +194,38 @@ Status IndexAccessMethod::remove(OperationContext* txn,
     return Status::OK();
 }
 
-// Return keys in l that are not in r.
-// Lifted basically verbatim from elsewhere.
-static void setDifference(const BSONObjSet& l, const BSONObjSet& r, vector<BSONObj*>* diff) {
-    // l and r must use the same ordering spec.
-    verify(l.key_comp().order() == r.key_comp().order());
-    BSONObjSet::const_iterator i = l.begin();
-    BSONObjSet::const_iterator j = r.begin();
-    while (1) {
-        if (i == l.end())
-            break;
-        while (j != r.end() && j->woCompare(*i) < 0)
-            j++;
-        if (j == r.end() || i->woCompare(*j) != 0) {
-            const BSONObj* jo = &*i;
-            diff->push_back((BSONObj*)jo);
+// Fill 'removed' with the keys in 'oldKeys' that are not in 'newKeys', and 'added' with the keys
+// in 'newKeys' that are not in 'oldKeys'. Both sets are ordered the same way, so both differences
+// come out of a single merge over them, with one comparison per step. This keeps updates to
+// documents with large indexed arrays linear in the number of keys.
+static void sortedKeyDifferences(const BSONObjSet& oldKeys,
+                                 const BSONObjSet& newKeys,
+                                 vector<BSONObj*>* removed,
+                                 vector<BSONObj*>* added) {
+    // oldKeys and newKeys must use the same ordering spec.
+    const BSONObj order = oldKeys.key_comp().order();
+    verify(order == newKeys.key_comp().order());
+
+    BSONObjSet::const_iterator i = oldKeys.begin();
+    BSONObjSet::const_iterator j = newKeys.begin();
+    while (i != oldKeys.end() && j != newKeys.end()) {
+        const int cmp = i->woCompare(*j, order);
+        if (cmp < 0) {
+            removed->push_back(const_cast<BSONObj*>(&*i));
+            ++i;
+        } else if (cmp > 0) {
+            added->push_back(const_cast<BSONObj*>(&*j));
+            ++j;
+        } else {
+            ++i;
+            ++j;
         }
-        i++;
+    }
+    for (; i != oldKeys.end(); ++i) {
+        removed->push_back(const_cast<BSONObj*>(&*i));
+    }
+    for (; j != newKeys.end(); ++j) {
+        added->push_back(const_cast<BSONObj*>(&*j));
     }
 }
 
@@ -277,8 +300,7 @@ Status IndexAccessMethod::validateUpdate(OperationContext* txn,
     ticket->loc = record;
     ticket->dupsAllowed = options.dupsAllowed;
 
-    setDifference(ticket->oldKeys, ticket->newKeys, &ticket->removed);
-    setDifference(ticket->newKeys, ticket->oldKeys, &ticket->added);
+    sortedKeyDifferences(ticket->oldKeys, ticket->newKeys, &ticket->removed, &ticket->added);
 
     ticket->_isValid = true;
 
@@ -324,13 +346,17 @@ std::unique_ptr<IndexAccessMethod::BulkBuilder> IndexAccessMethod::initiateBulk(
 
 IndexAccessMethod::BulkBuilder::BulkBuilder(const IndexAccessMethod* index,
                                             const IndexDescriptor* descriptor)
-    : _sorter(Sorter::make(
-          SortOptions()
-              .TempDir(storageGlobalParams.dbpath + "/_tmp")
-              .ExtSortAllowed()
-              .MaxMemoryUsageBytes(100 * 1024 * 1024),
-          BtreeExternalSortComparison(descriptor->keyPattern(), descriptor->version()))),
-      _real(index) {}
+    : _real(index), _descriptor(descriptor) {}
+
+void IndexAccessMethod::BulkBuilder::makeSorter(const BSONObj& sampleKey) {
+    invariant(!_sorter);
+    _sorter.reset(Sorter::make(
+        SortOptions()
+            .TempDir(storageGlobalParams.dbpath + "/_tmp")
+            .ExtSortAllowed()
+            .MaxMemoryUsageBytes(100 * 1024 * 1024),
+        BtreeExternalSortComparison(_descriptor->keyPattern(), _descriptor->version(), sampleKey)));
+}
 
 Status IndexAccessMethod::BulkBuilder::insert(OperationContext* txn,
                                               const BSONObj& obj,
@@ -343,6 +369,9 @@ Status IndexAccessMethod::BulkBuilder::insert(OperationContext* txn,
     _isMultiKey = _isMultiKey || (keys.size() > 1);
 
     for (BSONObjSet::iterator it = keys.begin(); it != keys.end(); ++it) {
+        if (!_sorter) {
+            makeSorter(*it);
+        }
         _sorter->add(*it, loc);
         _keysInserted++;
     }
@@ -362,6 +391,10 @@ Status IndexAccessMethod::commitBulk(OperationContext* txn,
                                      set<RecordId>* dupsToDrop) {
     Timer timer;
 
+    if (!bulk->_sorter) {
+        // Nothing was inserted.
+        bulk->makeSorter(BSONObj());
+    }
     std::unique_ptr<BulkBuilder::Sorter::Iterator> i(bulk->_sorter->done());
 
     stdx::unique_lock<Client> lk(*txn->getClient());
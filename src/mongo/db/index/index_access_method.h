@@ -200,8 +200,15 @@ public:
 
         BulkBuilder(const IndexAccessMethod* index, const IndexDescriptor* descriptor);
 
+        /**
+         * Makes '_sorter', which compares keys of the same shape as 'sampleKey' fastest. Called
+         * with the first key inserted.
+         */
+        void makeSorter(const BSONObj& sampleKey);
+
         std::unique_ptr<Sorter> _sorter;
         const IndexAccessMethod* _real;
+        const IndexDescriptor* _descriptor;
         int64_t _keysInserted = 0;
         bool _isMultiKey = false;
     };
@@ -123,6 +123,14 @@ void S2CellIdsToIntervalsWithParents(const std::vector<S2CellId>& intervalSet,
                                      OrderedIntervalList* oilOut) {
     // There may be duplicates when going up parent cells if two cells share a parent
     std::unordered_set<S2CellId> exactSet;
+    S2CellIdsToIntervalsWithNewParents(intervalSet, indexParams, &exactSet, oilOut);
+}
+
+void S2CellIdsToIntervalsWithNewParents(const std::vector<S2CellId>& intervalSet,
+                                        const S2IndexingParams& indexParams,
+                                        std::unordered_set<S2CellId>* parentsSeen,
+                                        OrderedIntervalList* oilOut) {
+    std::vector<S2CellId> exactCells;
     for (const S2CellId& interval : intervalSet) {
         S2CellId coveredCell = interval;
         // Look at the cells that cover us.  We want to look at every cell that contains the
@@ -146,10 +154,14 @@ void S2CellIdsToIntervalsWithParents(const std::vector<S2CellId>& intervalSet,
             // coarsestIndexedLevel - this can result in S2 failures when level < 0.
 
             coveredCell = coveredCell.parent();
-            exactSet.insert(coveredCell);
+            if (!parentsSeen->insert(coveredCell).second) {
+                // All of the cells covering this one have been seen along with it.
+                break;
+            }
+            exactCells.push_back(coveredCell);
         }
     }
-    for (const S2CellId& exact : exactSet) {
+    for (const S2CellId& exact : exactCells) {
         BSONObjBuilder b;
         if (indexParams.indexVersion < S2_INDEX_VERSION_3) {
             // for backwards compatibility, use strings
@@ -29,6 +29,9 @@
 
 #pragma once
 
+#include <unordered_set>
+#include <vector>
+
 #include "mongo/db/index/s2_indexing_params.h"
 #include "mongo/db/query/index_bounds.h"
 #include "third_party/s2/s2cellid.h"
@@ -50,4 +53,12 @@ void S2CellIdsToIntervals(const std::vector<S2CellId>& intervalSet,
 void S2CellIdsToIntervalsWithParents(const std::vector<S2CellId>& interval,
                                      const S2IndexingParams& indexParams,
                                      OrderedIntervalList* out);
+
+// Same as above, but skips the exact intervals of the parent cells in 'parentsSeen' and adds
+// those it generates to it. For searches made of several disjoint coverings, this ensures that
+// no exact parent interval is scanned more than once.
+void S2CellIdsToIntervalsWithNewParents(const std::vector<S2CellId>& interval,
+                                        const S2IndexingParams& indexParams,
+                                        std::unordered_set<S2CellId>* parentsSeen,
+                                        OrderedIntervalList* out);
 }
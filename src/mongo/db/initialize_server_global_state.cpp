@@ -50,7 +50,11 @@
 #include "mongo/db/auth/authorization_manager_global.h"
 #include "mongo/db/auth/internal_user_auth.h"
 #include "mongo/db/auth/security_key.h"
+#include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/server_options.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/logger/async_log_writer.h"
+#include "mongo/logger/async_rotatable_file_appender.h"
 #include "mongo/logger/logger.h"
 #include "mongo/logger/console_appender.h"
 #include "mongo/logger/message_event.h"
@@ -197,10 +201,47 @@ void forkServerOrDie() {
         quickExit(EXIT_FAILURE);
 }
 
+namespace {
+
+const char kAsyncLogOverflowBlock[] = "block";
+const char kAsyncLogOverflowDrop[] = "drop";
+
+}  // namespace
+
+// Number of lines the log file's AsyncLogWriter may queue. 0 writes the log file synchronously.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(asyncLogQueueSize, int, 0);
+
+// What happens to log lines while the AsyncLogWriter's queue is full: "block" waits for room,
+// "drop" discards them.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(asyncLogOverflowPolicy, std::string, kAsyncLogOverflowBlock);
+
+// Writes the log file when asyncLogQueueSize is set. Never destroyed, since the server exits
+// without running destructors; dbexit() flushes it through AsyncLogWriter::flushAll().
+static logger::AsyncLogWriter* asyncLogWriter = NULL;
+
+class AsyncLogServerStatusMetric : public ServerStatusMetric {
+public:
+    AsyncLogServerStatusMetric() : ServerStatusMetric("log.async") {}
+
+    virtual void appendAtLeaf(BSONObjBuilder& b) const {
+        if (!asyncLogWriter) {
+            return;
+        }
+        BSONObjBuilder bb(b.subobjStart(_leafName));
+        bb.appendNumber("queuedLines", asyncLogWriter->getQueuedLines());
+        bb.appendNumber("droppedLines", asyncLogWriter->getDroppedLines());
+        bb.appendNumber("writtenLines", asyncLogWriter->getWrittenLines());
+        bb.appendNumber("writtenBatches", asyncLogWriter->getWrittenBatches());
+        bb.done();
+    }
+} asyncLogServerStatusMetric;
+
 MONGO_INITIALIZER_GENERAL(ServerLogRedirection,
                           ("GlobalLogManager", "EndStartupOptionHandling", "ForkServer"),
                           ("default"))(InitializerContext*) {
     using logger::LogManager;
+    using logger::AsyncLogWriter;
+    using logger::AsyncRotatableFileAppender;
     using logger::MessageEventEphemeral;
     using logger::MessageEventDetailsEncoder;
     using logger::MessageEventWithContextEncoder;
@@ -208,6 +249,17 @@ MONGO_INITIALIZER_GENERAL(ServerLogRedirection,
     using logger::RotatableFileAppender;
     using logger::StatusWithRotatableFileWriter;
 
+    if (asyncLogQueueSize < 0) {
+        return Status(ErrorCodes::BadValue, "asyncLogQueueSize must be greater than or equal to 0");
+    }
+    if (asyncLogOverflowPolicy != kAsyncLogOverflowBlock &&
+        asyncLogOverflowPolicy != kAsyncLogOverflowDrop) {
+        return Status(ErrorCodes::BadValue,
+                      mongoutils::str::stream() << "asyncLogOverflowPolicy must be \""
+                                                << kAsyncLogOverflowBlock << "\" or \""
+                                                << kAsyncLogOverflowDrop << "\"");
+    }
+
     if (serverGlobalParams.logWithSyslog) {
 #ifdef _WIN32
         return Status(ErrorCodes::InternalError,
@@ -274,16 +326,34 @@ MONGO_INITIALIZER_GENERAL(ServerLogRedirection,
 
         LogManager* manager = logger::globalLogManager();
         manager->getGlobalDomain()->clearAppenders();
-        manager->getGlobalDomain()->attachAppender(
-            MessageLogDomain::AppenderAutoPtr(new RotatableFileAppender<MessageEventEphemeral>(
-                new MessageEventDetailsEncoder, writer.getValue())));
-        manager->getNamedDomain("javascriptOutput")
-            ->attachAppender(
+        if (asyncLogQueueSize > 0) {
+            asyncLogWriter = new AsyncLogWriter(writer.getValue(),
+                                                asyncLogQueueSize,
+                                                asyncLogOverflowPolicy == kAsyncLogOverflowDrop
+                                                    ? AsyncLogWriter::OverflowPolicy::kDrop
+                                                    : AsyncLogWriter::OverflowPolicy::kBlock);
+            manager->getGlobalDomain()->attachAppender(MessageLogDomain::AppenderAutoPtr(
+                new AsyncRotatableFileAppender<MessageEventEphemeral>(
+                    new MessageEventDetailsEncoder, asyncLogWriter)));
+            manager->getNamedDomain("javascriptOutput")
+                ->attachAppender(MessageLogDomain::AppenderAutoPtr(
+                    new AsyncRotatableFileAppender<MessageEventEphemeral>(
+                        new MessageEventDetailsEncoder, asyncLogWriter)));
+        } else {
+            manager->getGlobalDomain()->attachAppender(
                 MessageLogDomain::AppenderAutoPtr(new RotatableFileAppender<MessageEventEphemeral>(
                     new MessageEventDetailsEncoder, writer.getValue())));
+            manager->getNamedDomain("javascriptOutput")
+                ->attachAppender(MessageLogDomain::AppenderAutoPtr(
+                    new RotatableFileAppender<MessageEventEphemeral>(new MessageEventDetailsEncoder,
+                                                                     writer.getValue())));
+        }
 
         if (serverGlobalParams.logAppend && exists) {
             log() << "***** SERVER RESTARTED *****" << endl;
+            if (asyncLogWriter) {
+                asyncLogWriter->flush();
+            }
             Status status = logger::RotatableFileWriter::Use(writer.getValue()).status();
             if (!status.isOK())
                 return status;
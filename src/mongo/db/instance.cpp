@@ -83,6 +83,7 @@
 #include "mongo/db/stats/counters.h"
 #include "mongo/db/storage/storage_engine.h"
 #include "mongo/db/storage_options.h"
+#include "mongo/logger/async_log_writer.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/platform/process_id.h"
 #include "mongo/rpc/command_reply_builder.h"
@@ -1206,6 +1207,7 @@ NOINLINE_DECL void dbexit(ExitCode rc, const char* why) {
     audit::logShutdown(&cc());
 
     log(LogComponent::kControl) << "dbexit: " << why << " rc: " << rc;
+    logger::AsyncLogWriter::flushAll();
 
 #ifdef _WIN32
     // Windows Service Controller wants to be told when we are down,
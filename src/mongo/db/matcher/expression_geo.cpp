@@ -32,12 +32,23 @@
 
 #include "mongo/platform/basic.h"
 #include "mongo/db/matcher/expression_geo.h"
+
+#include <iterator>
+#include <limits>
+
 #include "mongo/db/geo/geoparser.h"
+#include "mongo/db/query/lru_key_value.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/stdx/mutex.h"
 #include "mongo/util/mongoutils/str.h"
 #include "mongo/util/log.h"
 
 namespace mongo {
 
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(internalQueryGeoGeometryCacheSizeBytes,
+                                      int,
+                                      16 * 1024 * 1024);
+
 
 using mongoutils::str::equals;
 
@@ -49,7 +60,83 @@ using mongoutils::str::equals;
 GeoExpression::GeoExpression() : field(""), predicate(INVALID) {}
 GeoExpression::GeoExpression(const std::string& f) : field(f), predicate(INVALID) {}
 
-Status GeoExpression::parseQuery(const BSONObj& obj) {
+namespace {
+
+/**
+ * An LRU cache of the parsed geometries of $geoWithin and $geoIntersects predicates, keyed by
+ * the BSON of the predicate, e.g. { $geoWithin: { $geometry: {...} } }. Cached geometries are
+ * already projected, carry their interior covering, and memoize their index covering, so
+ * repeated queries on the same geometry skip parsing and covering and accept points inside
+ * interior cells without an exact test.
+ *
+ * The cache is bounded by the approximate size of its entries, taken when they are added, and
+ * evicts the least recently used entries to stay within internalQueryGeoGeometryCacheSizeBytes.
+ * Entries larger than an eighth of that are not cached, so one huge polygon cannot flush the
+ * rest. The index covering, memoized later, is bounded by the index's coverer parameters.
+ */
+class GeometryCache {
+public:
+    struct Entry {
+        GeoExpression::Predicate predicate;
+        std::shared_ptr<const GeometryContainer> geometry;
+        size_t bytes = 0;  // approximate size of the entry and its key
+    };
+
+    bool get(const BSONObj& query, Entry* entryOut) {
+        stdx::lock_guard<stdx::mutex> lock(_mutex);
+        Entry* entry;
+        if (!_cache || !_cache->get(key(query), &entry).isOK()) {
+            return false;
+        }
+        *entryOut = *entry;
+        return true;
+    }
+
+    void add(const BSONObj& query, const Entry& entry) {
+        const size_t maxBytes = internalQueryGeoGeometryCacheSizeBytes;
+        std::string entryKey = key(query);
+        std::unique_ptr<Entry> newEntry(new Entry(entry));
+        newEntry->bytes = entryKey.size() + entry.geometry->getApproximateSize();
+        if (newEntry->bytes > maxBytes / 8) {
+            return;
+        }
+
+        stdx::lock_guard<stdx::mutex> lock(_mutex);
+        if (!_cache) {
+            // Bounded by _bytes rather than by the number of entries.
+            _cache.reset(new LRUKeyValue<std::string, Entry>(std::numeric_limits<size_t>::max()));
+        }
+        Entry* replaced;
+        if (_cache->get(entryKey, &replaced).isOK()) {
+            _bytes -= replaced->bytes;
+        }
+        _bytes += newEntry->bytes;
+        _cache->add(entryKey, newEntry.release());
+
+        while (_bytes > maxBytes) {
+            auto leastRecentlyUsed = std::prev(_cache->end());
+            _bytes -= leastRecentlyUsed->second->bytes;
+            const std::string evictedKey = leastRecentlyUsed->first;
+            _cache->remove(evictedKey);
+        }
+    }
+
+private:
+    static std::string key(const BSONObj& query) {
+        return std::string(query.objdata(), query.objsize());
+    }
+
+    stdx::mutex _mutex;
+    std::unique_ptr<LRUKeyValue<std::string, Entry>> _cache;
+    size_t _bytes = 0;  // sum of the sizes of the entries in _cache
+};
+
+GeometryCache geometryCache;
+
+}  // namespace
+
+Status GeoExpression::parseQuery(const BSONObj& obj,
+                                 std::unique_ptr<GeometryContainer>* geometryOut) {
     BSONObjIterator outerIt(obj);
     // "within" / "geoWithin" / "geoIntersects"
     BSONElement queryElt = outerIt.next();
@@ -83,14 +170,14 @@ Status GeoExpression::parseQuery(const BSONObj& obj) {
             warning() << "deprecated $uniqueDocs option: " << obj.toString() << endl;
         } else {
             // The element must be a geo specifier. "$box", "$center", "$geometry", etc.
-            geoContainer.reset(new GeometryContainer());
-            Status status = geoContainer->parseFromQuery(elt);
+            geometryOut->reset(new GeometryContainer());
+            Status status = (*geometryOut)->parseFromQuery(elt);
             if (!status.isOK())
                 return status;
         }
     }
 
-    if (geoContainer == NULL) {
+    if (*geometryOut == NULL) {
         return Status(ErrorCodes::BadValue, "geo query doesn't have any geometry");
     }
 
@@ -98,8 +185,19 @@ Status GeoExpression::parseQuery(const BSONObj& obj) {
 }
 
 Status GeoExpression::parseFrom(const BSONObj& obj) {
+    const bool useCache = internalQueryGeoGeometryCacheSizeBytes > 0;
+    if (useCache) {
+        GeometryCache::Entry entry;
+        if (geometryCache.get(obj, &entry)) {
+            predicate = entry.predicate;
+            geoContainer = entry.geometry;
+            return Status::OK();
+        }
+    }
+
     // Initialize geoContainer and parse BSON object
-    Status status = parseQuery(obj);
+    std::unique_ptr<GeometryContainer> geometry;
+    Status status = parseQuery(obj, &geometry);
     if (!status.isOK())
         return status;
 
@@ -113,7 +211,7 @@ Status GeoExpression::parseFrom(const BSONObj& obj) {
     // though I wonder if we want to preserve orientation for lines or
     // allow (a,b),(c,d) to be within (c,d),(a,b).  Anyway, punt on
     // this for now.
-    if (GeoExpression::WITHIN == predicate && !geoContainer->supportsContains()) {
+    if (GeoExpression::WITHIN == predicate && !geometry->supportsContains()) {
         return Status(ErrorCodes::BadValue,
                       str::stream() << "$within not supported with provided geometry: " << obj);
     }
@@ -121,24 +219,36 @@ Status GeoExpression::parseFrom(const BSONObj& obj) {
     // Big polygon with strict winding order is represented as an S2Loop in SPHERE CRS.
     // So converting the query to SPHERE CRS makes things easier than projecting all the data
     // into STRICT_SPHERE CRS.
-    if (STRICT_SPHERE == geoContainer->getNativeCRS()) {
-        if (!geoContainer->supportsProject(SPHERE)) {
+    if (STRICT_SPHERE == geometry->getNativeCRS()) {
+        if (!geometry->supportsProject(SPHERE)) {
             return Status(ErrorCodes::BadValue, "only polygon supported with strict winding order");
         }
-        geoContainer->projectInto(SPHERE);
+        geometry->projectInto(SPHERE);
     }
 
     // $geoIntersect queries are hardcoded to *always* be in SPHERE CRS
     // TODO: This is probably bad semantics, should not do this
     if (GeoExpression::INTERSECT == predicate) {
-        if (!geoContainer->supportsProject(SPHERE)) {
+        if (!geometry->supportsProject(SPHERE)) {
             return Status(ErrorCodes::BadValue,
                           str::stream()
                               << "$geoIntersect not supported with provided geometry: " << obj);
         }
-        geoContainer->projectInto(SPHERE);
+        geometry->projectInto(SPHERE);
+    }
+
+    // Points are cheap to parse and to cover, and are unlikely to repeat.
+    if (useCache && geometry->hasS2Region() && !geometry->isPoint()) {
+        geometry->computeS2InteriorCovering();
+        GeometryCache::Entry entry;
+        entry.predicate = predicate;
+        entry.geometry.reset(geometry.release());
+        geoContainer = entry.geometry;
+        geometryCache.add(obj, entry);
+        return Status::OK();
     }
 
+    geoContainer.reset(geometry.release());
     return Status::OK();
 }
 
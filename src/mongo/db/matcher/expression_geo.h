@@ -41,6 +41,9 @@ namespace mongo {
 struct PointWithCRS;
 class GeometryContainer;
 
+// Approximate bytes of query geometries kept by the geometry cache. Zero disables the cache.
+extern int internalQueryGeoGeometryCacheSizeBytes;
+
 // This represents either a $within or a $geoIntersects.
 class GeoExpression {
     MONGO_DISALLOW_COPYING(GeoExpression);
@@ -68,11 +71,12 @@ private:
     // Parse geospatial query
     // e.g.
     // { "$intersect" : { "$geometry" : { "type" : "Point", "coordinates": [ 40, 5 ] } } }
-    Status parseQuery(const BSONObj& obj);
+    Status parseQuery(const BSONObj& obj, std::unique_ptr<GeometryContainer>* geometryOut);
 
     // Name of the field in the query.
     std::string field;
-    std::unique_ptr<GeometryContainer> geoContainer;
+    // May be shared with other queries on the same geometry through the geometry cache.
+    std::shared_ptr<const GeometryContainer> geoContainer;
     Predicate predicate;
 };
 
@@ -38,6 +38,8 @@
 #include "mongo/db/matcher/expression.h"
 #include "mongo/db/matcher/expression_geo.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/util/mongoutils/str.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
@@ -185,4 +187,91 @@ TEST(ExpressionGeoTest, GeoNearNotEquivalent) {
         gne2(makeGeoNearMatchExpression(query2));
     ASSERT(!gne1->equivalent(gne2.get()));
 }
+
+/**
+ * Repeated predicates on the same geometry share the cached geometry, and match the same
+ * documents whether or not a point falls inside one of its interior cells.
+ */
+TEST(ExpressionGeoTest, GeoCachedGeometry) {
+    const char* polygon =
+        "{type: 'Polygon', coordinates: [[[0, 0], [10, 0], [10, 10], [0, 10], [0, 0]]]}";
+    BSONObj withinQuery = fromjson(std::string("{$geoWithin: {$geometry: ") + polygon + "}}");
+    BSONObj intersectsQuery =
+        fromjson(std::string("{$geoIntersects: {$geometry: ") + polygon + "}}");
+
+    std::unique_ptr<GeoMatchExpression> within1(makeGeoMatchExpression(withinQuery)),
+        within2(makeGeoMatchExpression(withinQuery)),
+        intersects(makeGeoMatchExpression(intersectsQuery));
+    ASSERT_EQUALS(&within1->getGeoExpression().getGeometry(),
+                  &within2->getGeoExpression().getGeometry());
+    ASSERT_EQUALS(GeoExpression::WITHIN, within2->getGeoExpression().getPred());
+    ASSERT_EQUALS(GeoExpression::INTERSECT, intersects->getGeoExpression().getPred());
+
+    const char* inside[] = {"{a: {type: 'Point', coordinates: [5, 5]}}",
+                            "{a: {type: 'Point', coordinates: [0.0001, 5]}}",
+                            "{a: {type: 'Point', coordinates: [0, 0]}}",
+                            "{a: [5, 5]}",
+                            "{a: {type: 'MultiPoint', coordinates: [[1, 1], [9, 9]]}}"};
+    for (size_t i = 0; i < sizeof(inside) / sizeof(inside[0]); ++i) {
+        BSONObj doc = fromjson(inside[i]);
+        ASSERT(within1->matchesBSON(doc));
+        ASSERT(within2->matchesBSON(doc));
+        ASSERT(intersects->matchesBSON(doc));
+    }
+
+    const char* outside[] = {"{a: {type: 'Point', coordinates: [-0.0001, 5]}}",
+                             "{a: {type: 'Point', coordinates: [50, 50]}}",
+                             "{a: [11, 5]}",
+                             "{a: {type: 'MultiPoint', coordinates: [[1, 1], [19, 9]]}}"};
+    for (size_t i = 0; i < sizeof(outside) / sizeof(outside[0]); ++i) {
+        BSONObj doc = fromjson(outside[i]);
+        ASSERT(!within1->matchesBSON(doc));
+        ASSERT(!within2->matchesBSON(doc));
+    }
+    ASSERT(!intersects->matchesBSON(fromjson(outside[0])));
+    ASSERT(intersects->matchesBSON(fromjson(outside[3])));
+}
+/**
+ * Returns a $geoWithin query on a polygon with 'numVertices' vertices around ['lng', 0].
+ */
+BSONObj makeWithinPolygonQuery(int lng, int numVertices) {
+    str::stream coordinates;
+    for (int i = 0; i <= numVertices; ++i) {
+        const double angle = 2 * M_PI * (i % numVertices) / numVertices;
+        coordinates << (i ? ", [" : "[") << lng + cos(angle) << ", " << sin(angle) << "]";
+    }
+    return fromjson(std::string("{$geoWithin: {$geometry: {type: 'Polygon', coordinates: [[") +
+                    std::string(coordinates) + "]]}}}");
+}
+
+TEST(ExpressionGeoTest, GeoCacheIsBoundedByBytes) {
+    const int oldCacheSizeBytes = internalQueryGeoGeometryCacheSizeBytes;
+    ON_BLOCK_EXIT([oldCacheSizeBytes] {
+        internalQueryGeoGeometryCacheSizeBytes = oldCacheSizeBytes;
+    });
+    internalQueryGeoGeometryCacheSizeBytes = 64 * 1024;
+
+    // Small polygons are cached.
+    BSONObj small = makeWithinPolygonQuery(-100, 4);
+    std::unique_ptr<GeoMatchExpression> small1(makeGeoMatchExpression(small)),
+        small2(makeGeoMatchExpression(small));
+    ASSERT_EQUALS(&small1->getGeoExpression().getGeometry(),
+                  &small2->getGeoExpression().getGeometry());
+
+    // A polygon taking more than an eighth of the cache is not.
+    BSONObj large = makeWithinPolygonQuery(100, 200);
+    std::unique_ptr<GeoMatchExpression> large1(makeGeoMatchExpression(large)),
+        large2(makeGeoMatchExpression(large));
+    ASSERT_NOT_EQUALS(&large1->getGeoExpression().getGeometry(),
+                      &large2->getGeoExpression().getGeometry());
+
+    // Adding more polygons than fit evicts the least recently used.
+    for (int i = 0; i < 100; ++i) {
+        std::unique_ptr<GeoMatchExpression> other(
+            makeGeoMatchExpression(makeWithinPolygonQuery(i, 4)));
+    }
+    std::unique_ptr<GeoMatchExpression> small3(makeGeoMatchExpression(small));
+    ASSERT_NOT_EQUALS(&small1->getGeoExpression().getGeometry(),
+                      &small3->getGeoExpression().getGeometry());
+}
 }
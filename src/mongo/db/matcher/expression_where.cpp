@@ -117,6 +117,7 @@ Status WhereMatchExpression::init(StringData dbName, StringData theCode, const B
     try {
         _scope = globalScriptEngine->getPooledScope(_txn, _dbName, "where" + userToken);
         _func = _scope->createFunction(_code.c_str());
+        _scope->setBoolean("fullObject", true);  // this is a hack b/c fullObject used to be relevant
     } catch (...) {
         return exceptionToStatus();
     }
@@ -136,9 +137,12 @@ bool WhereMatchExpression::matches(const MatchableDocument* doc, MatchDetails* d
     }
 
     _scope->setObject("obj", const_cast<BSONObj&>(obj));
-    _scope->setBoolean("fullObject", true);  // this is a hack b/c fullObject used to be relevant
 
-    int err = _scope->invoke(_func, 0, &obj, 1000 * 60, false);
+    // Invoking a batch of one returns the result along with the call, rather than leaving it in
+    // __returnValue for another call into the engine to read.
+    const std::vector<BSONObj> recvs(1, obj);
+    std::vector<bool> returnValues;
+    int err = _scope->invokeBatch(_func, 0, recvs, &returnValues, 1000 * 60);
     if (err == -3) {  // INVOKE_ERROR
         stringstream ss;
         ss << "error on invocation of $where function:\n" << _scope->getError();
@@ -147,7 +151,7 @@ bool WhereMatchExpression::matches(const MatchableDocument* doc, MatchDetails* d
         uassert(16813, "unknown error in invocation of $where function", false);
     }
 
-    return _scope->getBoolean("__returnValue") != 0;
+    return returnValues[0];
 }
 
 void WhereMatchExpression::debugString(StringBuilder& debug, int level) const {
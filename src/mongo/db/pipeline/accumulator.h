@@ -37,7 +37,9 @@
 #include "mongo/base/init.h"
 #include "mongo/bson/bsontypes.h"
 #include "mongo/db/pipeline/value.h"
+#include "mongo/platform/decimal128.h"
 #include "mongo/stdx/functional.h"
+#include "mongo/util/summation.h"
 
 namespace mongo {
 /**
@@ -171,8 +173,8 @@ public:
 
 private:
     BSONType totalType;
-    long long longTotal;
-    double doubleTotal;
+    CompensatedSum nonDecimalTotal;
+    Decimal128 decimalTotal;  // Only set once totalType is NumberDecimal.
 };
 
 
@@ -227,7 +229,7 @@ public:
     static boost::intrusive_ptr<Accumulator> create();
 
 private:
-    double _total;
+    CompensatedSum _total;
     long long _count;
 };
 
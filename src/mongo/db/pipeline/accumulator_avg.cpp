@@ -50,17 +50,24 @@ const char countName[] = "count";
 
 void AccumulatorAvg::processInternal(const Value& input, bool merging) {
     if (!merging) {
-        // non numeric types have no impact on average
-        if (!input.numeric())
-            return;
-
-        _total += input.getDouble();
+        switch (input.getType()) {
+            case NumberInt:
+            case NumberLong:
+                _total.addLong(input.getLong());
+                break;
+            case NumberDouble:
+                _total.addDouble(input.getDouble());
+                break;
+            default:
+                // non numeric types have no impact on average
+                return;
+        }
         _count += 1;
     } else {
         // We expect an object that contains both a subtotal and a count.
         // This is what getValue(true) produced below.
         verify(input.getType() == Object);
-        _total += input[subTotalName].getDouble();
+        _total.addDouble(input[subTotalName].getDouble());
         _count += input[countName].getLong();
     }
 }
@@ -74,19 +81,19 @@ Value AccumulatorAvg::getValue(bool toBeMerged) const {
         if (_count == 0)
             return Value(BSONNULL);
 
-        return Value(_total / static_cast<double>(_count));
+        return Value(_total.getDouble() / static_cast<double>(_count));
     } else {
-        return Value(DOC(subTotalName << _total << countName << _count));
+        return Value(DOC(subTotalName << _total.getDouble() << countName << _count));
     }
 }
 
-AccumulatorAvg::AccumulatorAvg() : _total(0), _count(0) {
+AccumulatorAvg::AccumulatorAvg() : _count(0) {
     // This is a fixed size Accumulator so we never need to update this
     _memUsageBytes = sizeof(*this);
 }
 
 void AccumulatorAvg::reset() {
-    _total = 0;
+    _total = CompensatedSum();
     _count = 0;
 }
 }
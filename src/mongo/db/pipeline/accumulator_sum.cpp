@@ -42,24 +42,27 @@ const char* AccumulatorSum::getOpName() const {
 }
 
 void AccumulatorSum::processInternal(const Value& input, bool merging) {
-    // do nothing with non numeric types
-    if (!input.numeric())
-        return;
+    const BSONType inputType = input.getType();
+    switch (inputType) {
+        case NumberInt:
+        case NumberLong:
+            nonDecimalTotal.addLong(input.getLong());
+            break;
+        case NumberDouble:
+            nonDecimalTotal.addDouble(input.getDouble());
+            break;
+        case NumberDecimal:
+            // Decimals are summed on their own, with the precision of a Decimal128.
+            decimalTotal = totalType == NumberDecimal ? decimalTotal.add(input.getDecimal())
+                                                      : input.getDecimal();
+            break;
+        default:
+            // do nothing with non numeric types
+            return;
+    }
 
     // upgrade to the widest type required to hold the result
-    totalType = Value::getWidestNumeric(totalType, input.getType());
-
-    if (totalType == NumberInt || totalType == NumberLong) {
-        long long v = input.coerceToLong();
-        longTotal += v;
-        doubleTotal += v;
-    } else if (totalType == NumberDouble) {
-        double v = input.coerceToDouble();
-        doubleTotal += v;
-    } else {
-        // non numerics should have returned above so we should never get here
-        verify(false);
-    }
+    totalType = Value::getWidestNumeric(totalType, inputType);
 }
 
 intrusive_ptr<Accumulator> AccumulatorSum::create() {
@@ -67,25 +70,31 @@ intrusive_ptr<Accumulator> AccumulatorSum::create() {
 }
 
 Value AccumulatorSum::getValue(bool toBeMerged) const {
-    if (totalType == NumberLong) {
-        return Value(longTotal);
-    } else if (totalType == NumberDouble) {
-        return Value(doubleTotal);
-    } else if (totalType == NumberInt) {
-        return Value::createIntOrLong(longTotal);
+    // Integer totals which overflow a long long are returned as doubles.
+    if (totalType == NumberLong && nonDecimalTotal.isLong()) {
+        return Value(nonDecimalTotal.getLong());
+    } else if (totalType == NumberInt && nonDecimalTotal.isLong()) {
+        return Value::createIntOrLong(nonDecimalTotal.getLong());
+    } else if (totalType == NumberInt || totalType == NumberLong || totalType == NumberDouble) {
+        return Value(nonDecimalTotal.getDouble());
+    } else if (totalType == NumberDecimal) {
+        const Decimal128 nonDecimal = nonDecimalTotal.isLong()
+            ? Decimal128(nonDecimalTotal.getLong())
+            : Decimal128(nonDecimalTotal.getDouble());
+        return Value(decimalTotal.add(nonDecimal));
     } else {
         massert(16000, "$sum resulted in a non-numeric type", false);
     }
 }
 
-AccumulatorSum::AccumulatorSum() : totalType(NumberInt), longTotal(0), doubleTotal(0) {
+AccumulatorSum::AccumulatorSum() : totalType(NumberInt), decimalTotal() {
     // This is a fixed size Accumulator so we never need to update this
     _memUsageBytes = sizeof(*this);
 }
 
 void AccumulatorSum::reset() {
     totalType = NumberInt;
-    longTotal = 0;
-    doubleTotal = 0;
+    nonDecimalTotal = CompensatedSum();
+    decimalTotal = Decimal128();
 }
 }
@@ -884,12 +884,22 @@ private:
     SortKey vSortKey;
     std::vector<char> vAscending;  // used like std::vector<bool> but without specialization
 
-    /// Extracts the fields in vSortKey from the Document;
+    /**
+     * Extracts the fields in vSortKey from the Document. When sorting by KeyStrings, returns the
+     * KeyString encoding of their values as a string.
+     */
     Value extractKey(const Document& d) const;
 
     /// Compare two Values according to the specified sort key.
     int compare(const Value& lhs, const Value& rhs) const;
 
+    /**
+     * The ordering the sort keys are KeyString encoded with, if the keys of the loaded documents
+     * are compared by their KeyString encodings rather than as Values. Not used when merging
+     * presorted results.
+     */
+    boost::optional<Ordering> _keyStringOrdering;
+
     typedef Sorter<Value, Document> MySorter;
 
     // For MySorter
@@ -36,6 +36,9 @@
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/expression_context.h"
 #include "mongo/db/pipeline/value.h"
+#include "mongo/db/query/query_knobs.h"
+#include "mongo/db/storage/key_string.h"
+#include "mongo/platform/decimal128.h"
 
 namespace mongo {
 
@@ -245,6 +248,15 @@ void DocumentSourceSort::populate() {
 void DocumentSourceSort::loadDocument(const Document& doc) {
     invariant(!populated);
     if (!_sorter) {
+        // KeyString cannot encode NumberDecimal values, and Ordering holds at most 32 fields.
+        if (internalQueryExecSortUsingKeyStrings && !Decimal128::enabled &&
+            vSortKey.size() <= 32) {
+            BSONObjBuilder orderingBuilder;
+            for (size_t i = 0; i < vAscending.size(); i++) {
+                orderingBuilder.append("", vAscending[i] ? 1 : -1);
+            }
+            _keyStringOrdering = Ordering::make(orderingBuilder.done());
+        }
         _sorter.reset(MySorter::make(makeSortOptions(), Comparator(*this)));
     }
     _sorter->add(extractKey(doc), doc);
@@ -289,6 +301,23 @@ void DocumentSourceSort::populateFromCursors(const vector<DBClientCursor*>& curs
 
 Value DocumentSourceSort::extractKey(const Document& d) const {
     Variables vars(0, d);
+    if (_keyStringOrdering) {
+        BSONObjBuilder keyBuilder;
+        for (size_t i = 0; i < vSortKey.size(); i++) {
+            Value key = vSortKey[i]->evaluate(&vars);
+            // Missing values compare equal to undefined, not to null.
+            if (key.missing()) {
+                keyBuilder.appendUndefined("");
+            } else {
+                key.addToBsonObj(&keyBuilder, "");
+            }
+        }
+
+        KeyString keyString;
+        keyString.resetToSortKey(keyBuilder.done(), *_keyStringOrdering);
+        return Value(StringData(keyString.getBuffer(), keyString.getSize()));
+    }
+
     if (vSortKey.size() == 1) {
         return vSortKey[0]->evaluate(&vars);
     }
@@ -309,6 +338,11 @@ int DocumentSourceSort::compare(const Value& lhs, const Value& rhs) const {
       However, the tricky part is what to do is none of the sort keys are
       present.  In this case, consider the document less.
     */
+    if (_keyStringOrdering) {
+        // The encodings are strings which already account for the direction of each key.
+        return Value::compare(lhs, rhs);
+    }
+
     const size_t n = vSortKey.size();
     if (n == 1) {  // simple fast case
         if (vAscending[0])
@@ -28,15 +28,19 @@
 
 #include "mongo/platform/basic.h"
 
+#include <boost/filesystem/operations.hpp>
+
 #include "mongo/db/operation_context_noop.h"
 #include "mongo/db/pipeline/dependencies.h"
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/db/pipeline/expression_context.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/service_context_noop.h"
 #include "mongo/db/storage_options.h"
 #include "mongo/dbtests/dbtests.h"
 #include "mongo/unittest/temp_dir.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 bool isMongos() {
@@ -1593,6 +1597,159 @@ class ExtractArrayValues : public CheckResultsBase {
     }
 };
 
+/**
+ * Checks the results both when the sort keys of the loaded documents are compared by their
+ * KeyString encodings and when they are compared as Values.
+ */
+class KeyStringCheckResultsBase : public CheckResultsBase {
+public:
+    void run() {
+        const bool oldSortUsingKeyStrings = internalQueryExecSortUsingKeyStrings;
+        ON_BLOCK_EXIT([oldSortUsingKeyStrings] {
+            internalQueryExecSortUsingKeyStrings = oldSortUsingKeyStrings;
+        });
+
+        internalQueryExecSortUsingKeyStrings = true;
+        CheckResultsBase::run();
+        internalQueryExecSortUsingKeyStrings = false;
+        CheckResultsBase::run();
+    }
+};
+
+/** Sorting values of different types, ascending. */
+class MixedTypesAscending : public KeyStringCheckResultsBase {
+    std::deque<Document> inputData() {
+        return {DOC("_id" << 0 << "a"
+                          << "x"),
+                DOC("_id" << 1 << "a" << 2),
+                DOC("_id" << 2),
+                DOC("_id" << 3 << "a" << BSONNULL),
+                DOC("_id" << 4 << "a" << true),
+                DOC("_id" << 5 << "a" << 1LL),
+                DOC("_id" << 6 << "a" << DOC("b" << 1)),
+                DOC("_id" << 7 << "a" << DOC_ARRAY(3 << 0)),
+                DOC("_id" << 8 << "a" << 1.5),
+                DOC("_id" << 9 << "a" << 1.0)};
+    }
+    string expectedResultSetString() {
+        return "[{_id:2},{_id:3,a:null},{_id:5,a:1},{_id:9,a:1.0},{_id:8,a:1.5},{_id:1,a:2},"
+               "{_id:0,a:'x'},{_id:6,a:{b:1}},{_id:7,a:[3,0]},{_id:4,a:true}]";
+    }
+    BSONObj sortSpec() {
+        return BSON("a" << 1 << "_id" << 1);
+    }
+};
+
+/** Sorting values of different types, descending. */
+class MixedTypesDescending : public MixedTypesAscending {
+    string expectedResultSetString() {
+        return "[{_id:4,a:true},{_id:7,a:[3,0]},{_id:6,a:{b:1}},{_id:0,a:'x'},{_id:1,a:2},"
+               "{_id:8,a:1.5},{_id:5,a:1},{_id:9,a:1.0},{_id:3,a:null},{_id:2}]";
+    }
+    BSONObj sortSpec() {
+        return BSON("a" << -1 << "_id" << 1);
+    }
+};
+
+/** Missing values in a compound key, which sort before null. */
+class MissingValuesCompound : public KeyStringCheckResultsBase {
+    std::deque<Document> inputData() {
+        return {DOC("_id" << 0 << "a" << 1),
+                DOC("_id" << 1 << "b" << 1),
+                DOC("_id" << 2 << "a" << 1 << "b" << 2),
+                DOC("_id" << 3 << "a" << BSONNULL << "b" << 0),
+                DOC("_id" << 4),
+                DOC("_id" << 5 << "a" << 1 << "b" << BSONNULL)};
+    }
+    string expectedResultSetString() {
+        return "[{_id:1,b:1},{_id:4},{_id:3,a:null,b:0},{_id:2,a:1,b:2},{_id:5,a:1,b:null},"
+               "{_id:0,a:1}]";
+    }
+    BSONObj sortSpec() {
+        return BSON("a" << 1 << "b" << -1);
+    }
+};
+
+/** Sorting more data than fits in memory spills it to disk and merges it back. */
+class SpillToDisk : public Base {
+public:
+    SpillToDisk() : _tempDir("DocumentSourceSortTest") {}
+
+    void run() {
+        const bool oldSortUsingKeyStrings = internalQueryExecSortUsingKeyStrings;
+        ON_BLOCK_EXIT([oldSortUsingKeyStrings] {
+            internalQueryExecSortUsingKeyStrings = oldSortUsingKeyStrings;
+        });
+
+        ctx()->extSortAllowed = true;
+        ctx()->tempDir = _tempDir.path();
+
+        internalQueryExecSortUsingKeyStrings = true;
+        checkResults();
+        internalQueryExecSortUsingKeyStrings = false;
+        checkResults();
+    }
+
+private:
+    static const int kNumDocs = 120;
+
+    void checkResults() {
+        // Each document counts the whole padding against the 100MB limit of the sort, although
+        // the string is shared.
+        const Value padding(string(1024 * 1024, 'x'));
+
+        // Every third document has a missing, a numeric or a string sort key.
+        std::deque<Document> input;
+        for (int i = 0; i < kNumDocs; i++) {
+            MutableDocument doc;
+            doc["_id"] = Value(i);
+            if (i % 3 == 1) {
+                doc["a"] = i % 2 ? Value(i) : Value(static_cast<double>(i));
+            } else if (i % 3 == 2) {
+                doc["a"] = Value(string(str::stream() << "s" << 1000 + i));
+            }
+            doc["padding"] = padding;
+            input.push_back(doc.freeze());
+        }
+
+        // Strings, then numbers, each in descending order, then missing values by _id.
+        vector<int> expected;
+        for (int i = kNumDocs - 1; i >= 0; i--) {
+            if (i % 3 == 2) {
+                expected.push_back(i);
+            }
+        }
+        for (int i = kNumDocs - 1; i >= 0; i--) {
+            if (i % 3 == 1) {
+                expected.push_back(i);
+            }
+        }
+        for (int i = 0; i < kNumDocs; i++) {
+            if (i % 3 == 0) {
+                expected.push_back(i);
+            }
+        }
+
+        createSort(BSON("a" << -1 << "_id" << 1));
+        auto source = DocumentSourceMock::create(input);
+        sort()->setSource(source.get());
+
+        vector<int> results;
+        while (boost::optional<Document> current = sort()->getNext()) {
+            if (results.empty()) {
+                // The spilled data stays on disk until all of it has been returned.
+                ASSERT(boost::filesystem::directory_iterator(_tempDir.path()) !=
+                       boost::filesystem::directory_iterator());
+            }
+            results.push_back((*current)["_id"].getInt());
+        }
+        assertExhausted();
+        ASSERT(expected == results);
+    }
+
+    TempDir _tempDir;
+};
+
 /** Dependant field paths. */
 class Dependencies : public Base {
 public:
@@ -2136,6 +2293,10 @@ public:
         add<DocumentSourceSort::RandMeta>();
         add<DocumentSourceSort::MissingObjectWithinArray>();
         add<DocumentSourceSort::ExtractArrayValues>();
+        add<DocumentSourceSort::MixedTypesAscending>();
+        add<DocumentSourceSort::MixedTypesDescending>();
+        add<DocumentSourceSort::MissingValuesCompound>();
+        add<DocumentSourceSort::SpillToDisk>();
         add<DocumentSourceSort::Dependencies>();
 
         add<DocumentSourceUnwind::Empty>();
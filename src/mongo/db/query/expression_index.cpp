@@ -33,6 +33,7 @@
 #include "third_party/s2/s2regioncoverer.h"
 
 #include "mongo/db/geo/geoconstants.h"
+#include "mongo/db/geo/geometry_container.h"
 #include "mongo/db/geo/r2_region_coverer.h"
 #include "mongo/db/hasher.h"
 #include "mongo/db/index/expression_params.h"
@@ -108,7 +109,9 @@ void ExpressionMapping::cover2d(const R2Region& region,
     GeoHashsToIntervalsWithParents(unorderedCovering, oilOut);
 }
 
-std::vector<S2CellId> ExpressionMapping::get2dsphereCovering(const S2Region& region) {
+namespace {
+
+void validateS2CoveringParameters() {
     uassert(28739,
             "Geo coarsest level must be in range [0,30]",
             0 <= internalQueryS2GeoCoarsestLevel && internalQueryS2GeoCoarsestLevel <= 30);
@@ -118,6 +121,12 @@ std::vector<S2CellId> ExpressionMapping::get2dsphereCovering(const S2Region& reg
     uassert(28741,
             "Geo coarsest level must be less than or equal to finest",
             internalQueryS2GeoCoarsestLevel <= internalQueryS2GeoFinestLevel);
+}
+
+}  // namespace
+
+std::vector<S2CellId> ExpressionMapping::get2dsphereCovering(const S2Region& region) {
+    validateS2CoveringParameters();
 
     S2RegionCoverer coverer;
     coverer.set_min_level(internalQueryS2GeoCoarsestLevel);
@@ -129,6 +138,13 @@ std::vector<S2CellId> ExpressionMapping::get2dsphereCovering(const S2Region& reg
     return cover;
 }
 
+std::vector<S2CellId> ExpressionMapping::get2dsphereCovering(const GeometryContainer& geometry) {
+    validateS2CoveringParameters();
+    return geometry.getS2Covering(internalQueryS2GeoCoarsestLevel,
+                                  internalQueryS2GeoFinestLevel,
+                                  internalQueryS2GeoMaxCells);
+}
+
 void ExpressionMapping::cover2dsphere(const S2Region& region,
                                       const S2IndexingParams& indexingParams,
                                       OrderedIntervalList* oilOut) {
@@ -136,4 +152,11 @@ void ExpressionMapping::cover2dsphere(const S2Region& region,
     S2CellIdsToIntervalsWithParents(cover, indexingParams, oilOut);
 }
 
+void ExpressionMapping::cover2dsphere(const GeometryContainer& geometry,
+                                      const S2IndexingParams& indexingParams,
+                                      OrderedIntervalList* oilOut) {
+    std::vector<S2CellId> cover = get2dsphereCovering(geometry);
+    S2CellIdsToIntervalsWithParents(cover, indexingParams, oilOut);
+}
+
 }  // namespace mongo
@@ -38,6 +38,8 @@
 
 namespace mongo {
 
+class GeometryContainer;
+
 /**
  * Functions that compute expression index mappings.
  *
@@ -61,9 +63,19 @@ public:
 
     static std::vector<S2CellId> get2dsphereCovering(const S2Region& region);
 
+    /**
+     * Same as above, but reuses the covering memoized by the geometry if it was built with the
+     * current covering parameters.
+     */
+    static std::vector<S2CellId> get2dsphereCovering(const GeometryContainer& geometry);
+
     static void cover2dsphere(const S2Region& region,
                               const S2IndexingParams& indexParams,
                               OrderedIntervalList* oilOut);
+
+    static void cover2dsphere(const GeometryContainer& geometry,
+                              const S2IndexingParams& indexParams,
+                              OrderedIntervalList* oilOut);
 };
 
 }  // namespace mongo
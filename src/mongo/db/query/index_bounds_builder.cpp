@@ -557,11 +557,11 @@ void IndexBoundsBuilder::translate(const MatchExpression* expr,
         const GeoMatchExpression* gme = static_cast<const GeoMatchExpression*>(expr);
 
         if (mongoutils::str::equals("2dsphere", elt.valuestrsafe())) {
-            verify(gme->getGeoExpression().getGeometry().hasS2Region());
-            const S2Region& region = gme->getGeoExpression().getGeometry().getS2Region();
+            const GeometryContainer& geometry = gme->getGeoExpression().getGeometry();
+            verify(geometry.hasS2Region());
             S2IndexingParams indexParams;
             ExpressionParams::parse2dsphereParams(index.infoObj, &indexParams);
-            ExpressionMapping::cover2dsphere(region, indexParams, oilOut);
+            ExpressionMapping::cover2dsphere(geometry, indexParams, oilOut);
             *tightnessOut = IndexBoundsBuilder::INEXACT_FETCH;
         } else if (mongoutils::str::equals("2d", elt.valuestrsafe())) {
             verify(gme->getGeoExpression().getGeometry().hasR2Region());
@@ -717,6 +717,17 @@ TEST_F(CachePlanSelectionTest, EqualityIndexScanWithTrailingFields) {
         BSON("x" << 5), "{fetch: {filter: null, node: {ixscan: {pattern: {x: 1, y: 1}}}}}");
 }
 
+TEST_F(CachePlanSelectionTest, SkipScanNonLeadingField) {
+    params.options |= QueryPlannerParams::INDEX_SKIP_SCAN;
+    addIndex(BSON("x" << 1 << "y" << 1));
+    runQuery(BSON("y" << 5));
+
+    assertPlanCacheRecoversSolution(
+        BSON("y" << 5),
+        "{fetch: {filter: {y: 5}, node: {ixscan: {pattern: {x: 1, y: 1}, bounds: "
+        "{x: [['MinKey','MaxKey',true,true]], y: [[5,5,true,true]]}}}}}");
+}
+
 //
 // Geo
 //
@@ -42,6 +42,7 @@
 #include "mongo/db/query/indexability.h"
 #include "mongo/db/query/index_bounds_builder.h"
 #include "mongo/db/query/index_tag.h"
+#include "mongo/db/query/planner_ixselect.h"
 #include "mongo/db/query/query_knobs.h"
 #include "mongo/db/query/query_planner.h"
 #include "mongo/db/query/query_planner_common.h"
@@ -1265,6 +1266,88 @@ QuerySolutionNode* QueryPlannerAccess::scanWholeIndex(const IndexEntry& index,
     return solnRoot;
 }
 
+// static
+QuerySolutionNode* QueryPlannerAccess::skipScanIndex(const IndexEntry& index,
+                                                     const CanonicalQuery& query,
+                                                     const QueryPlannerParams& params) {
+    // Only the top-level predicates of a rooted $and (or a single predicate) can constrain the
+    // trailing index fields.
+    MatchExpression* root = query.root();
+    std::vector<MatchExpression*> predicates;
+    if (MatchExpression::AND == root->matchType()) {
+        for (size_t i = 0; i < root->numChildren(); ++i) {
+            predicates.push_back(root->getChild(i));
+        }
+    } else {
+        predicates.push_back(root);
+    }
+
+    unique_ptr<IndexScanNode> isn = make_unique<IndexScanNode>();
+    isn->indexKeyPattern = index.keyPattern;
+    isn->indexIsMultiKey = index.multikey;
+    isn->maxScan = query.getParsed().getMaxScan();
+    isn->addKeyMetadata = query.getParsed().returnKey();
+    isn->bounds.fields.resize(index.keyPattern.nFields());
+
+    size_t fieldNo = 0;
+    size_t numConstrainedFields = 0;
+    BSONObjIterator kpIt(index.keyPattern);
+    while (kpIt.more()) {
+        BSONElement elt = kpIt.next();
+        OrderedIntervalList* oil = &isn->bounds.fields[fieldNo];
+
+        // Bounds from several predicates over the same field can't be intersected for a
+        // multikey index, and compounding bounds is only safe for fields that don't share an
+        // array. Constrain a single field of a multikey index.
+        bool canConstrain = !index.multikey || 0 == numConstrainedFields;
+        bool constrained = false;
+        for (size_t i = 0; canConstrain && i < predicates.size(); ++i) {
+            MatchExpression* pred = predicates[i];
+            if (pred->path() != elt.fieldNameStringData() ||
+                !Indexability::nodeCanUseIndexOnOwnField(pred) ||
+                !QueryPlannerIXSelect::compatible(elt, index, pred)) {
+                continue;
+            }
+
+            if (0 == fieldNo) {
+                // The enumerator builds the regular plans for predicates over the leading field.
+                return NULL;
+            }
+
+            IndexBoundsBuilder::BoundsTightness tightness;
+            if (!constrained) {
+                IndexBoundsBuilder::translate(pred, elt, index, oil, &tightness);
+                constrained = true;
+            } else {
+                IndexBoundsBuilder::translateAndIntersect(pred, elt, index, oil, &tightness);
+            }
+
+            if (index.multikey) {
+                break;
+            }
+        }
+
+        if (constrained) {
+            ++numConstrainedFields;
+        } else {
+            IndexBoundsBuilder::allValuesForField(elt, oil);
+        }
+        ++fieldNo;
+    }
+
+    if (0 == numConstrainedFields) {
+        return NULL;
+    }
+
+    IndexBoundsBuilder::alignBounds(&isn->bounds, index.keyPattern);
+
+    // The bounds only narrow down the keys to examine. The fetch applies the whole query.
+    unique_ptr<FetchNode> fetch = make_unique<FetchNode>();
+    fetch->filter = std::move(query.root()->shallowClone());
+    fetch->children.push_back(isn.release());
+    return fetch.release();
+}
+
 // static
 void QueryPlannerAccess::addFilterToSolutionNode(QuerySolutionNode* node,
                                                  MatchExpression* match,
@@ -197,6 +197,18 @@ public:
                                              const QueryPlannerParams& params,
                                              int direction = 1);
 
+    /**
+     * Return a plan that uses a compound index for predicates over its non-leading fields, or
+     * NULL if 'query' has no such predicates or has predicates over the leading field.
+     *
+     * The leading fields are scanned over all values, so the index scan hops from one distinct
+     * value of the leading fields to the next one rather than reading every key. The whole
+     * query is applied as a filter after the fetch.
+     */
+    static QuerySolutionNode* skipScanIndex(const IndexEntry& index,
+                                            const CanonicalQuery& query,
+                                            const QueryPlannerParams& params);
+
     /**
      * Return a plan that scans the provided index from [startKey to endKey).
      */
@@ -281,6 +281,24 @@ void geoSkipValidationOn(const std::set<StringData>& twoDSphereFields,
     }
 }
 
+/**
+ * Returns the longest proper prefix of 'sortObj' that is one of the 'sorts' provided by a
+ * solution, or an empty object if there is none.
+ */
+BSONObj getProvidedSortPrefix(const BSONObj& sortObj, const BSONObjSet& sorts) {
+    BSONObj bestPrefix;
+    BSONObjBuilder prefixBob;
+    BSONObjIterator it(sortObj);
+    for (int numFields = 1; numFields < sortObj.nFields(); ++numFields) {
+        prefixBob.append(it.next());
+        BSONObj prefix = prefixBob.asTempObj();
+        if (sorts.end() != sorts.find(prefix)) {
+            bestPrefix = prefix.getOwned();
+        }
+    }
+    return bestPrefix;
+}
+
 }  // namespace
 
 // static
@@ -495,12 +513,56 @@ QuerySolutionNode* QueryPlannerAnalysis::analyzeSort(const CanonicalQuery& query
 
     // If we're here, we need to add a sort stage.
 
-    // If we're not allowed to put a blocking sort in, bail out.
+    // If we're not allowed to put a blocking sort in, bail out. A sort of runs equal on a sorted
+    // prefix is not blocking, but it still buffers each run under the in-memory sort limit and
+    // cannot spill. Callers which forbid blocking sorts do the sorting themselves, so leave it to
+    // them.
     if (params.options & QueryPlannerParams::NO_BLOCKING_SORT) {
         delete solnRoot;
         return NULL;
     }
 
+    // If the results are already ordered by a prefix of the sort pattern, the sort stage only has
+    // to order runs that are equal on that prefix. Such a sort is not blocking.
+    BSONObj sortedPrefix = getProvidedSortPrefix(sortObj, sorts);
+    if (sortedPrefix.isEmpty()) {
+        BSONObj reverseSortedPrefix = getProvidedSortPrefix(reverseSort, sorts);
+        if (!reverseSortedPrefix.isEmpty()) {
+            QueryPlannerCommon::reverseScans(solnRoot);
+            LOG(5) << "Reversing ixscan to provide sort prefix. Result: " << solnRoot->toString()
+                   << endl;
+            sortedPrefix = QueryPlannerCommon::reverseSortObj(reverseSortedPrefix);
+        }
+    }
+
+    if (!sortedPrefix.isEmpty()) {
+        if (!solnRoot->fetched()) {
+            FetchNode* fetch = new FetchNode();
+            fetch->children.push_back(solnRoot);
+            solnRoot = fetch;
+        }
+
+        SortNode* sort = new SortNode();
+        sort->pattern = sortObj;
+        sort->query = lpq.getFilter();
+        sort->sortedPrefix = sortedPrefix;
+        sort->children.push_back(solnRoot);
+
+        // Unlike a blocking sort, the stage stops reading as soon as it has returned its limit.
+        // That is only correct for a true limit, so a legacy ntoreturn which could be a batch
+        // size is not pushed down.
+        if (lpq.getLimit()) {
+            sort->limit = static_cast<size_t>(*lpq.getLimit()) +
+                static_cast<size_t>(lpq.getSkip().value_or(0));
+        } else if (!lpq.isFromFindCommand() && lpq.getBatchSize() && !lpq.wantMore()) {
+            sort->limit = static_cast<size_t>(*lpq.getBatchSize()) +
+                static_cast<size_t>(lpq.getSkip().value_or(0));
+        }
+
+        LOG(5) << "Sorting runs of results with equal " << sortedPrefix << endl;
+        return sort;
+    }
+
     // Add a fetch stage so we have the full object when we hit the sort stage.  TODO: Can we
     // pull the values that we sort by out of the key and if so in what cases?  Perhaps we can
     // avoid a fetch.
@@ -573,6 +635,13 @@ QuerySolutionNode* QueryPlannerAnalysis::analyzeSort(const CanonicalQuery& query
         sort->limit = 0;
     }
 
+    // A text search sorted by nothing but the text score only needs the documents which can
+    // make it into the sort's limit, which the TEXT stage can find without scoring every match.
+    if (sort->limit && STAGE_TEXT == sort->children[0]->getType() && 1 == sortObj.nFields() &&
+        LiteParsedQuery::isTextScoreMeta(sortObj.firstElement())) {
+        static_cast<TextNode*>(sort->children[0])->topK = sort->limit;
+    }
+
     *blockingSortOut = true;
 
     return solnRoot;
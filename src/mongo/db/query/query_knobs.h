@@ -54,6 +54,9 @@ extern bool internalQueryPlannerEnableIndexIntersection;
 // Do we use hash-based intersection for rooted $and queries?
 extern bool internalQueryPlannerEnableHashIntersection;
 
+// Do we consider skip scans over compound indexes whose leading fields are unconstrained?
+extern bool internalQueryPlannerEnableIndexSkipScan;
+
 //
 // plan cache
 //
@@ -95,6 +98,9 @@ extern int internalQueryMaxScansToExplode;
 
 extern int internalQueryExecMaxBlockingSortBytes;
 
+// Whether blocking sorts compare KeyString encodings of the sort keys rather than the keys.
+extern bool internalQueryExecSortUsingKeyStrings;
+
 // Yield after this many "should yield?" checks.
 extern int internalQueryExecYieldIterations;
 
@@ -99,12 +99,32 @@ string optionString(size_t options) {
         ss << "INDEX_INTERSECTION ";
     }
     if (options & QueryPlannerParams::KEEP_MUTATIONS) {
-        ss << "KEEP_MUTATIONS";
+        ss << "KEEP_MUTATIONS ";
+    }
+    if (options & QueryPlannerParams::INDEX_SKIP_SCAN) {
+        ss << "INDEX_SKIP_SCAN";
     }
 
     return ss;
 }
 
+/**
+ * Returns true if 'node' or any of its descendants is a SORT which only sorts runs of input
+ * that an index already delivers in order of a prefix of the requested sort.
+ */
+static bool hasPartialSort(const QuerySolutionNode* node) {
+    if (STAGE_SORT == node->getType() &&
+        !static_cast<const SortNode*>(node)->sortedPrefix.isEmpty()) {
+        return true;
+    }
+    for (size_t i = 0; i < node->children.size(); ++i) {
+        if (hasPartialSort(node->children[i])) {
+            return true;
+        }
+    }
+    return false;
+}
+
 static BSONObj getKeyFromQuery(const BSONObj& keyPattern, const BSONObj& query) {
     return query.extractFieldsUnDotted(keyPattern);
 }
@@ -228,6 +248,16 @@ QuerySolution* buildWholeIXSoln(const IndexEntry& index,
     return QueryPlannerAnalysis::analyzeDataAccess(query, params, solnRoot);
 }
 
+QuerySolution* buildSkipScanSoln(const IndexEntry& index,
+                                 const CanonicalQuery& query,
+                                 const QueryPlannerParams& params) {
+    QuerySolutionNode* solnRoot = QueryPlannerAccess::skipScanIndex(index, query, params);
+    if (NULL == solnRoot) {
+        return NULL;
+    }
+    return QueryPlannerAnalysis::analyzeDataAccess(query, params, solnRoot);
+}
+
 bool providesSort(const CanonicalQuery& query, const BSONObj& kp) {
     return query.getParsed().getSort().isPrefixOf(kp);
 }
@@ -354,6 +384,14 @@ Status QueryPlanner::planFromCache(const CanonicalQuery& query,
             *out = soln;
             return Status::OK();
         }
+    } else if (SolutionCacheData::SKIP_SCAN_SOLN == winnerCacheData.solnType) {
+        QuerySolution* soln = buildSkipScanSoln(*winnerCacheData.tree->entry, query, params);
+        if (soln == NULL) {
+            return Status(ErrorCodes::BadValue, "plan cache error: skip scan soln");
+        } else {
+            *out = soln;
+            return Status::OK();
+        }
     } else if (SolutionCacheData::COLLSCAN_SOLN == winnerCacheData.solnType) {
         // The cached solution is a collection scan. We don't cache collscans
         // with tailable==true, hence the false below.
@@ -812,6 +850,43 @@ Status QueryPlanner::plan(const CanonicalQuery& query,
         return Status::OK();
     }
 
+    // If no index can be used for the query's predicates the regular way, a compound index may
+    // still be used for predicates over its non-leading fields by skipping over the distinct
+    // values of the leading fields. Whether that beats a collection scan depends on the
+    // number of distinct values, so the collection scan remains a candidate.
+    size_t numSkipScanSolns = 0;
+    if (0 == out->size() && (params.options & QueryPlannerParams::INDEX_SKIP_SCAN) &&
+        !QueryPlannerCommon::hasNode(query.root(), MatchExpression::GEO_NEAR) &&
+        !QueryPlannerCommon::hasNode(query.root(), MatchExpression::TEXT)) {
+        for (size_t i = 0; i < params.indices.size(); ++i) {
+            const IndexEntry& index = params.indices[i];
+            // A sparse or partial index may not contain all the documents that match.
+            if (index.type != INDEX_BTREE || index.sparse || index.filterExpr) {
+                continue;
+            }
+            if (index.keyPattern.nFields() < 2) {
+                continue;
+            }
+
+            QuerySolution* soln = buildSkipScanSoln(index, query, params);
+            if (NULL == soln) {
+                continue;
+            }
+
+            LOG(5) << "Planner: outputting soln that skip scans index " << index.name << ":"
+                   << endl
+                   << soln->toString();
+            PlanCacheIndexTree* indexTree = new PlanCacheIndexTree();
+            indexTree->setIndexEntry(index);
+            SolutionCacheData* scd = new SolutionCacheData();
+            scd->tree.reset(indexTree);
+            scd->solnType = SolutionCacheData::SKIP_SCAN_SOLN;
+            soln->cacheData.reset(scd);
+            out->push_back(soln);
+            ++numSkipScanSolns;
+        }
+    }
+
     // If a sort order is requested, there may be an index that provides it, even if that
     // index is not over any predicates in the query.
     //
@@ -819,11 +894,12 @@ Status QueryPlanner::plan(const CanonicalQuery& query,
         !QueryPlannerCommon::hasNode(query.root(), MatchExpression::GEO_NEAR) &&
         !QueryPlannerCommon::hasNode(query.root(), MatchExpression::TEXT)) {
         // See if we have a sort provided from an index already.
-        // This is implied by the presence of a non-blocking solution.
+        // This is implied by the presence of a non-blocking solution which does not have to
+        // sort runs of an index-provided sort prefix.
         bool usingIndexToSort = false;
         for (size_t i = 0; i < out->size(); ++i) {
             QuerySolution* soln = (*out)[i];
-            if (!soln->hasBlockingStage) {
+            if (!soln->hasBlockingStage && !hasPartialSort(soln->root.get())) {
                 usingIndexToSort = true;
                 break;
             }
@@ -907,7 +983,8 @@ Status QueryPlanner::plan(const CanonicalQuery& query,
     bool collscanRequested = (params.options & QueryPlannerParams::INCLUDE_COLLSCAN);
 
     // No indexed plans?  We must provide a collscan if possible or else we can't run the query.
-    bool collscanNeeded = (0 == out->size() && canTableScan);
+    // Skip scans only compete with the collscan.
+    bool collscanNeeded = (numSkipScanSolns == out->size() && canTableScan);
 
     if (possibleToCollscan && (collscanRequested || collscanNeeded)) {
         QuerySolution* collscan = buildCollscanSoln(query, isTailable, params);
@@ -92,6 +92,11 @@ struct QueryPlannerParams {
         // collection scan. The MMAPv1 storage engine sets this option since it cannot
         // guarantee that a collection scan won't miss documents or return duplicates.
         SNAPSHOT_USE_ID = 1 << 9,
+
+        // Set this if you want the planner to use compound indexes for predicates over their
+        // non-leading fields when no other index applies, by skipping over the distinct values
+        // of the leading fields.
+        INDEX_SKIP_SCAN = 1 << 10,
     };
 
     // See Options enum above.
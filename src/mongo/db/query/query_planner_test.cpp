@@ -3458,6 +3458,149 @@ TEST_F(QueryPlannerTest, EnumerateNestedOr2) {
     assertSolutionExists("{fetch: {node: {ixscan: {pattern: {b: 1}}}}}");
 }
 
+//
+// Sorting runs of results from an index which provides a prefix of the sort.
+//
+
+TEST_F(QueryPlannerTest, SortedPrefixFromIndexWithLimit) {
+    addIndex(BSON("a" << 1));
+    runQuerySortProjSkipLimit(
+        fromjson("{a: {$gt: 0}}"), fromjson("{a: 1, b: 1}"), BSONObj(), 0, -3);
+
+    assertNumSolutions(2U);
+    assertSolutionExists(
+        "{sort: {pattern: {a: 1, b: 1}, limit: 3, sortedPrefix: {}, "
+        "node: {cscan: {dir: 1}}}}");
+    assertSolutionExists(
+        "{limit: {n: 3, node: {sort: {pattern: {a: 1, b: 1}, limit: 3, sortedPrefix: {a: 1}, "
+        "node: {fetch: {node: {ixscan: {pattern: {a: 1}, dir: 1}}}}}}}}");
+}
+
+TEST_F(QueryPlannerTest, SortedPrefixFromReversedIndex) {
+    addIndex(BSON("a" << 1 << "c" << 1));
+    runQuerySortProj(fromjson("{a: {$gt: 0}}"), fromjson("{a: -1, b: 1}"), BSONObj());
+
+    assertNumSolutions(2U);
+    assertSolutionExists(
+        "{sort: {pattern: {a: -1, b: 1}, limit: 0, sortedPrefix: {}, "
+        "node: {cscan: {dir: 1}}}}");
+    assertSolutionExists(
+        "{sort: {pattern: {a: -1, b: 1}, limit: 0, sortedPrefix: {a: -1}, node: "
+        "{fetch: {node: {ixscan: {pattern: {a: 1, c: 1}, dir: -1}}}}}}");
+}
+
+TEST_F(QueryPlannerTest, SortedPrefixDoesNotHideIndexProvidingFullSort) {
+    addIndex(BSON("c" << 1 << "a" << 1));
+    addIndex(BSON("a" << 1 << "b" << 1));
+    runQuerySortProjSkipLimit(fromjson("{c: 5}"), fromjson("{a: 1, b: 1}"), BSONObj(), 0, -3);
+
+    assertNumSolutions(3U);
+    assertSolutionExists(
+        "{sort: {pattern: {a: 1, b: 1}, limit: 3, sortedPrefix: {}, "
+        "node: {cscan: {dir: 1}}}}");
+    assertSolutionExists(
+        "{limit: {n: 3, node: {sort: {pattern: {a: 1, b: 1}, limit: 3, sortedPrefix: {a: 1}, "
+        "node: {fetch: {node: {ixscan: {pattern: {c: 1, a: 1}, dir: 1}}}}}}}}");
+    assertSolutionExists(
+        "{limit: {n: 3, node: {fetch: {filter: {c: 5}, node: "
+        "{ixscan: {pattern: {a: 1, b: 1}, dir: 1}}}}}}");
+}
+
+TEST_F(QueryPlannerTest, SortedPrefixWithLongerPrefix) {
+    addIndex(BSON("a" << 1 << "b" << 1));
+    runQuerySortProj(fromjson("{a: {$gt: 0}}"), fromjson("{a: 1, b: 1, c: 1}"), BSONObj());
+
+    assertNumSolutions(2U);
+    assertSolutionExists(
+        "{sort: {pattern: {a: 1, b: 1, c: 1}, limit: 0, sortedPrefix: {}, "
+        "node: {cscan: {dir: 1}}}}");
+    assertSolutionExists(
+        "{sort: {pattern: {a: 1, b: 1, c: 1}, limit: 0, sortedPrefix: {a: 1, b: 1}, node: "
+        "{fetch: {node: {ixscan: {pattern: {a: 1, b: 1}, dir: 1}}}}}}");
+}
+
+TEST_F(QueryPlannerTest, SortedPrefixNotUsedWithoutBlockingSorts) {
+    // Aggregation forbids blocking sorts in the plan and sorts in the pipeline instead, where it
+    // can spill to disk. A sort of runs in the plan would only add an in-memory limit.
+    params.options = QueryPlannerParams::NO_BLOCKING_SORT;
+    addIndex(BSON("a" << 1));
+    runQuerySortProj(fromjson("{a: {$gt: 0}}"), fromjson("{a: 1, b: 1}"), BSONObj());
+    assertNumSolutions(0U);
+}
+
+//
+// Skip scans over compound indexes whose leading fields are unconstrained.
+//
+
+TEST_F(QueryPlannerTest, SkipScanNonLeadingField) {
+    // The collection scan is a candidate even if it is not explicitly requested.
+    params.options = QueryPlannerParams::INDEX_SKIP_SCAN;
+    addIndex(BSON("a" << 1 << "b" << 1));
+    runQuery(fromjson("{b: 5}"));
+
+    assertNumSolutions(2U);
+    assertSolutionExists("{cscan: {dir: 1, filter: {b: 5}}}");
+    assertSolutionExists(
+        "{fetch: {filter: {b: 5}, node: {ixscan: {pattern: {a: 1, b: 1}, bounds: "
+        "{a: [['MinKey','MaxKey',true,true]], b: [[5,5,true,true]]}}}}}");
+}
+
+TEST_F(QueryPlannerTest, SkipScanIntersectsBoundsForNonMultikeyIndex) {
+    params.options |= QueryPlannerParams::INDEX_SKIP_SCAN;
+    addIndex(BSON("a" << 1 << "b" << 1 << "c" << 1));
+    runQuery(fromjson("{b: {$gt: 1, $lt: 5}, c: 2, d: 3}"));
+
+    assertNumSolutions(2U);
+    assertSolutionExists("{cscan: {dir: 1}}");
+    assertSolutionExists(
+        "{fetch: {node: {ixscan: "
+        "{pattern: {a: 1, b: 1, c: 1}, bounds: {a: [['MinKey','MaxKey',true,true]], "
+        "b: [[1,5,false,false]], c: [[2,2,true,true]]}}}}}");
+}
+
+TEST_F(QueryPlannerTest, SkipScanConstrainsOnePredicateOfMultikeyIndex) {
+    params.options |= QueryPlannerParams::INDEX_SKIP_SCAN;
+    // true means multikey
+    addIndex(BSON("a" << 1 << "b" << 1 << "c" << 1), true);
+    runQuery(fromjson("{b: {$gt: 1, $lt: 5}, c: 2}"));
+
+    assertNumSolutions(2U);
+    assertSolutionExists("{cscan: {dir: 1}}");
+    assertSolutionExists(
+        "{fetch: {node: {ixscan: "
+        "{pattern: {a: 1, b: 1, c: 1}, bounds: {a: [['MinKey','MaxKey',true,true]], "
+        "b: [[-Infinity,5,true,false]], c: [['MinKey','MaxKey',true,true]]}}}}}");
+}
+
+TEST_F(QueryPlannerTest, NoSkipScanWhenLeadingFieldIsConstrained) {
+    params.options |= QueryPlannerParams::INDEX_SKIP_SCAN;
+    addIndex(BSON("a" << 1 << "b" << 1));
+    runQuery(fromjson("{a: 1, b: 5}"));
+
+    assertNumSolutions(2U);
+    assertSolutionExists("{cscan: {dir: 1}}");
+    assertSolutionExists(
+        "{fetch: {filter: null, node: {ixscan: {pattern: {a: 1, b: 1}, bounds: "
+        "{a: [[1,1,true,true]], b: [[5,5,true,true]]}}}}}");
+}
+
+TEST_F(QueryPlannerTest, NoSkipScanOverSparseIndex) {
+    params.options |= QueryPlannerParams::INDEX_SKIP_SCAN;
+    addIndex(BSON("a" << 1 << "b" << 1), false, true);
+    runQuery(fromjson("{b: 5}"));
+
+    assertNumSolutions(1U);
+    assertSolutionExists("{cscan: {dir: 1, filter: {b: 5}}}");
+}
+
+TEST_F(QueryPlannerTest, NoSkipScanUnlessRequested) {
+    addIndex(BSON("a" << 1 << "b" << 1));
+    runQuery(fromjson("{b: 5}"));
+
+    assertNumSolutions(1U);
+    assertSolutionExists("{cscan: {dir: 1, filter: {b: 5}}}");
+}
+
 //
 // Test the "split limited sort stages" hack.
 //
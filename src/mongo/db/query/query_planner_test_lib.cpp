@@ -327,6 +327,13 @@ bool QueryPlannerTestLib::solutionMatches(const BSONObj& testSoln,
             }
         }
 
+        BSONElement topK = textObj["topK"];
+        if (!topK.eoo()) {
+            if (!topK.isNumber() || static_cast<size_t>(topK.numberLong()) != node->topK) {
+                return false;
+            }
+        }
+
         BSONElement filter = textObj["filter"];
         if (!filter.eoo()) {
             if (filter.isNull()) {
@@ -476,6 +483,14 @@ bool QueryPlannerTestLib::solutionMatches(const BSONObj& testSoln,
             return false;
         }
 
+        // The sorted prefix is only checked if the test specifies one.
+        BSONElement sortedPrefixEl = sortObj["sortedPrefix"];
+        if (!sortedPrefixEl.eoo()) {
+            if (!sortedPrefixEl.isABSONObj() || sortedPrefixEl.Obj() != sn->sortedPrefix) {
+                return false;
+            }
+        }
+
         size_t expectedLimit = limitEl.numberInt();
         return (patternEl.Obj() == sn->pattern) && (expectedLimit == sn->limit) &&
             solutionMatches(child.Obj(), sn->children[0]);
@@ -402,4 +402,53 @@ TEST_F(QueryPlannerTest, TextCaseSensitive) {
     assertSolutionExists("{text: {search: 'blah', caseSensitive: true}}");
 }
 
+TEST_F(QueryPlannerTest, TextSortedByScoreWithLimitUsesTopK) {
+    addIndex(BSON("_fts"
+                  << "text"
+                  << "_ftsx" << 1));
+    runQuerySortProjSkipLimit(fromjson("{$text: {$search: 'blah'}}"),
+                              fromjson("{score: {$meta: 'textScore'}}"),
+                              fromjson("{score: {$meta: 'textScore'}}"),
+                              5,
+                              10);
+
+    assertNumSolutions(1U);
+    assertSolutionExists(
+        "{skip: {n: 5, node: {proj: {spec: {score: {$meta: 'textScore'}}, node: "
+        "{sort: {pattern: {score: {$meta: 'textScore'}}, limit: 15, node: "
+        "{text: {search: 'blah', topK: 15}}}}}}}}");
+}
+
+TEST_F(QueryPlannerTest, TextSortedByScoreWithoutLimitDoesNotUseTopK) {
+    addIndex(BSON("_fts"
+                  << "text"
+                  << "_ftsx" << 1));
+    runQuerySortProj(fromjson("{$text: {$search: 'blah'}}"),
+                     fromjson("{score: {$meta: 'textScore'}}"),
+                     fromjson("{score: {$meta: 'textScore'}}"));
+
+    assertNumSolutions(1U);
+    assertSolutionExists(
+        "{proj: {spec: {score: {$meta: 'textScore'}}, node: "
+        "{sort: {pattern: {score: {$meta: 'textScore'}}, limit: 0, node: "
+        "{text: {search: 'blah', topK: 0}}}}}}");
+}
+
+TEST_F(QueryPlannerTest, TextSortedByScoreAndOtherFieldDoesNotUseTopK) {
+    addIndex(BSON("_fts"
+                  << "text"
+                  << "_ftsx" << 1));
+    runQuerySortProjSkipLimit(fromjson("{$text: {$search: 'blah'}}"),
+                              fromjson("{score: {$meta: 'textScore'}, a: 1}"),
+                              fromjson("{score: {$meta: 'textScore'}}"),
+                              0,
+                              10);
+
+    assertNumSolutions(1U);
+    assertSolutionExists(
+        "{proj: {spec: {score: {$meta: 'textScore'}}, node: "
+        "{sort: {pattern: {score: {$meta: 'textScore'}, a: 1}, limit: 10, node: "
+        "{text: {search: 'blah', topK: 0}}}}}}");
+}
+
 }  // namespace
@@ -80,6 +80,10 @@ void TextNode::appendToString(mongoutils::str::stream* ss, int indent) const {
     *ss << "caseSensitive= " << caseSensitive << '\n';
     addIndent(ss, indent + 1);
     *ss << "indexPrefix = " << indexPrefix.toString() << '\n';
+    if (topK) {
+        addIndent(ss, indent + 1);
+        *ss << "topK = " << topK << '\n';
+    }
     if (NULL != filter) {
         addIndent(ss, indent + 1);
         *ss << " filter = " << filter->toString();
@@ -97,6 +101,7 @@ QuerySolutionNode* TextNode::clone() const {
     copy->language = this->language;
     copy->caseSensitive = this->caseSensitive;
     copy->indexPrefix = this->indexPrefix;
+    copy->topK = this->topK;
 
     return copy;
 }
@@ -650,6 +655,10 @@ void SortNode::appendToString(mongoutils::str::stream* ss, int indent) const {
     *ss << "query for bounds = " << query.toString() << '\n';
     addIndent(ss, indent + 1);
     *ss << "limit = " << limit << '\n';
+    if (!sortedPrefix.isEmpty()) {
+        addIndent(ss, indent + 1);
+        *ss << "sorted prefix = " << sortedPrefix.toString() << '\n';
+    }
     addCommon(ss, indent);
     addIndent(ss, indent + 1);
     *ss << "Child:" << '\n';
@@ -664,6 +673,7 @@ QuerySolutionNode* SortNode::clone() const {
     copy->pattern = this->pattern;
     copy->query = this->query;
     copy->limit = this->limit;
+    copy->sortedPrefix = this->sortedPrefix;
 
     return copy;
 }
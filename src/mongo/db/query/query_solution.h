@@ -219,7 +219,7 @@ private:
 };
 
 struct TextNode : public QuerySolutionNode {
-    TextNode() {}
+    TextNode() : topK(0) {}
     virtual ~TextNode() {}
 
     virtual StageType getType() const {
@@ -255,6 +255,10 @@ struct TextNode : public QuerySolutionNode {
     // text node while creating the text leaf node and convert them into a BSONObj index prefix
     // when we finish the text leaf node.
     BSONObj indexPrefix;
+
+    // If non-zero, only the 'topK' documents with the highest text scores are needed, as the
+    // parent sorts by text score and keeps that many results.
+    size_t topK;
 };
 
 struct CollectionScanNode : public QuerySolutionNode {
@@ -604,6 +608,10 @@ struct SortNode : public QuerySolutionNode {
 
     // Sum of both limit and skip count in the parsed query.
     size_t limit;
+
+    // A prefix of 'pattern' by which the child already orders its results. If non-empty, the
+    // sort only has to order runs of results that are equal on the prefix and is not blocking.
+    BSONObj sortedPrefix;
 };
 
 struct LimitNode : public QuerySolutionNode {
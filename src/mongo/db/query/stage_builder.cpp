@@ -117,6 +117,7 @@ PlanStage* buildStages(OperationContext* txn,
         params.pattern = sn->pattern;
         params.query = sn->query;
         params.limit = sn->limit;
+        params.sortedPrefix = sn->sortedPrefix;
         return new SortStage(txn, params, ws, childStage);
     } else if (STAGE_PROJECTION == root->getType()) {
         const ProjectionNode* pn = static_cast<const ProjectionNode*>(root);
@@ -267,6 +268,7 @@ PlanStage* buildStages(OperationContext* txn,
         params.index = index;
         params.spec = fam->getSpec();
         params.indexPrefix = node->indexPrefix;
+        params.topK = node->topK;
 
         const std::string& language =
             ("" == node->language ? fam->getSpec().defaultLanguage().str() : node->language);
@@ -32,6 +32,7 @@
 
 #include "mongo/db/repl/bgsync.h"
 
+#include <iterator>
 #include <memory>
 
 #include "mongo/base/counter.h"
@@ -51,6 +52,7 @@
 #include "mongo/db/repl/rollback_source_impl.h"
 #include "mongo/db/repl/rs_rollback.h"
 #include "mongo/db/repl/rs_sync.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/stats/timer_stats.h"
 #include "mongo/executor/network_interface_factory.h"
 #include "mongo/executor/thread_pool_task_executor.h"
@@ -62,6 +64,7 @@
 #include "mongo/util/mongoutils/str.h"
 #include "mongo/util/scopeguard.h"
 #include "mongo/util/time_support.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
@@ -73,6 +76,7 @@ namespace {
 const char hashFieldName[] = "h";
 int SleepToAllowBatchingMillis = 2;
 const int BatchIsSmallish = 40000;  // bytes
+const int BufferPushChunkBytes = 1024 * 1024;  // bytes pushed per lock acquisition
 const Milliseconds fetcherMaxTimeMS(2000);
 
 /**
@@ -130,10 +134,36 @@ static ServerStatusMetricField<Counter64> displayBufferCount("repl.buffer.count"
 static Counter64 bufferSizeGauge;
 static ServerStatusMetricField<Counter64> displayBufferSize("repl.buffer.sizeBytes",
                                                             &bufferSizeGauge);
-// The max size (bytes) of the buffer
-static int bufferMaxSizeGauge = 256 * 1024 * 1024;
+// The max size (bytes) of the buffer. Once the buffer holds this many bytes the fetcher stops
+// issuing getMores until the applier has caught up.
+int replBufferMaxSizeBytes = 256 * 1024 * 1024;
+
+class ExportedBufferMaxSizeParameter : public ExportedServerParameter<int> {
+public:
+    ExportedBufferMaxSizeParameter()
+        : ExportedServerParameter<int>(ServerParameterSet::getGlobal(),
+                                       "replBufferMaxSizeBytes",
+                                       &replBufferMaxSizeBytes,
+                                       true,   // allowedToChangeAtStartup
+                                       false)  // allowedToChangeAtRuntime
+    {}
+
+    virtual Status validate(const int& potentialNewValue) {
+        if (potentialNewValue <= 0) {
+            return Status(ErrorCodes::BadValue, "replBufferMaxSizeBytes must be greater than 0");
+        }
+        return Status::OK();
+    }
+
+} exportedBufferMaxSizeParam;
+
 static ServerStatusMetricField<int> displayBufferMaxSize("repl.buffer.maxSizeBytes",
-                                                         &bufferMaxSizeGauge);
+                                                         &replBufferMaxSizeBytes);
+// The number and time spent waiting for room in the buffer, i.e. waiting on the applier rather
+// than on the network
+static TimerStats bufferWaitStats;
+static ServerStatusMetricField<TimerStats> displayBufferWaits("repl.buffer.waitForSpace",
+                                                              &bufferWaitStats);
 
 
 BackgroundSyncInterface::~BackgroundSyncInterface() {}
@@ -146,7 +176,7 @@ size_t getSize(const BSONObj& o) {
 }  // namespace
 
 BackgroundSync::BackgroundSync()
-    : _buffer(bufferMaxSizeGauge, &getSize),
+    : _buffer(replBufferMaxSizeBytes, &getSize),
       _lastOpTimeFetched(Timestamp(std::numeric_limits<int>::max(), 0),
                          std::numeric_limits<long long>::max()),
       _lastFetchedHash(0),
@@ -423,7 +453,8 @@ void BackgroundSync::_fetcherCallback(const StatusWith<Fetcher::QueryResponse>&
 
     // process documents
     int currentBatchMessageSize = 0;
-    for (auto documentIter = documentBegin; documentIter != documentEnd; ++documentIter) {
+    auto chunkBegin = documentBegin;
+    while (chunkBegin != documentEnd) {
         if (inShutdown()) {
             return;
         }
@@ -435,11 +466,19 @@ void BackgroundSync::_fetcherCallback(const StatusWith<Fetcher::QueryResponse>&
             return;
         }
 
-        // At this point, we are guaranteed to have at least one thing to read out
-        // of the fetcher.
-        const BSONObj& o = *documentIter;
-        currentBatchMessageSize += o.objsize();
-        opsReadStats.increment();
+        // The batch is handed to the buffer a chunk at a time, each under a single acquisition
+        // of the buffer's lock. Pushing only blocks when the buffer is full, which means we are
+        // limited by the applier rather than by the network, so the conditions above are checked
+        // again after every wait.
+        int chunkSize = 0;
+        auto chunkEnd = chunkBegin;
+        while (chunkEnd != documentEnd && chunkSize < BufferPushChunkBytes) {
+            chunkSize += chunkEnd->objsize();
+            ++chunkEnd;
+        }
+        const long long chunkOps = std::distance(chunkBegin, chunkEnd);
+        currentBatchMessageSize += chunkSize;
+        opsReadStats.increment(chunkOps);
 
         if (MONGO_FAIL_POINT(stepDownWhileDrainingFailPoint)) {
             sleepsecs(20);
@@ -454,16 +493,21 @@ void BackgroundSync::_fetcherCallback(const StatusWith<Fetcher::QueryResponse>&
             LOG(2) << "bgsync buffer has " << _buffer.size() << " bytes";
         }
 
-        bufferCountGauge.increment();
-        bufferSizeGauge.increment(getSize(o));
-        _buffer.push(o);
+        bufferCountGauge.increment(chunkOps);
+        bufferSizeGauge.increment(chunkSize);
+        Timer bufferWaitTimer;
+        _buffer.pushAllBlocking(chunkBegin, chunkEnd);
+        bufferWaitStats.record(bufferWaitTimer);
 
+        const BSONObj& lastDoc = *std::prev(chunkEnd);
         {
             stdx::unique_lock<stdx::mutex> lock(_mutex);
-            _lastFetchedHash = o["h"].numberLong();
-            _lastOpTimeFetched = extractOpTime(o);
+            _lastFetchedHash = lastDoc["h"].numberLong();
+            _lastOpTimeFetched = extractOpTime(lastDoc);
             LOG(3) << "lastOpTimeFetched: " << _lastOpTimeFetched;
         }
+
+        chunkBegin = chunkEnd;
     }
 
     // record time for each batch
@@ -474,14 +518,16 @@ void BackgroundSync::_fetcherCallback(const StatusWith<Fetcher::QueryResponse>&
     // Check some things periodically
     // (whenever we run out of items in the
     // current cursor batch)
-    if (currentBatchMessageSize > 0 && currentBatchMessageSize < BatchIsSmallish) {
+    if (currentBatchMessageSize > 0 && currentBatchMessageSize < BatchIsSmallish &&
+        queryResponse.elapsedMillis < Milliseconds(SleepToAllowBatchingMillis)) {
         // on a very low latency network, if we don't wait a little, we'll be
         // getting ops to write almost one at a time.  this will both be expensive
         // for the upstream server as well as potentially defeating our parallel
         // application of batches on the secondary.
         //
         // the inference here is basically if the batch is really small, we are
-        // "caught up".
+        // "caught up".  on a high latency link the round trip itself already gives
+        // the primary time to accumulate ops, so sleeping would only add latency.
         //
         sleepmillis(SleepToAllowBatchingMillis);
     }
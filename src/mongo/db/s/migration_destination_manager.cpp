@@ -50,6 +50,7 @@
 #include "mongo/db/operation_context.h"
 #include "mongo/db/operation_context_impl.h"
 #include "mongo/db/ops/delete.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/range_deleter_service.h"
 #include "mongo/db/repl/repl_client_info.h"
 #include "mongo/db/repl/replication_coordinator_global.h"
@@ -62,6 +63,9 @@
 #include "mongo/s/grid.h"
 #include "mongo/s/shard_key_pattern.h"
 #include "mongo/stdx/chrono.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/util/elapsed_tracker.h"
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
@@ -161,6 +165,96 @@ bool opReplicatedEnough(OperationContext* txn,
     return majorityStatus.isOK() && userStatus.isOK();
 }
 
+/**
+ * Fetches the batches of documents to clone from the donor with _migrateClone on a thread of its
+ * own, one batch ahead of the caller, so that the next batch is transferred while the current
+ * one is applied. Nothing else may use the connection until the fetcher is destroyed.
+ */
+class CloneBatchFetcher {
+    MONGO_DISALLOW_COPYING(CloneBatchFetcher);
+
+public:
+    explicit CloneBatchFetcher(DBClientBase* conn)
+        : _conn(conn), _thread(stdx::bind(&CloneBatchFetcher::_run, this)) {}
+
+    ~CloneBatchFetcher() {
+        {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            _shutdown = true;
+        }
+        _cv.notify_all();
+
+        // Waits for a _migrateClone which is still in flight to return.
+        _thread.join();
+    }
+
+    /**
+     * Waits for the next batch. Returns whether _migrateClone succeeded, and its response in
+     * 'res'. No batch follows a failed one or one without any objects.
+     */
+    bool next(BSONObj* res) {
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        while (!_hasBatch) {
+            _cv.wait(lk);
+        }
+
+        *res = _batch;
+        _batch = BSONObj();
+        _hasBatch = false;
+        _cv.notify_all();
+        return _batchOK;
+    }
+
+private:
+    void _run() {
+        Client::initThread("migrateCloneFetcher");
+
+        while (true) {
+            BSONObj res;
+            bool ok;
+            try {
+                ok = _conn->runCommand("admin", BSON("_migrateClone" << 1), res);
+            } catch (const DBException& ex) {
+                ok = false;
+                res = BSON("errmsg" << ex.toString());
+            }
+
+            const bool lastBatch =
+                !ok || !res["objects"].isABSONObj() || res["objects"].Obj().isEmpty();
+
+            stdx::unique_lock<stdx::mutex> lk(_mutex);
+            while (_hasBatch && !_shutdown) {
+                _cv.wait(lk);
+            }
+            if (_shutdown) {
+                return;
+            }
+
+            _batch = res.getOwned();
+            _batchOK = ok;
+            _hasBatch = true;
+            _cv.notify_all();
+
+            if (lastBatch) {
+                return;
+            }
+        }
+    }
+
+    DBClientBase* const _conn;
+
+    // Protects the members below, which hand each batch over to the caller.
+    stdx::mutex _mutex;
+    stdx::condition_variable _cv;
+    BSONObj _batch;
+    bool _batchOK = false;
+    bool _hasBatch = false;
+    bool _shutdown = false;
+
+    // Started last, once the members it uses are initialized.
+    stdx::thread _thread;
+};
+
 }  // namespace
 
 // Enabling / disabling these fail points pauses / resumes MigrateStatus::_go(), the thread which
@@ -561,11 +655,10 @@ void MigrationDestinationManager::_migrateDriver(OperationContext* txn,
         // 3. Initial bulk clone
         setState(CLONE);
 
+        CloneBatchFetcher fetcher(conn.get());
         while (true) {
             BSONObj res;
-            if (!conn->runCommand("admin",
-                                  BSON("_migrateClone" << 1),
-                                  res)) {  // gets array of objects to copy, in disk order
+            if (!fetcher.next(&res)) {  // gets array of objects to copy, in shard key order
                 setState(FAIL);
                 errmsg = "_migrateClone failed: ";
                 errmsg += res.toString();
@@ -575,44 +668,65 @@ void MigrationDestinationManager::_migrateDriver(OperationContext* txn,
             }
 
             BSONObj arr = res["objects"].Obj();
-            int thisTime = 0;
+            if (arr.isEmpty()) {
+                break;
+            }
 
             BSONObjIterator i(arr);
             while (i.more()) {
-                txn->checkForInterrupt();
-
-                if (getState() == ABORT) {
-                    errmsg = str::stream() << "Migration abort requested while "
-                                           << "copying documents";
-                    error() << errmsg << migrateLog;
-                    return;
-                }
+                long long numApplied = 0;
+                long long bytesApplied = 0;
 
-                BSONObj docToClone = i.next().Obj();
                 {
+                    // Apply as many documents as possible under one lock acquisition, but release
+                    // the lock periodically to let other operations through.
+                    ElapsedTracker tracker(internalQueryExecYieldIterations,
+                                           internalQueryExecYieldPeriodMS);
                     OldClientWriteContext cx(txn, ns);
 
-                    BSONObj localDoc;
-                    if (willOverrideLocalId(
-                            txn, ns, min, max, shardKeyPattern, cx.db(), docToClone, &localDoc)) {
-                        string errMsg = str::stream() << "cannot migrate chunk, local document "
-                                                      << localDoc << " has same _id as cloned "
-                                                      << "remote document " << docToClone;
-
-                        warning() << errMsg;
-
-                        // Exception will abort migration cleanly
-                        uasserted(16976, errMsg);
+                    while (i.more() && !tracker.intervalHasElapsed()) {
+                        txn->checkForInterrupt();
+
+                        if (getState() == ABORT) {
+                            errmsg = str::stream() << "Migration abort requested while "
+                                                   << "copying documents";
+                            error() << errmsg << migrateLog;
+                            return;
+                        }
+
+                        BSONObj docToClone = i.next().Obj();
+
+                        BSONObj localDoc;
+                        if (willOverrideLocalId(txn,
+                                                ns,
+                                                min,
+                                                max,
+                                                shardKeyPattern,
+                                                cx.db(),
+                                                docToClone,
+                                                &localDoc)) {
+                            string errMsg = str::stream()
+                                << "cannot migrate chunk, local document " << localDoc
+                                << " has same _id as cloned "
+                                << "remote document " << docToClone;
+
+                            warning() << errMsg;
+
+                            // Exception will abort migration cleanly
+                            uasserted(16976, errMsg);
+                        }
+
+                        Helpers::upsert(txn, ns, docToClone, true);
+
+                        numApplied++;
+                        bytesApplied += docToClone.objsize();
                     }
-
-                    Helpers::upsert(txn, ns, docToClone, true);
                 }
-                thisTime++;
 
                 {
                     stdx::lock_guard<stdx::mutex> statsLock(_mutex);
-                    _numCloned++;
-                    _clonedBytes += docToClone.objsize();
+                    _numCloned += numApplied;
+                    _clonedBytes += bytesApplied;
                 }
 
                 if (writeConcern.shouldWaitForOtherNodes()) {
@@ -629,9 +743,6 @@ void MigrationDestinationManager::_migrateDriver(OperationContext* txn,
                     }
                 }
             }
-
-            if (thisTime == 0)
-                break;
         }
 
         timing.done(3);
@@ -32,14 +32,13 @@
 
 #include "mongo/db/s/migration_source_manager.h"
 
-#include <set>
 #include <vector>
 
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/concurrency/d_concurrency.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/dbhelpers.h"
-#include "mongo/db/exec/plan_stage.h"
+#include "mongo/db/exec/working_set_common.h"
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/query/internal_plans.h"
@@ -61,46 +60,6 @@ namespace {
 
 Tee* migrateLog = RamLog::get("migrate");
 
-/**
- * Used to receive invalidation notifications.
- *
- * XXX: move to the exec/ directory.
- */
-class DeleteNotificationStage final : public PlanStage {
-public:
-    DeleteNotificationStage(MigrationSourceManager* migrationSourceManager)
-        : PlanStage("NOTIFY_DELETE", nullptr), _migrationSourceManager(migrationSourceManager) {}
-
-    void doInvalidate(OperationContext* txn, const RecordId& dl, InvalidationType type) override {
-        if (type == INVALIDATION_DELETION) {
-            _migrationSourceManager->aboutToDelete(dl);
-        }
-    }
-
-    StageState work(WorkingSetID* out) override {
-        MONGO_UNREACHABLE;
-    }
-
-    bool isEOF() final {
-        MONGO_UNREACHABLE;
-    }
-
-    unique_ptr<PlanStageStats> getStats() final {
-        MONGO_UNREACHABLE;
-    }
-
-    SpecificStats* getSpecificStats() const final {
-        MONGO_UNREACHABLE;
-    }
-
-    StageType stageType() const final {
-        return STAGE_NOTIFY_DELETE;
-    }
-
-private:
-    MigrationSourceManager* const _migrationSourceManager;
-};
-
 bool isInRange(const BSONObj& obj,
                const BSONObj& min,
                const BSONObj& max,
@@ -191,8 +150,9 @@ bool MigrationSourceManager::start(OperationContext* txn,
 
     _active = true;
 
-    stdx::lock_guard<stdx::mutex> tLock(_cloneLocsMutex);
-    invariant(_cloneLocs.size() == 0);
+    stdx::lock_guard<stdx::mutex> tLock(_cloneMutex);
+    invariant(!_cloneExec);
+    invariant(_cloneNextDoc.isEmpty());
 
     return true;
 }
@@ -207,7 +167,6 @@ void MigrationSourceManager::done(OperationContext* txn) {
     stdx::lock_guard<stdx::mutex> lk(_mutex);
 
     _active = false;
-    _deleteNotifyExec.reset(NULL);
     _inCriticalSection = false;
     _inCriticalSectionCV.notify_all();
 
@@ -215,8 +174,11 @@ void MigrationSourceManager::done(OperationContext* txn) {
     _reload.clear();
     _memoryUsed = 0;
 
-    stdx::lock_guard<stdx::mutex> cloneLock(_cloneLocsMutex);
-    _cloneLocs.clear();
+    stdx::lock_guard<stdx::mutex> cloneLock(_cloneMutex);
+    _cloneExec.reset();
+    _cloneNextDoc = BSONObj();
+    _cloneDocsEstimate = 0;
+    _clonedDocs = 0;
 }
 
 void MigrationSourceManager::logOp(OperationContext* txn,
@@ -348,18 +310,6 @@ bool MigrationSourceManager::storeCurrentLocs(OperationContext* txn,
         // the current migration.
         stdx::lock_guard<stdx::mutex> sl(_mutex);
 
-        invariant(_deleteNotifyExec.get() == NULL);
-        unique_ptr<WorkingSet> ws = stdx::make_unique<WorkingSet>();
-        unique_ptr<DeleteNotificationStage> dns = stdx::make_unique<DeleteNotificationStage>(this);
-
-        // Takes ownership of 'ws' and 'dns'.
-        auto statusWithPlanExecutor = PlanExecutor::make(
-            txn, std::move(ws), std::move(dns), collection, PlanExecutor::YIELD_MANUAL);
-        invariant(statusWithPlanExecutor.isOK());
-
-        _deleteNotifyExec = std::move(statusWithPlanExecutor.getValue());
-        _deleteNotifyExec->registerExec();
-
         min = Helpers::toKeyFormat(kp.extendRangeBound(_min, false));
         max = Helpers::toKeyFormat(kp.extendRangeBound(_max, false));
     }
@@ -395,11 +345,6 @@ bool MigrationSourceManager::storeCurrentLocs(OperationContext* txn,
 
     RecordId recordId;
     while (PlanExecutor::ADVANCED == exec->getNext(NULL, &recordId)) {
-        if (!isLargeChunk) {
-            stdx::lock_guard<stdx::mutex> lk(_cloneLocsMutex);
-            _cloneLocs.insert(recordId);
-        }
-
         if (++recCount > maxRecsWhenFull) {
             isLargeChunk = true;
             // Continue on despite knowing that it will fail, just to get the correct value for
@@ -423,7 +368,29 @@ bool MigrationSourceManager::storeCurrentLocs(OperationContext* txn,
         return false;
     }
 
-    log() << "moveChunk number of documents: " << cloneLocsRemaining() << migrateLog;
+    {
+        // The documents are cloned by a second scan over the same range, which fetches them in
+        // index order and is resumed by each call to clone(). Changes to the documents made after
+        // it passed them are queued for 'transferMods'. It must not yield on its own, since it is
+        // used while holding '_mutex'.
+        stdx::lock_guard<stdx::mutex> lk(_cloneMutex);
+        invariant(!_cloneExec);
+        _cloneExec = InternalPlanner::indexScan(txn,
+                                                collection,
+                                                idx,
+                                                min,
+                                                max,
+                                                false,  // endKeyInclusive
+                                                InternalPlanner::FORWARD,
+                                                InternalPlanner::IXSCAN_FETCH);
+        _cloneExec->registerExec();
+        _cloneExec->saveState();
+        _cloneExec->detachFromOperationContext();
+        _cloneDocsEstimate = recCount;
+        _clonedDocs = 0;
+    }
+
+    log() << "moveChunk number of documents: " << recCount << migrateLog;
 
     txn->recoveryUnit()->abandonSnapshot();
     return true;
@@ -472,55 +439,77 @@ bool MigrationSourceManager::clone(OperationContext* txn, string& errmsg, BSONOb
             return false;
         }
 
-        stdx::lock_guard<stdx::mutex> lk(_cloneLocsMutex);
+        stdx::lock_guard<stdx::mutex> lk(_cloneMutex);
+        if (!_cloneExec) {
+            // All documents have been cloned.
+            break;
+        }
 
-        std::set<RecordId>::iterator cloneLocsIter = _cloneLocs.begin();
-        for (; cloneLocsIter != _cloneLocs.end(); ++cloneLocsIter) {
-            if (tracker.intervalHasElapsed())  // should I yield?
-                break;
+        _cloneExec->reattachToOperationContext(txn);
+        if (!_cloneExec->restoreState()) {
+            errmsg = str::stream() << "collection or shard key index of " << _ns
+                                   << " dropped while cloning";
+            _cloneExec.reset();
+            return false;
+        }
 
-            RecordId recordId = *cloneLocsIter;
-            Snapshotted<BSONObj> doc;
-            if (!collection->findDoc(txn, recordId, &doc)) {
-                // doc was deleted
-                continue;
+        bool isExhausted = false;
+        while (!tracker.intervalHasElapsed()) {  // should I yield?
+            BSONObj doc;
+            if (!_cloneNextDoc.isEmpty()) {
+                doc = _cloneNextDoc;
+                _cloneNextDoc = BSONObj();
+            } else {
+                PlanExecutor::ExecState state = _cloneExec->getNext(&doc, NULL);
+                if (PlanExecutor::IS_EOF == state) {
+                    isExhausted = true;
+                    break;
+                }
+
+                if (PlanExecutor::ADVANCED != state) {
+                    errmsg = str::stream() << "executor error while cloning " << _ns << ": "
+                                           << WorkingSetCommon::toStatusString(doc);
+                    _cloneExec.reset();
+                    return false;
+                }
             }
 
             // Use the builder size instead of accumulating 'doc's size so that we take
             // into consideration the overhead of BSONArray indices, and *always*
             // append one doc.
             if (clonedDocsArrayBuilder.arrSize() != 0 &&
-                (clonedDocsArrayBuilder.len() + doc.value().objsize() + 1024) >
-                    BSONObjMaxUserSize) {
+                (clonedDocsArrayBuilder.len() + doc.objsize() + 1024) > BSONObjMaxUserSize) {
+                // Keep the document for the next batch.
+                _cloneNextDoc = doc.getOwned();
                 isBufferFilled = true;  // break out of outer while loop
                 break;
             }
 
-            clonedDocsArrayBuilder.append(doc.value());
+            clonedDocsArrayBuilder.append(doc);
+            ++_clonedDocs;
         }
 
-        _cloneLocs.erase(_cloneLocs.begin(), cloneLocsIter);
-
-        // Note: must be holding _cloneLocsMutex, don't move this inside while condition!
-        if (_cloneLocs.empty()) {
+        if (isExhausted) {
+            _cloneExec.reset();
             break;
         }
+
+        _cloneExec->saveState();
+        _cloneExec->detachFromOperationContext();
     }
 
     result.appendArray("objects", clonedDocsArrayBuilder.arr());
     return true;
 }
 
-void MigrationSourceManager::aboutToDelete(const RecordId& dl) {
-    // Even though above we call findDoc to check for existance that check only works for non-mmapv1
-    // engines, and this is needed for mmapv1.
-    stdx::lock_guard<stdx::mutex> lk(_cloneLocsMutex);
-    _cloneLocs.erase(dl);
-}
-
 std::size_t MigrationSourceManager::cloneLocsRemaining() const {
-    stdx::lock_guard<stdx::mutex> lk(_cloneLocsMutex);
-    return _cloneLocs.size();
+    stdx::lock_guard<stdx::mutex> lk(_cloneMutex);
+    if (!_cloneExec) {
+        return 0;
+    }
+
+    // Documents inserted into the chunk since it was counted make the count an underestimate.
+    return std::max(1LL, _cloneDocsEstimate - _clonedDocs);
 }
 
 long long MigrationSourceManager::mbUsed() const {
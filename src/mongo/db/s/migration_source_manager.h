@@ -29,7 +29,7 @@
 #pragma once
 
 #include <list>
-#include <set>
+#include <memory>
 #include <string>
 
 #include "mongo/base/disallow_copying.h"
@@ -42,7 +42,6 @@ class BSONObj;
 class Database;
 class OperationContext;
 class PlanExecutor;
-class RecordId;
 
 class MigrationSourceManager {
     MONGO_DISALLOW_COPYING(MigrationSourceManager);
@@ -77,8 +76,8 @@ public:
     bool transferMods(OperationContext* txn, std::string& errmsg, BSONObjBuilder& b);
 
     /**
-     * Get the disklocs that belong to the chunk migrated and sort them in _cloneLocs (to avoid
-     * seeking disk later).
+     * Counts the documents that belong to the chunk migrated and opens the cursor over the shard
+     * key index from which clone() streams them, in index order.
      *
      * @param maxChunkSize number of bytes beyond which a chunk's base data (no indices) is
      *      considered too large to move
@@ -91,10 +90,16 @@ public:
                           std::string& errmsg,
                           BSONObjBuilder& result);
 
+    /**
+     * Appends the next batch of documents of the chunk to 'result' as the "objects" array. The
+     * array is empty once all of them have been transferred.
+     */
     bool clone(OperationContext* txn, std::string& errmsg, BSONObjBuilder& result);
 
-    void aboutToDelete(const RecordId& dl);
-
+    /**
+     * Returns an estimate of the number of documents left to clone. Only returns zero once all of
+     * them have been transferred.
+     */
     std::size_t cloneLocsRemaining() const;
 
     long long mbUsed() const;
@@ -139,11 +144,11 @@ private:
     // (M)  Must hold _mutex for access.
     // (MG) For reads, _mutex *OR* Global IX Lock must be held.
     //      For writes, the _mutex *AND* (Global Shared or Exclusive Lock) must be held.
-    // (C)  Must hold _cloneLocsMutex for access.
+    // (C)  Must hold _cloneMutex for access.
     //
     // Locking order:
     //
-    // Global Lock -> _mutex -> _cloneLocsMutex
+    // Global Lock -> _mutex -> _cloneMutex
 
     mutable stdx::mutex _mutex;
 
@@ -152,8 +157,6 @@ private:
     // Is migration currently in critical section. This can be used to block new writes.
     bool _inCriticalSection{false};  // (M)
 
-    std::unique_ptr<PlanExecutor> _deleteNotifyExec;  // (M)
-
     // List of _id of documents that were modified that must be re-cloned.
     std::list<BSONObj> _reload;  // (M)
 
@@ -171,10 +174,19 @@ private:
     BSONObj _max;              // (MG)
     BSONObj _shardKeyPattern;  // (MG)
 
-    mutable stdx::mutex _cloneLocsMutex;
+    mutable stdx::mutex _cloneMutex;
+
+    // Cursor over the chunk's range of the shard key index, which fetches the documents that need
+    // to be transferred from here to the other side. It is registered for invalidations, and saved
+    // and detached from its OperationContext between calls to clone(). Reset once exhausted.
+    std::unique_ptr<PlanExecutor> _cloneExec;  // (C)
+
+    // Document returned by '_cloneExec' which did not fit into the last batch.
+    BSONObj _cloneNextDoc;  // (C)
 
-    // List of record id that needs to be transferred from here to the other side.
-    std::set<RecordId> _cloneLocs;  // (C)
+    // Number of documents counted in the chunk by storeCurrentLocs, and cloned so far.
+    long long _cloneDocsEstimate{0};  // (C)
+    long long _clonedDocs{0};         // (C)
 };
 
 }  // namespace mongo
@@ -283,6 +283,15 @@ void KeyString::resetToKey(const BSONObj& obj, Ordering ord, Discriminator discr
     _appendAllElementsForIndexing(obj, ord, discriminator);
 }
 
+void KeyString::resetToSortKey(const BSONObj& obj, Ordering ord) {
+    resetToEmpty();
+    int elemIdx = 0;
+    BSONForEach(elem, obj) {
+        _appendBsonValue(elem, ord.get(elemIdx++) == -1, NULL);
+    }
+    _append(kEnd, false);
+}
+
 // ----------------------------------------------------------------------
 // -----------   APPEND CODE  -------------------------------------------
 // ----------------------------------------------------------------------
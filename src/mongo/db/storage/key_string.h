@@ -252,6 +252,17 @@ public:
 
     void resetToKey(const BSONObj& obj, Ordering ord, RecordId recordId);
     void resetToKey(const BSONObj& obj, Ordering ord, Discriminator discriminator = kInclusive);
+
+    /**
+     * Resets to the encoding of the values of 'obj', a sort key, in order. Unlike resetToKey(),
+     * field names are ignored entirely rather than read as discriminators.
+     *
+     * Comparing two such encodings with memcmp orders them the same way
+     * BSONObj::woCompare(other, <pattern of 'ord'>, false) orders the keys, except that numbers
+     * which are equal as doubles but not exactly, such as a long and its nearest double, are
+     * ordered by their exact values. NumberDecimal values cannot be encoded.
+     */
+    void resetToSortKey(const BSONObj& obj, Ordering ord);
     void resetFromBuffer(const void* buffer, size_t size) {
         _buffer.reset();
         memcpy(_buffer.skip(size), buffer, size);
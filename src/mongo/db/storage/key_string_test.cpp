@@ -619,6 +619,50 @@ TEST(KeyStringTest, AllPermCompare) {
     testPermutation(elements, orderings, false);
 }
 
+TEST(KeyStringTest, SortKeysCompareLikeWoCompare) {
+    const std::vector<BSONObj>& elements = getInterestingElements();
+
+    std::vector<BSONObj> patterns;
+    patterns.push_back(BSON("a" << 1 << "b" << 1));
+    patterns.push_back(BSON("a" << 1 << "b" << -1));
+    patterns.push_back(BSON("a" << -1 << "$metaTextScore" << -1));
+
+    for (size_t p = 0; p < patterns.size(); p++) {
+        const BSONObj& pattern = patterns[p];
+        const Ordering ordering = Ordering::make(pattern);
+
+        // Sort keys pair a fixed first value with each interesting element. Their field names,
+        // here including ones which resetToKey() would read as discriminators, are ignored.
+        std::vector<BSONObj> keys;
+        OwnedPointerVector<KeyString> keyStrings;
+        for (size_t i = 0; i < elements.size(); i++) {
+            for (int first = 0; first < 2; first++) {
+                BSONObjBuilder b;
+                b.append(i % 2 ? "l" : "g", first);
+                b.appendAs(elements[i].firstElement(), "$metaTextScore");
+                keys.push_back(b.obj());
+
+                keyStrings.push_back(new KeyString());
+                keyStrings.back()->resetToSortKey(keys.back(), ordering);
+            }
+        }
+
+        for (size_t i = 0; i < keys.size(); i++) {
+            for (size_t j = 0; j < keys.size(); j++) {
+                const int bsonCmp = keys[i].woCompare(keys[j], pattern, false);
+                const int ksCmp = keyStrings[i]->compare(*keyStrings[j]);
+
+                // Numbers equal as doubles but not exactly are ordered by their exact values.
+                if (bsonCmp == 0 && keys[i]["$metaTextScore"].isNumber()) {
+                    continue;
+                }
+                ASSERT_EQUALS(bsonCmp < 0, ksCmp < 0);
+                ASSERT_EQUALS(bsonCmp == 0, ksCmp == 0);
+            }
+        }
+    }
+}
+
 TEST(KeyStringTest, AllPerm2Compare) {
 // This test can take over a minute without optimizations. Re-enable if you need to debug it.
 #if !defined(MONGO_CONFIG_OPTIMIZED_BUILD)
@@ -33,6 +33,9 @@
        we will build an output buffer ourself and then use O_DIRECT
        we could be in read lock for this
        for very large objects write directly to redo log in situ?
+     COMPRESSJOURNALSECTION
+       compress the output buffer. done by the durability thread after it releases the flush lock,
+       while the journal writer thread may still be writing the previous group commit.
      WRITETOJOURNAL
        we could be unlocked (the main db lock that is...) for this, with sufficient care, but there
        is some complexity have to handle falling behind which would use too much ram (going back
@@ -97,6 +100,7 @@
 #include "mongo/util/concurrency/synchronization.h"
 #include "mongo/util/exit.h"
 #include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
 #include "mongo/util/timer.h"
 
 namespace mongo {
@@ -131,14 +135,18 @@ NotifyAll applyToDataFilesNotify;
 // When set, the flush thread will exit
 AtomicUInt32 shutdownRequested(0);
 
+// Number of threads in waitUntilDurable. While there are any, the flush thread starts a group
+// commit as soon as it can instead of waiting for the commit interval to elapse.
+AtomicUInt32 durableWaiters(0);
+
 enum {
     // How many commit cycles to do before considering doing a remap
     NumCommitsBeforeRemap = 10,
 
     // How many outstanding journal flushes should be allowed before applying writer back
-    // pressure. Size of 1 allows two journal blocks to be in the process of being written -
-    // one on the journal writer's buffer and one blocked waiting to be picked up.
-    NumAsyncJournalWrites = 1,
+    // pressure. Size of 2 lets the durability thread collect and compress one group commit
+    // while the journal writer thread writes the previous one.
+    NumAsyncJournalWrites = 2,
 };
 
 // Remap loop state
@@ -455,6 +463,16 @@ void Stats::S::reset() {
     _startTimeMicros = curTimeMicros64();
 }
 
+void Stats::S::_recordCommitLatency(uint64_t micros) {
+    unsigned bucket = 0;
+    for (uint64_t upperBoundMicros = 1000;
+         micros >= upperBoundMicros && bucket < NumCommitLatencyBuckets - 1;
+         upperBoundMicros *= 2) {
+        bucket++;
+    }
+    _commitLatencyBuckets[bucket]++;
+}
+
 std::string Stats::S::_CSVHeader() const {
     return "cmts\t jrnMB\t wrDFMB\t cIWLk\t early\t prpLgB\t wrToJ\t wrToDF\t rmpPrVw";
 }
@@ -483,7 +501,18 @@ void Stats::S::_asObj(BSONObjBuilder* builder) const {
                    << "writeToDataFiles" << (unsigned)(_writeToDataFilesMicros / 1000)
                    << "remapPrivateView" << (unsigned)(_remapPrivateViewMicros / 1000) << "commits"
                    << (unsigned)(_commitsMicros / 1000) << "commitsInWriteLock"
-                   << (unsigned)(_commitsInWriteLockMicros / 1000));
+                   << (unsigned)(_commitsInWriteLockMicros / 1000) << "compressJournal"
+                   << (unsigned)(_compressJournalMicros / 1000));
+
+    BSONObjBuilder latencyBuilder(b.subobjStart("commitLatencyMs"));
+    for (unsigned i = 0; i < NumCommitLatencyBuckets - 1; i++) {
+        const std::string bucketName = str::stream() << "<" << (1 << i);
+        latencyBuilder.append(bucketName, _commitLatencyBuckets[i]);
+    }
+    const std::string lastBucketName = str::stream() << ">="
+                                                     << (1 << (NumCommitLatencyBuckets - 2));
+    latencyBuilder.append(lastBucketName, _commitLatencyBuckets[NumCommitLatencyBuckets - 1]);
+    latencyBuilder.doneFast();
 
     if (mmapv1GlobalOptions.journalCommitInterval != 0) {
         b << "journalCommitIntervalMs" << mmapv1GlobalOptions.journalCommitInterval;
@@ -521,7 +550,18 @@ bool DurableImpl::commitNow(OperationContext* txn) {
 }
 
 bool DurableImpl::waitUntilDurable() {
+    durableWaiters.fetchAndAdd(1);
+
+    {
+        // Taking flushMutex guarantees that the flush thread either sees the waiter count or
+        // is waiting on flushRequested, so the notification is not lost.
+        stdx::lock_guard<stdx::mutex> lock(flushMutex);
+        flushRequested.notify_one();
+    }
+
     commitNotify.awaitBeyondNow();
+
+    durableWaiters.fetchAndSubtract(1);
     return true;
 }
 
@@ -667,7 +707,7 @@ static void durThread() {
     journalWriter.start();
 
     // Used as an estimate of how much / how fast to remap
-    uint64_t commitCounter(0);
+    uint64_t commitsSinceRemap(0);
     uint64_t estimatedPrivateMapSize(0);
     uint64_t remapLastTimestamp(0);
 
@@ -689,14 +729,17 @@ static void durThread() {
             stdx::unique_lock<stdx::mutex> lock(flushMutex);
 
             for (unsigned i = 0; i <= 2; i++) {
-                if (stdx::cv_status::no_timeout ==
-                    flushRequested.wait_for(lock, Milliseconds(oneThird))) {
-                    // Someone forced a flush
+                if (durableWaiters.load()) {
+                    // One or more getLastError j:true is pending. Commit right away, so their
+                    // latency is that of the journal write rather than of the commit interval.
+                    // Waiters arriving while this group commit is being written are gathered
+                    // into the next one.
                     break;
                 }
 
-                if (commitNotify.nWaiting()) {
-                    // One or more getLastError j:true is pending
+                if (stdx::cv_status::no_timeout ==
+                    flushRequested.wait_for(lock, Milliseconds(oneThird))) {
+                    // Someone forced a flush
                     break;
                 }
 
@@ -706,11 +749,17 @@ static void durThread() {
                 }
             }
 
+            lock.unlock();
+
             // The commit logic itself
             LOG(4) << "groupCommit begin";
 
             Timer t;
 
+            // Obtain the buffer before the flush lock, since this blocks until a previous group
+            // commit has been written and we do not want to keep writers waiting meanwhile.
+            JournalWriter::Buffer* const buffer = journalWriter.newBuffer();
+
             OperationContextImpl txn;
             AutoAcquireFlushLockForMMAPV1Commit autoFlushLock(txn.lockState());
 
@@ -728,17 +777,15 @@ static void durThread() {
                 // getlasterror request could have came after the data was already committed.
                 // No need to call committingReset though, because we have not done any
                 // writes (hasWritten == false).
-                JournalWriter::Buffer* const buffer = journalWriter.newBuffer();
                 buffer->setNoop();
 
                 journalWriter.writeBuffer(buffer, commitNumber);
             } else {
                 // This copies all the in-memory changes into the journal writer's buffer.
-                JournalWriter::Buffer* const buffer = journalWriter.newBuffer();
                 PREPLOGBUFFER(buffer->getHeader(), buffer->getBuilder());
 
                 estimatedPrivateMapSize += commitJob.bytes();
-                commitCounter++;
+                commitsSinceRemap++;
 
                 // Now that the write intents have been copied to the buffer, the commit job is
                 // free to be reused. We need to reset the commit job's contents while under
@@ -757,9 +804,16 @@ static void durThread() {
                 // 2. Check if the amount of free memory on the machine is running low,
                 //    since #1 is underestimates the memory pressure on Windows since
                 //    commits in 64MB chunks.
+                //
+                // Otherwise we remap every NumCommitsBeforeRemap commits, but no more often than
+                // that many thirds of the commit interval, since commits driven by j:true
+                // waiters can be far more frequent than the commit interval.
+                const bool remapDueToCommits = (commitsSinceRemap >= NumCommitsBeforeRemap) &&
+                    (curTimeMicros64() - remapLastTimestamp >=
+                     NumCommitsBeforeRemap * oneThird * 1000ULL);
+
                 const bool shouldRemap = (estimatedPrivateMapSize >= UncommittedBytesLimit) ||
-                    (systemMemoryPressurePercentage > 0.0) ||
-                    (commitCounter % NumCommitsBeforeRemap == 0) ||
+                    (systemMemoryPressurePercentage > 0.0) || remapDueToCommits ||
                     (mmapv1GlobalOptions.journalOptions & MMAPV1Options::JournalAlwaysRemap);
 
                 double remapFraction = 0.0;
@@ -817,6 +871,7 @@ static void durThread() {
 
                     // Reset the private map estimate outside of the lock
                     estimatedPrivateMapSize = 0;
+                    commitsSinceRemap = 0;
                     remapLastTimestamp = curTimeMicros64();
 
                     stats.curr()->_commitsInWriteLock++;
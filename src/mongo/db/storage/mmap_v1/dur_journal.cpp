@@ -717,57 +717,52 @@ void Journal::_rotate() {
     }
 }
 
-/** write (append) the buffer we have built to the journal and fsync it.
-    outside of dbMutex lock as this could be slow.
-    @param uncompressed - a buffer that will be written to the journal after compression
-    will not return until on disk
+/** compress the buffer we have built into a journal section, ready to be appended to the
+    journal. this is CPU bound and does not touch the journal file, so it is done by the
+    durability thread and overlaps with the journal writer's I/O for the previous section.
+    @param uncompressed - the buffer built by PREPLOGBUFFER
+    @param section - receives the section's header and compressed operations
 */
-void WRITETOJOURNAL(const JSectHeader& h, const AlignedBuilder& uncompressed) {
+void COMPRESSJOURNALSECTION(const JSectHeader& h,
+                            const AlignedBuilder& uncompressed,
+                            AlignedBuilder* section) {
     Timer t;
-    j.journal(h, uncompressed);
-    stats.curr()->_writeToJournalMicros += t.micros();
-}
 
-void Journal::journal(const JSectHeader& h, const AlignedBuilder& uncompressed) {
-    static AlignedBuilder b(32 * 1024 * 1024);
     /* buffer to journal will be
        JSectHeader
        compressed operations
        JSectFooter
     */
     const unsigned headTailSize = sizeof(JSectHeader) + sizeof(JSectFooter);
-    const unsigned max = maxCompressedLength(uncompressed.len()) + headTailSize;
-    b.reset(max);
+    const unsigned max = maxCompressedLength(uncompressed.len()) + headTailSize + Alignment;
+    section->reset(max);
 
     {
         dassert(h.sectionLen() == (unsigned)0xffffffff);  // we will backfill later
-        b.appendStruct(h);
+        section->appendStruct(h);
     }
 
     size_t compressedLength = 0;
-    rawCompress(uncompressed.buf(), uncompressed.len(), b.cur(), &compressedLength);
+    rawCompress(uncompressed.buf(), uncompressed.len(), section->cur(), &compressedLength);
     verify(compressedLength < 0xffffffff);
     verify(compressedLength < max);
-    b.skip(compressedLength);
+    section->skip(compressedLength);
 
-    // footer
-    unsigned L = 0xffffffff;
-    {
-        // pad to alignment, and set the total section length in the JSectHeader
-        verify(0xffffe000 == (~(Alignment - 1)));
-        unsigned lenUnpadded = b.len() + sizeof(JSectFooter);
-        L = (lenUnpadded + Alignment - 1) & (~(Alignment - 1));
-        dassert(L >= lenUnpadded);
-
-        ((JSectHeader*)b.atOfs(0))->setSectionLen(lenUnpadded);
+    stats.curr()->_compressJournalMicros += t.micros();
+}
 
-        JSectFooter f(b.buf(), b.len());  // computes checksum
-        b.appendStruct(f);
-        dassert(b.len() == lenUnpadded);
+/** write (append) a section built by COMPRESSJOURNALSECTION to the journal and fsync it.
+    outside of dbMutex lock as this could be slow.
+    will not return until on disk
+*/
+void WRITETOJOURNAL(AlignedBuilder* section, unsigned uncompressedLen) {
+    Timer t;
+    j.journal(section, uncompressedLen);
+    stats.curr()->_writeToJournalMicros += t.micros();
+}
 
-        b.skip(L - lenUnpadded);
-        dassert(b.len() % Alignment == 0);
-    }
+void Journal::journal(AlignedBuilder* section, unsigned uncompressedLen) {
+    AlignedBuilder& b = *section;
 
     try {
         stdx::lock_guard<SimpleMutex> lk(_curLogFileMutex);
@@ -775,7 +770,32 @@ void Journal::journal(const JSectHeader& h, const AlignedBuilder& uncompressed)
         // must already be open -- so that _curFileId is correct for previous buffer building
         verify(_curLogFile);
 
-        stats.curr()->_uncompressedBytes += uncompressed.len();
+        // The section may have been built before the previous one rotated the journal file, so
+        // it is stamped with the id of the file it is actually written to. This has to happen
+        // before the footer's checksum is computed.
+        JSectHeader* const h = (JSectHeader*)b.atOfs(0);
+        h->fileId = _curFileId;
+
+        // footer
+        unsigned L = 0xffffffff;
+        {
+            // pad to alignment, and set the total section length in the JSectHeader
+            verify(0xffffe000 == (~(Alignment - 1)));
+            unsigned lenUnpadded = b.len() + sizeof(JSectFooter);
+            L = (lenUnpadded + Alignment - 1) & (~(Alignment - 1));
+            dassert(L >= lenUnpadded);
+
+            h->setSectionLen(lenUnpadded);
+
+            JSectFooter f(b.buf(), b.len());  // computes checksum
+            b.appendStruct(f);
+            dassert(b.len() == lenUnpadded);
+
+            b.skip(L - lenUnpadded);
+            dassert(b.len() % Alignment == 0);
+        }
+
+        stats.curr()->_uncompressedBytes += uncompressedLen;
         unsigned w = b.len();
         _written += w;
         verify(w <= L);
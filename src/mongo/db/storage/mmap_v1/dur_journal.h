@@ -77,9 +77,17 @@ unsigned long long getLastDataFileFlushTime();
 bool haveJournalFiles(bool anyFiles = false);
 
 /**
- * Writes the specified uncompressed buffer to the journal.
+ * Compresses the specified uncompressed buffer into a journal section, which can then be written
+ * with WRITETOJOURNAL. May be called while a previous section is being written.
  */
-void WRITETOJOURNAL(const JSectHeader& h, const AlignedBuilder& uncompressed);
+void COMPRESSJOURNALSECTION(const JSectHeader& h,
+                            const AlignedBuilder& uncompressed,
+                            AlignedBuilder* section);
+
+/**
+ * Writes the specified section built by COMPRESSJOURNALSECTION to the journal.
+ */
+void WRITETOJOURNAL(AlignedBuilder* section, unsigned uncompressedLen);
 
 // in case disk controller buffers writes
 const long long ExtraKeepTimeMs = 10000;
@@ -39,6 +39,7 @@
 #include "mongo/stdx/functional.h"
 #include "mongo/stdx/thread.h"
 #include "mongo/util/log.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 namespace dur {
@@ -172,6 +173,7 @@ void JournalWriter::assertIdle() {
 JournalWriter::Buffer* JournalWriter::newBuffer() {
     Buffer* const buffer = _readyQueue.blockingPop();
     buffer->_assertEmpty();
+    buffer->_startMicros = curTimeMicros64();
 
     return buffer;
 }
@@ -182,6 +184,10 @@ void JournalWriter::writeBuffer(Buffer* buffer, NotifyAll::When commitNumber) {
 
     buffer->_commitNumber = commitNumber;
 
+    if (!buffer->_isNoop && !buffer->_isShutdown) {
+        COMPRESSJOURNALSECTION(buffer->_header, buffer->_builder, &buffer->_section);
+    }
+
     _journalQueue.push(buffer);
 }
 
@@ -231,11 +237,12 @@ void JournalWriter::_journalWriterThread() {
                    << ", size " << buffer->_builder.len() << " bytes)";
 
             // This performs synchronous I/O to the journal file and will block.
-            WRITETOJOURNAL(buffer->_header, buffer->_builder);
+            WRITETOJOURNAL(&buffer->_section, buffer->_builder.len());
 
             // Data is now persisted in the journal, which is sufficient for acknowledging
             // getLastError
             _commitNotify->notifyAll(buffer->_commitNumber);
+            stats.curr()->_recordCommitLatency(curTimeMicros64() - buffer->_startMicros);
 
             // Apply the journal entries on top of the shared view so that when flush is
             // requested it would write the latest.
@@ -274,7 +281,13 @@ void JournalWriter::_journalWriterThread() {
 //
 
 JournalWriter::Buffer::Buffer(size_t initialSize)
-    : _commitNumber(0), _isNoop(false), _isShutdown(false), _header(), _builder(initialSize) {}
+    : _commitNumber(0),
+      _isNoop(false),
+      _isShutdown(false),
+      _startMicros(0),
+      _header(),
+      _builder(initialSize),
+      _section(initialSize) {}
 
 JournalWriter::Buffer::~Buffer() {
     _assertEmpty();
@@ -289,6 +302,7 @@ void JournalWriter::Buffer::_reset() {
     _commitNumber = 0;
     _isNoop = false;
     _builder.reset();
+    _section.reset();
 }
 
 }  // namespace dur
@@ -92,8 +92,15 @@ public:
         // be the last entry posted to the queue and the commit number should be zero.
         bool _isShutdown;
 
+        // When the group commit using this buffer started, for the commit latency statistics.
+        uint64_t _startMicros;
+
         JSectHeader _header;
         AlignedBuilder _builder;
+
+        // The compressed journal section built from _header and _builder by writeBuffer, which
+        // is what the journal writer thread appends to the journal.
+        AlignedBuilder _section;
     };
 
 
@@ -142,7 +149,9 @@ public:
     Buffer* newBuffer();
 
     /**
-     * Requests that the specified buffer be written asynchronously.
+     * Requests that the specified buffer be written asynchronously. The buffer's contents are
+     * compressed on the calling thread, so that compressing one group commit overlaps with the
+     * journal writer thread writing the previous one.
      *
      * This method may block if there are too many outstanding unwritten buffers.
      *
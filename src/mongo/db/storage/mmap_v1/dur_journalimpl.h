@@ -53,9 +53,9 @@ public:
      */
     void rotate();
 
-    /** append to the journal file
+    /** append a compressed section to the journal file, adding its footer
     */
-    void journal(const JSectHeader& h, const AlignedBuilder& b);
+    void journal(AlignedBuilder* section, unsigned uncompressedLen);
 
     boost::filesystem::path getFilePathFor(int filenumber) const;
 
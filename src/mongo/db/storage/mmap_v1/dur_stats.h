@@ -40,11 +40,20 @@ namespace dur {
  */
 struct Stats {
     struct S {
+        /**
+         * Group commits are counted in buckets by how long it took until their data was in the
+         * journal. The upper bound of bucket i is 2^i milliseconds, and the last bucket is
+         * unbounded.
+         */
+        enum { NumCommitLatencyBuckets = 12 };
+
         std::string _CSVHeader() const;
         std::string _asCSV() const;
 
         void _asObj(BSONObjBuilder* builder) const;
 
+        void _recordCommitLatency(uint64_t micros);
+
         void reset();
 
         uint64_t getCurrentDurationMillis() const {
@@ -66,11 +75,14 @@ struct Stats {
         uint64_t _writeToDataFilesBytes;
 
         uint64_t _prepLogBufferMicros;
+        uint64_t _compressJournalMicros;
         uint64_t _writeToJournalMicros;
         uint64_t _writeToDataFilesMicros;
         uint64_t _remapPrivateViewMicros;
         uint64_t _commitsMicros;
         uint64_t _commitsInWriteLockMicros;
+
+        unsigned _commitLatencyBuckets[NumCommitLatencyBuckets];
     };
 
 
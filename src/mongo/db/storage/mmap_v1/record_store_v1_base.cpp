@@ -417,11 +417,12 @@ bool RecordStoreV1Base::updateWithDamagesSupported() const {
     return true;
 }
 
-Status RecordStoreV1Base::updateWithDamages(OperationContext* txn,
-                                            const RecordId& loc,
-                                            const RecordData& oldRec,
-                                            const char* damageSource,
-                                            const mutablebson::DamageVector& damages) {
+StatusWith<RecordData> RecordStoreV1Base::updateWithDamages(
+    OperationContext* txn,
+    const RecordId& loc,
+    const RecordData& oldRec,
+    const char* damageSource,
+    const mutablebson::DamageVector& damages) {
     MmapV1RecordHeader* rec = recordFor(DiskLoc::fromRecordId(loc));
     char* root = rec->data();
 
@@ -434,7 +435,7 @@ Status RecordStoreV1Base::updateWithDamages(OperationContext* txn,
         std::memcpy(targetPtr, sourcePtr, where->size);
     }
 
-    return Status::OK();
+    return rec->toRecordData();
 }
 
 void RecordStoreV1Base::deleteRecord(OperationContext* txn, const RecordId& rid) {
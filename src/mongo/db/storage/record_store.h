@@ -384,11 +384,18 @@ public:
      */
     virtual bool updateWithDamagesSupported() const = 0;
 
-    virtual Status updateWithDamages(OperationContext* txn,
-                                     const RecordId& loc,
-                                     const RecordData& oldRec,
-                                     const char* damageSource,
-                                     const mutablebson::DamageVector& damages) = 0;
+    /**
+     * Updates the record at 'loc', whose current contents are 'oldRec', by copying each of
+     * 'damages' from 'damageSource' into it. The size of the record doesn't change.
+     *
+     * @return the contents of the updated record. Unless owned, they are only valid as long as
+     * the record is.
+     */
+    virtual StatusWith<RecordData> updateWithDamages(OperationContext* txn,
+                                                     const RecordId& loc,
+                                                     const RecordData& oldRec,
+                                                     const char* damageSource,
+                                                     const mutablebson::DamageVector& damages) = 0;
 
     /**
      * Returns a new cursor over this record store.
@@ -88,7 +88,10 @@ TEST(RecordStoreTestHarness, UpdateWithDamages) {
             dv[2].size = 3;
 
             WriteUnitOfWork uow(opCtx.get());
-            ASSERT_OK(rs->updateWithDamages(opCtx.get(), loc, rec, data.c_str(), dv));
+            StatusWith<RecordData> newRec =
+                rs->updateWithDamages(opCtx.get(), loc, rec, data.c_str(), dv);
+            ASSERT_OK(newRec.getStatus());
+            ASSERT_EQUALS(string("11101000"), newRec.getValue().data());
             uow.commit();
         }
     }
@@ -148,7 +151,10 @@ TEST(RecordStoreTestHarness, UpdateWithOverlappingDamageEvents) {
             dv[1].size = 5;
 
             WriteUnitOfWork uow(opCtx.get());
-            ASSERT_OK(rs->updateWithDamages(opCtx.get(), loc, rec, data.c_str(), dv));
+            StatusWith<RecordData> newRec =
+                rs->updateWithDamages(opCtx.get(), loc, rec, data.c_str(), dv);
+            ASSERT_OK(newRec.getStatus());
+            ASSERT_EQUALS(string("10100010"), newRec.getValue().data());
             uow.commit();
         }
     }
@@ -209,7 +215,10 @@ TEST(RecordStoreTestHarness, UpdateWithOverlappingDamageEventsReversed) {
             dv[1].size = 5;
 
             WriteUnitOfWork uow(opCtx.get());
-            ASSERT_OK(rs->updateWithDamages(opCtx.get(), loc, rec, data.c_str(), dv));
+            StatusWith<RecordData> newRec =
+                rs->updateWithDamages(opCtx.get(), loc, rec, data.c_str(), dv);
+            ASSERT_OK(newRec.getStatus());
+            ASSERT_EQUALS(string("10111010"), newRec.getValue().data());
             uow.commit();
         }
     }
@@ -262,7 +271,9 @@ TEST(RecordStoreTestHarness, UpdateWithNoDamages) {
             mutablebson::DamageVector dv;
 
             WriteUnitOfWork uow(opCtx.get());
-            ASSERT_OK(rs->updateWithDamages(opCtx.get(), loc, rec, "", dv));
+            StatusWith<RecordData> newRec = rs->updateWithDamages(opCtx.get(), loc, rec, "", dv);
+            ASSERT_OK(newRec.getStatus());
+            ASSERT_EQUALS(data, newRec.getValue().data());
             uow.commit();
         }
     }
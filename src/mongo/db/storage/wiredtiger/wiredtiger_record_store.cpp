@@ -925,15 +925,42 @@ StatusWith<RecordId> WiredTigerRecordStore::updateRecord(OperationContext* txn,
 }
 
 bool WiredTigerRecordStore::updateWithDamagesSupported() const {
-    return false;
+    return true;
 }
 
-Status WiredTigerRecordStore::updateWithDamages(OperationContext* txn,
-                                                const RecordId& loc,
-                                                const RecordData& oldRec,
-                                                const char* damageSource,
-                                                const mutablebson::DamageVector& damages) {
-    invariant(false);
+StatusWith<RecordData> WiredTigerRecordStore::updateWithDamages(
+    OperationContext* txn,
+    const RecordId& loc,
+    const RecordData& oldRec,
+    const char* damageSource,
+    const mutablebson::DamageVector& damages) {
+    // WiredTiger can't overwrite part of a value, so apply the damages to a copy of the record
+    // and write all of it back. This still saves the caller from building the new document and
+    // from checking it against the indexes.
+    const int len = oldRec.size();
+    SharedBuffer data = SharedBuffer::allocate(len);
+    std::memcpy(data.get(), oldRec.data(), len);
+
+    char* root = data.get();
+    mutablebson::DamageVector::const_iterator where = damages.begin();
+    const mutablebson::DamageVector::const_iterator end = damages.end();
+    for (; where != end; ++where) {
+        const char* sourcePtr = damageSource + where->sourceOffset;
+        char* targetPtr = root + where->targetOffset;
+        std::memcpy(targetPtr, sourcePtr, where->size);
+    }
+
+    WiredTigerCursor curwrap(_uri, _tableId, true, txn);
+    curwrap.assertInActiveTxn();
+    WT_CURSOR* c = curwrap.get();
+    invariant(c);
+    c->set_key(c, _makeKey(loc));
+    WiredTigerItem value(root, len);
+    c->set_value(c, value.Get());
+    int ret = WT_OP_CHECK(c->insert(c));
+    invariantWTOK(ret);
+
+    return RecordData(std::move(data), len);
 }
 
 void WiredTigerRecordStore::_oplogSetStartHack(WiredTigerRecoveryUnit* wru) const {
@@ -34,6 +34,8 @@
 
 #include "mongo/db/ttl.h"
 
+#include <map>
+
 #include "mongo/base/counter.h"
 #include "mongo/db/auth/authorization_session.h"
 #include "mongo/db/auth/user_name.h"
@@ -43,6 +45,7 @@
 #include "mongo/db/catalog/database_holder.h"
 #include "mongo/db/client.h"
 #include "mongo/db/commands/fsync.h"
+#include "mongo/db/commands/server_status.h"
 #include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/db_raii.h"
@@ -54,9 +57,12 @@
 #include "mongo/db/query/internal_plans.h"
 #include "mongo/db/repl/replication_coordinator_global.h"
 #include "mongo/db/server_parameters.h"
+#include "mongo/stdx/mutex.h"
 #include "mongo/util/background.h"
+#include "mongo/util/concurrency/thread_pool.h"
 #include "mongo/util/exit.h"
 #include "mongo/util/log.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
@@ -77,6 +83,183 @@ ServerStatusMetricField<Counter64> ttlDeletedDocumentsDisplay("ttl.deletedDocume
 MONGO_EXPORT_SERVER_PARAMETER(ttlMonitorEnabled, bool, true);
 MONGO_EXPORT_SERVER_PARAMETER(ttlMonitorSleepSecs, int, 60);  // used for testing
 
+// Maximum number of documents deleted from one TTL index before its locks are released.
+MONGO_EXPORT_SERVER_PARAMETER(ttlMonitorBatchSize, int, 1000);
+
+// Maximum number of documents deleted per second across all TTL indexes, or unlimited if <= 0.
+MONGO_EXPORT_SERVER_PARAMETER(ttlMonitorMaxDeletesPerSecond, int, 0);
+
+// Number of TTL indexes processed concurrently.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(ttlMonitorWorkerThreads, int, 4);
+
+namespace {
+
+/**
+ * Shares the deletes allowed by 'ttlMonitorMaxDeletesPerSecond' between the TTL workers. The budget
+ * is refilled once per second.
+ */
+class TTLDeleteBudget {
+public:
+    /**
+     * Blocks until at least one delete is allowed and returns how many of the 'wanted' deletes may
+     * be performed. Returns 0 without waiting any longer once the server is shutting down or the
+     * TTL monitor has been disabled. Must not be called while holding locks.
+     */
+    long long acquire(long long wanted) {
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        while (true) {
+            if (inShutdown() || !ttlMonitorEnabled) {
+                return 0;
+            }
+
+            const long long limit = ttlMonitorMaxDeletesPerSecond;
+            if (limit <= 0) {
+                return wanted;
+            }
+
+            const Date_t now = Date_t::now();
+            if (now - _windowStart >= Seconds(1)) {
+                _windowStart = now;
+                _used = 0;
+            }
+
+            if (_used < limit) {
+                const long long granted = std::min(wanted, limit - _used);
+                _used += granted;
+                return granted;
+            }
+
+            const Milliseconds untilRefill = Seconds(1) - (now - _windowStart);
+            lk.unlock();
+            sleepmillis(durationCount<Milliseconds>(untilRefill));
+            lk.lock();
+        }
+    }
+
+    /**
+     * Returns deletes that were acquired but not performed to the budget.
+     */
+    void release(long long unused) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _used = std::max(0LL, _used - unused);
+    }
+
+private:
+    stdx::mutex _mutex;
+    Date_t _windowStart;
+    long long _used = 0;
+};
+
+TTLDeleteBudget ttlDeleteBudget;
+
+/**
+ * Deletion progress of each TTL index, keyed by "<ns>.$<index name>".
+ */
+class TTLIndexStats {
+public:
+    struct IndexStats {
+        long long deletedDocuments = 0;
+
+        // Age of the oldest expired document not yet deleted, as of the last batch.
+        Seconds oldestExpiredAge{0};
+
+        // Estimate of the number of expired documents left after the last batch.
+        long long pendingEstimate = 0;
+
+        Date_t lastBatch;
+        long long lastPass = 0;
+    };
+
+    void startPass(long long pass) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _currentPass = pass;
+    }
+
+    /**
+     * Records a batch that deleted 'numDeleted' documents from the index named 'indexKey'.
+     */
+    void recordBatch(const std::string& indexKey,
+                     long long numDeleted,
+                     Seconds oldestExpiredAge,
+                     long long pendingEstimate) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        IndexStats& stats = _stats[indexKey];
+        stats.deletedDocuments += numDeleted;
+        stats.oldestExpiredAge = oldestExpiredAge;
+        stats.pendingEstimate = pendingEstimate;
+        stats.lastBatch = Date_t::now();
+        stats.lastPass = _currentPass;
+    }
+
+    /**
+     * Forgets the indexes which were not processed in the current pass, e.g. because they were
+     * dropped.
+     */
+    void endPass() {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        for (auto it = _stats.begin(); it != _stats.end();) {
+            if (it->second.lastPass != _currentPass) {
+                it = _stats.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    BSONObj toBSON() const {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        BSONObjBuilder bob;
+        for (const auto& entry : _stats) {
+            BSONObjBuilder indexBob(bob.subobjStart(entry.first));
+            indexBob.appendNumber("deletedDocuments", entry.second.deletedDocuments);
+            indexBob.appendNumber("oldestExpiredAgeSecs",
+                                  durationCount<Seconds>(entry.second.oldestExpiredAge));
+            indexBob.appendNumber("pendingEstimate", entry.second.pendingEstimate);
+            indexBob.appendDate("lastBatch", entry.second.lastBatch);
+            indexBob.doneFast();
+        }
+        return bob.obj();
+    }
+
+private:
+    mutable stdx::mutex _mutex;
+    std::map<std::string, IndexStats> _stats;
+    long long _currentPass = 0;
+};
+
+TTLIndexStats ttlIndexStats;
+
+/**
+ * Server status section for the TTL monitor.
+ *
+ * Sample format:
+ *
+ * ttl: {
+ *   indexes: {
+ *     "test.sessions.$lastUse_1": {
+ *       deletedDocuments: NumberLong(25000),
+ *       oldestExpiredAgeSecs: NumberLong(12),
+ *       pendingEstimate: NumberLong(4200),
+ *       lastBatch: ISODate("2015-08-11T22:45:30.221Z")
+ *     }
+ *   }
+ * }
+ */
+class TTLServerStatusSection : public ServerStatusSection {
+public:
+    TTLServerStatusSection() : ServerStatusSection("ttl") {}
+
+    bool includeByDefault() const {
+        return false;
+    }
+
+    BSONObj generateSection(OperationContext* txn, const BSONElement& configElement) const {
+        return BSON("indexes" << ttlIndexStats.toBSON());
+    }
+} ttlServerStatusSection;
+
+}  // namespace
+
 class TTLMonitor : public BackgroundJob {
 public:
     TTLMonitor() {}
@@ -92,6 +275,18 @@ public:
         Client::initThread(name().c_str());
         AuthorizationSession::get(cc())->grantInternalAuthorization();
 
+        ThreadPool::Options options;
+        options.poolName = "TTLMonitorWorkers";
+        options.threadNamePrefix = "TTLMonitorWorker-";
+        options.minThreads = 0;
+        options.maxThreads = std::max(1, ttlMonitorWorkerThreads);
+        ThreadPool workers(options);
+        workers.startup();
+        ON_BLOCK_EXIT([&workers] {
+            workers.shutdown();
+            workers.join();
+        });
+
         while (!inShutdown()) {
             sleepsecs(ttlMonitorSleepSecs);
 
@@ -110,7 +305,7 @@ public:
             }
 
             try {
-                doTTLPass();
+                doTTLPass(&workers);
             } catch (const WriteConflictException& e) {
                 LOG(1) << "Got WriteConflictException in TTL thread";
             }
@@ -118,7 +313,11 @@ public:
     }
 
 private:
-    void doTTLPass() {
+    /**
+     * Runs the TTL deletes for every TTL index, spreading the indexes over the 'workers' pool.
+     * Returns once all of them are done.
+     */
+    void doTTLPass(ThreadPool* workers) {
         // Count it as active from the moment the TTL thread wakes up
         OperationContextImpl txn;
 
@@ -132,6 +331,7 @@ private:
         dbHolder().getAllShortNames(dbs);
 
         ttlPasses.increment();
+        ttlIndexStats.startPass(ttlPasses.get());
 
         for (set<string>::const_iterator i = dbs.begin(); i != dbs.end(); ++i) {
             string db = *i;
@@ -141,17 +341,34 @@ private:
 
             for (vector<BSONObj>::const_iterator it = indexes.begin(); it != indexes.end(); ++it) {
                 BSONObj idx = *it;
-                try {
-                    if (!doTTLForIndex(&txn, db, idx)) {
-                        break;  // stop processing TTL indexes on this database
-                    }
-                } catch (const DBException& dbex) {
-                    error() << "Error processing ttl index: " << idx << " -- " << dbex.toString();
-                    // continue on to the next index
-                    continue;
+                Status scheduleStatus = workers->schedule([this, db, idx] { runWorker(db, idx); });
+                if (!scheduleStatus.isOK()) {
+                    // The pool is shutting down.
+                    LOG(1) << "could not schedule ttl job for: " << idx << " -- " << scheduleStatus;
+                    return;
                 }
             }
         }
+
+        workers->waitForIdle();
+        ttlIndexStats.endPass();
+    }
+
+    /**
+     * Runs the TTL deletes for the index 'idx' on a thread of the worker pool.
+     */
+    void runWorker(const string& dbName, const BSONObj& idx) {
+        Client::initThreadIfNotAlready();
+        AuthorizationSession::get(cc())->grantInternalAuthorization();
+        OperationContextImpl txn;
+
+        try {
+            doTTLForIndex(&txn, dbName, idx);
+        } catch (const WriteConflictException& e) {
+            LOG(1) << "Got WriteConflictException in TTL thread";
+        } catch (const DBException& dbex) {
+            error() << "Error processing ttl index: " << idx << " -- " << dbex.toString();
+        }
     }
 
     /**
@@ -204,38 +421,58 @@ private:
      * after a sufficient amount of time has passed according to its expiry
      * specification.
      *
-     * @return true if caller should continue processing TTL indexes of collections
-     *         on the specified database, and false otherwise
+     * Documents are deleted in batches of at most 'ttlMonitorBatchSize', within the budget of
+     * 'ttlMonitorMaxDeletesPerSecond'. All locks are released between batches.
      */
-    bool doTTLForIndex(OperationContext* txn, const string& dbName, BSONObj idx) {
+    void doTTLForIndex(OperationContext* txn, const string& dbName, BSONObj idx) {
         const string ns = idx["ns"].String();
         NamespaceString nss(ns);
         if (!userAllowedWriteNS(nss).isOK()) {
             error() << "namespace '" << ns
                     << "' doesn't allow deletes, skipping ttl job for: " << idx;
-            return true;
+            return;
         }
 
         BSONObj key = idx["key"].Obj();
         if (key.nFields() != 1) {
             error() << "key for ttl index can only have 1 field, skipping ttl job for: " << idx;
-            return true;
+            return;
         }
 
         LOG(1) << "TTL -- ns: " << ns << " key: " << key;
 
+        const string statsKey = ns + ".$" + idx["name"].str();
+
         // Read the current time outside of the while loop, so that we don't expand our index
-        // bounds after every WriteConflictException.
+        // bounds after every WriteConflictException or batch.
         const Date_t now = Date_t::now();
 
+        // Each batch resumes the index scan from the last key deleted by the previous one.
+        Date_t batchStart = Date_t::fromMillisSinceEpoch(std::numeric_limits<long long>::min());
+
         long long numDeleted = 0;
         int attempt = 1;
         while (1) {
+            // A large backlog can take many batches, so stop between them if the server is
+            // shutting down or the TTL monitor has been disabled.
+            if (inShutdown() || !ttlMonitorEnabled) {
+                return;
+            }
+
+            // Wait for the delete budget before taking any locks.
+            const long long batchSize = std::max(1, ttlMonitorBatchSize);
+            const long long granted = ttlDeleteBudget.acquire(batchSize);
+            if (granted == 0) {
+                return;
+            }
+            long long batchDeleted = 0;
+            ON_BLOCK_EXIT([&] { ttlDeleteBudget.release(granted - batchDeleted); });
+
             ScopedTransaction scopedXact(txn, MODE_IX);
             AutoGetDb autoDb(txn, dbName, MODE_IX);
             Database* db = autoDb.getDb();
             if (!db) {
-                return false;
+                return;
             }
 
             Lock::CollectionLock collLock(txn->lockState(), ns, MODE_IX);
@@ -243,20 +480,20 @@ private:
             Collection* collection = db->getCollection(ns);
             if (!collection) {
                 // Collection was dropped.
-                return true;
+                return;
             }
 
             if (!repl::getGlobalReplicationCoordinator()->canAcceptWritesFor(nss)) {
                 // We've stepped down since we started this function, so we should stop working
                 // as we only do deletes on the primary.
-                return false;
+                return;
             }
 
             IndexDescriptor* desc = collection->getIndexCatalog()->findIndexByKeyPattern(txn, key);
             if (!desc) {
                 LOG(1) << "index not found (index build in progress? index dropped?), skipping "
                        << "ttl job for: " << idx;
-                return true;
+                return;
             }
 
             // Re-read 'idx' from the descriptor, in case the collection or index definition
@@ -266,7 +503,7 @@ private:
             if (IndexType::INDEX_BTREE != IndexNames::nameToType(desc->getAccessMethodName())) {
                 error() << "special index can't be used as a ttl index, skipping ttl job for: "
                         << idx;
-                return true;
+                return;
             }
 
             BSONElement secondsExpireElt = idx[secondsExpireField];
@@ -274,13 +511,12 @@ private:
                 error() << "ttl indexes require the " << secondsExpireField << " field to be "
                         << "numeric but received a type of " << typeName(secondsExpireElt.type())
                         << ", skipping ttl job for: " << idx;
-                return true;
+                return;
             }
 
-            const Date_t kDawnOfTime =
-                Date_t::fromMillisSinceEpoch(std::numeric_limits<long long>::min());
-            const BSONObj startKey = BSON("" << kDawnOfTime);
-            const BSONObj endKey = BSON("" << now - Seconds(secondsExpireElt.numberLong()));
+            const Date_t expireBefore = now - Seconds(secondsExpireElt.numberLong());
+            const BSONObj startKey = BSON("" << batchStart);
+            const BSONObj endKey = BSON("" << expireBefore);
             const bool endKeyInclusive = true;
             // The canonical check as to whether a key pattern element is "ascending" or
             // "descending" is (elt.number() >= 0).  This is defined by the Ordering class.
@@ -295,29 +531,69 @@ private:
                 PlanExecutor::ExecState state;
                 BSONObj obj;
                 RecordId rid;
-                while (PlanExecutor::ADVANCED == (state = exec->getNext(&obj, &rid))) {
+                boost::optional<Date_t> firstExpired;
+                while (batchDeleted < granted &&
+                       PlanExecutor::ADVANCED == (state = exec->getNext(&obj, &rid))) {
+                    // 'obj' is the index key of the document.
+                    BSONElement expireElt = obj.firstElement();
+                    if (expireElt.type() == mongo::Date) {
+                        batchStart = expireElt.Date();
+                        if (!firstExpired) {
+                            firstExpired = batchStart;
+                        }
+                    }
+
                     exec->saveState();
                     {
                         WriteUnitOfWork wunit(txn);
                         collection->deleteDocument(txn, rid);
                         wunit.commit();
                     }
+                    ++batchDeleted;
                     ++numDeleted;
                     ttlDeletedDocuments.increment();
                     if (!exec->restoreState()) {
-                        return true;
+                        ttlIndexStats.recordBatch(statsKey, batchDeleted, Seconds(0), 0);
+                        return;
                     }
                 }
 
+                if (batchDeleted == granted) {
+                    // There may be more expired documents. Release the locks before the next
+                    // batch, and estimate the remaining ones from the range this batch covered.
+                    // The estimate is computed as a double since the remaining range can span
+                    // most of the representable dates.
+                    const Milliseconds covered = batchStart - firstExpired.value_or(batchStart);
+                    const Milliseconds remaining = expireBefore - batchStart;
+                    long long pendingEstimate = batchDeleted;
+                    if (covered > Milliseconds(0)) {
+                        const double estimate = static_cast<double>(batchDeleted) *
+                            durationCount<Milliseconds>(remaining) /
+                            durationCount<Milliseconds>(covered);
+                        pendingEstimate =
+                            estimate < static_cast<double>(std::numeric_limits<long long>::max())
+                            ? static_cast<long long>(estimate)
+                            : std::numeric_limits<long long>::max();
+                    }
+                    ttlIndexStats.recordBatch(statsKey,
+                                              batchDeleted,
+                                              duration_cast<Seconds>(now - batchStart),
+                                              pendingEstimate);
+                    attempt = 1;
+                    continue;
+                }
+
+                ttlIndexStats.recordBatch(statsKey, batchDeleted, Seconds(0), 0);
+
                 if (PlanExecutor::FAILURE == state || PlanExecutor::DEAD == state) {
                     if (WorkingSetCommon::isValidStatusMemberObject(obj)) {
                         error() << "ttl query execution for index " << idx
                                 << " failed with: " << WorkingSetCommon::getMemberObjectStatus(obj);
-                        return true;
+                        return;
                     }
                     error() << "ttl query execution for index " << idx
                             << " failed with state: " << PlanExecutor::statestr(state);
-                    return true;
+                    return;
                 }
 
                 invariant(PlanExecutor::IS_EOF == state);
@@ -328,7 +604,6 @@ private:
         }
 
         LOG(1) << "\tTTL deleted: " << numDeleted << endl;
-        return true;
     }
 };
 
@@ -787,7 +787,7 @@ class IntLongNoIntOverflow : public TypeConversionBase {
     }
 };
 
-/** An int and a long overflow. */
+/** An int and a long overflow into a double. */
 class IntLongLongOverflow : public TypeConversionBase {
     Value summand1() {
         return Value(1);
@@ -796,7 +796,7 @@ class IntLongLongOverflow : public TypeConversionBase {
         return Value(numeric_limits<long long>::max());
     }
     Value expectedSum() {
-        return Value(numeric_limits<long long>::max() + 1);
+        return Value(numeric_limits<long long>::max() + 1.0);
     }
 };
 
@@ -813,7 +813,7 @@ class LongLong : public TypeConversionBase {
     }
 };
 
-/** Two longs overflow. */
+/** Two longs overflow into a double. */
 class LongLongOverflow : public TypeConversionBase {
     Value summand1() {
         return Value(numeric_limits<long long>::max());
@@ -822,7 +822,25 @@ class LongLongOverflow : public TypeConversionBase {
         return Value(numeric_limits<long long>::max());
     }
     Value expectedSum() {
-        return Value(numeric_limits<long long>::max() + numeric_limits<long long>::max());
+        return Value((double)numeric_limits<long long>::max() +
+                     (double)numeric_limits<long long>::max());
+    }
+};
+
+/** Two longs which overflow are summed as doubles along with the longs that follow. */
+class LongLongOverflowThenLong : public TypeConversionBase {
+public:
+    void run() {
+        createAccumulator();
+        accumulator()->process(Value(numeric_limits<long long>::min()), false);
+        accumulator()->process(Value(-1024LL), false);
+        accumulator()->process(Value(-1024LL), false);
+        checkSum();
+    }
+
+private:
+    Value expectedSum() {
+        return Value((double)numeric_limits<long long>::min() - 2048);
     }
 };
 
@@ -987,6 +1005,42 @@ class IntUndefined : public TypeConversionBase {
     }
 };
 
+/** Rounding errors do not accumulate when many doubles are summed. */
+class CompensatedDoubles : public TypeConversionBase {
+public:
+    void run() {
+        createAccumulator();
+        for (int i = 0; i < 10; ++i) {
+            accumulator()->process(Value(0.1), false);
+        }
+        checkSum();
+    }
+
+private:
+    Value expectedSum() {
+        return Value(1.0);
+    }
+};
+
+/** Small doubles are not lost when added to a large total. */
+class CompensatedSmallDoubles : public TypeConversionBase {
+public:
+    void run() {
+        createAccumulator();
+        accumulator()->process(Value(1e16), false);
+        for (int i = 0; i < 10; ++i) {
+            accumulator()->process(Value(1.0), false);
+        }
+        accumulator()->process(Value(-1e16), false);
+        checkSum();
+    }
+
+private:
+    Value expectedSum() {
+        return Value(10.0);
+    }
+};
+
 /** Two large integers do not overflow if a double is added later. */
 class NoOverflowBeforeDouble : public TypeConversionBase {
 public:
@@ -1069,6 +1123,7 @@ public:
         add<Sum::IntLongLongOverflow>();
         add<Sum::LongLong>();
         add<Sum::LongLongOverflow>();
+        add<Sum::LongLongOverflowThenLong>();
         add<Sum::IntDouble>();
         add<Sum::IntNanDouble>();
         add<Sum::IntDoubleNoIntOverflow>();
@@ -1082,6 +1137,8 @@ public:
         add<Sum::IntNull>();
         add<Sum::IntUndefined>();
         add<Sum::NoOverflowBeforeDouble>();
+        add<Sum::CompensatedDoubles>();
+        add<Sum::CompensatedSmallDoubles>();
     }
 };
 
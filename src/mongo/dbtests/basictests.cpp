@@ -429,6 +429,25 @@ public:
     }
 };
 
+class QueuePushAllTest {
+public:
+    void run() {
+        BlockingQueue<int> q(3);
+        std::vector<int> batch{1, 2, 3};
+        q.pushAllBlocking(batch.begin(), batch.end());
+        ASSERT_EQUALS(3u, q.count());
+        ASSERT_EQUALS(3u, q.size());
+        ASSERT_EQUALS(1, q.blockingPop());
+
+        // A batch larger than the max size is accepted once the queue has drained.
+        q.clear();
+        std::vector<int> bigBatch{4, 5, 6, 7};
+        q.pushAllBlocking(bigBatch.begin(), bigBatch.end());
+        ASSERT_EQUALS(4u, q.count());
+        ASSERT_EQUALS(4, q.blockingPop());
+    }
+};
+
 class StrTests {
 public:
     void run() {
@@ -502,6 +521,7 @@ public:
         add<IsValidUTF8Test>();
 
         add<QueueTest>();
+        add<QueuePushAllTest>();
 
         add<StrTests>();
 
@@ -2673,6 +2673,74 @@ class MaxKey : public Base {
     }
 };
 
+class StringsAcrossWords : public Base {
+    virtual BSONObj bson() const {
+        BSONObjBuilder b;
+        b.append("a", "0123456789abcdef0123456789abcdef");
+        b.append("b", "0123456789abcdef\"0123456789");
+        b.append("c", "0123456\\89abcdef");
+        b.append("d", "01234567\n");
+        b.append("a long field name, quoted", "\xc3\xa9t\xc3\xa9 0123456789");
+        return b.obj();
+    }
+    virtual string json() const {
+        return "{ \"a\" : \"0123456789abcdef0123456789abcdef\", "
+               "\"b\" : \"0123456789abcdef\\\"0123456789\", "
+               "\"c\" : '0123456\\\\89abcdef', "
+               "\"d\" : \"01234567\\n\", "
+               "\"a long field name, quoted\" : \"\xc3\xa9t\xc3\xa9 0123456789\" }";
+    }
+};
+
+class NumericIntegerWidths : public Base {
+    virtual BSONObj bson() const {
+        BSONObjBuilder b;
+        b.append("a", std::numeric_limits<int>::max());
+        b.append("b", static_cast<long long>(std::numeric_limits<int>::max()) + 1);
+        b.append("c", std::numeric_limits<int>::min());
+        b.append("d", 999999999999999999LL);
+        b.append("e", -1234567890123456789LL);
+        b.append("f", 10000000000000000000.0);
+        b.append("g", 0);
+        return b.obj();
+    }
+    virtual string json() const {
+        return "{ \"a\" : 2147483647, \"b\" : 2147483648, \"c\" : -2147483648, "
+               "\"d\" : 999999999999999999, \"e\" : -1234567890123456789, "
+               "\"f\" : 10000000000000000000, \"g\" : -0 }";
+    }
+};
+
+class Stream {
+public:
+    void run() {
+        vector<BSONObj> docs;
+        const size_t count = fromjsonStream(
+            " {a: 1}\n{\"b\" : 'x', c: [1, {d: 2}]}\r\n\n[3, 4]{}\n ",
+            [&docs](const BSONObj& doc) { docs.push_back(doc.getOwned()); });
+        ASSERT_EQUALS(4U, count);
+        ASSERT_EQUALS(4U, docs.size());
+        ASSERT_EQUALS(BSON("a" << 1), docs[0]);
+        ASSERT_EQUALS(BSON("b"
+                           << "x"
+                           << "c" << BSON_ARRAY(1 << BSON("d" << 2))),
+                      docs[1]);
+        ASSERT_EQUALS(BSON("0" << 3 << "1" << 4), docs[2]);
+        ASSERT_EQUALS(BSONObj(), docs[3]);
+
+        ASSERT_EQUALS(0U, fromjsonStream(" \n", [](const BSONObj&) { ASSERT(false); }));
+
+        // Parsing stops at the first bad object.
+        docs.clear();
+        ASSERT_THROWS(fromjsonStream("{a: 1}\n{a: }\n{a: 3}",
+                                     [&docs](const BSONObj& doc) {
+                                         docs.push_back(doc.getOwned());
+                                     }),
+                      MsgAssertionException);
+        ASSERT_EQUALS(1U, docs.size());
+    }
+};
+
 }  // namespace FromJsonTests
 
 class All : public Suite {
@@ -2935,6 +3003,9 @@ public:
         add<FromJsonTests::NullFieldUnquoted>();
         add<FromJsonTests::MinKey>();
         add<FromJsonTests::MaxKey>();
+        add<FromJsonTests::StringsAcrossWords>();
+        add<FromJsonTests::NumericIntegerWidths>();
+        add<FromJsonTests::Stream>();
     }
 };
 
@@ -33,6 +33,7 @@
 
 #include "mongo/platform/basic.h"
 
+#include <algorithm>
 #include <iostream>
 #include <limits>
 
@@ -2030,6 +2031,100 @@ public:
     }
 };
 
+/**
+ * Test invokeBatch() calls the function once per object, in order, and returns its results.
+ */
+class InvokeBatch {
+public:
+    void run() {
+        unique_ptr<Scope> s(globalScriptEngine->newScope());
+
+        ScriptingFunction f = s->createFunction(
+            "function(y) { seen.push(this.x); return this.x > y; }");
+        s->invokeSafe("seen = [];", 0, 0);
+
+        vector<BSONObj> recvs;
+        for (int i = 0; i < 10; i++) {
+            recvs.push_back(BSON("x" << i));
+        }
+        BSONObj args = BSON("y" << 4);
+
+        vector<bool> returnValues;
+        ASSERT_EQUALS(0, s->invokeBatch(f, &args, recvs, &returnValues));
+        ASSERT_EQUALS(10U, returnValues.size());
+        for (int i = 0; i < 10; i++) {
+            ASSERT_EQUALS(i > 4, static_cast<bool>(returnValues[i]));
+        }
+
+        s->invokeSafe("return seen.join(',');", 0, 0);
+        ASSERT_EQUALS("0,1,2,3,4,5,6,7,8,9", s->getString("__returnValue"));
+
+        // A batch stops at the first error.
+        s->invokeSafe("seen = [];", 0, 0);
+        ScriptingFunction throws = s->createFunction(
+            "function() { seen.push(this.x); if (this.x == 2) throw 'stop'; }");
+        bool caught = false;
+        try {
+            s->invokeBatch(throws, 0, recvs, NULL);
+        } catch (const DBException&) {
+            caught = true;
+        }
+        ASSERT(caught);
+        s->invokeSafe("return seen.join(',');", 0, 0);
+        ASSERT_EQUALS("0,1,2", s->getString("__returnValue"));
+    }
+};
+
+/**
+ * Compares the documents per second of predicates invoked one document at a time, as $where
+ * used to, and in batches, as map functions are.
+ */
+class InvokeBatchSpeed {
+public:
+    void run() {
+        unique_ptr<Scope> s(globalScriptEngine->newScope());
+        ScriptingFunction f = s->createFunction("return this.a.b > 50 && this.c != 'skip';");
+
+        vector<BSONObj> docs;
+        for (int i = 0; i < 100; i++) {
+            docs.push_back(BSON("_id" << i << "a" << BSON("b" << i << "pad" << string(200, 'x'))
+                                      << "c"
+                                      << "keep"
+                                      << "d" << BSON_ARRAY(1 << 2 << 3)));
+        }
+
+        const int rounds = 100;
+        int matched = 0;
+        Timer t;
+        for (int round = 0; round < rounds; round++) {
+            for (const BSONObj& doc : docs) {
+                s->setObject("obj", doc);
+                s->invoke(f, 0, &doc);
+                matched += s->getBoolean("__returnValue");
+            }
+        }
+        const long long perDocumentMicros = std::max<long long>(t.micros(), 1);
+
+        int batchMatched = 0;
+        t.reset();
+        for (int round = 0; round < rounds; round++) {
+            vector<bool> returnValues;
+            s->invokeBatch(f, 0, docs, &returnValues);
+            batchMatched += std::count(returnValues.begin(), returnValues.end(), true);
+        }
+        const long long batchMicros = std::max<long long>(t.micros(), 1);
+
+        ASSERT_EQUALS(49 * rounds, matched);
+        ASSERT_EQUALS(matched, batchMatched);
+
+        const double numDocs = rounds * docs.size();
+        const long long perDocumentRate = numDocs * 1000 * 1000 / perDocumentMicros;
+        const long long batchRate = numDocs * 1000 * 1000 / batchMicros;
+        ::mongo::log() << "invoke per document: " << perDocumentRate
+                       << " docs/sec, invokeBatch: " << batchRate << " docs/sec";
+    }
+};
+
 class ScopeOut {
 public:
     void run() {
@@ -2215,6 +2310,8 @@ public:
         add<VarTests>();
 
         add<Speed1>();
+        add<InvokeBatch>();
+        add<InvokeBatchSpeed>();
 
         add<InvalidUTF8Check>();
         add<Utf8Check>();
@@ -46,12 +46,18 @@
 #include <iostream>
 #include <mutex>
 
+#include "mongo/bson/bson_validate.h"
+#include "mongo/bson/json.h"
+#include "mongo/bson/key_shape_comparator.h"
 #include "mongo/config.h"
 #include "mongo/db/client.h"
 #include "mongo/db/db.h"
 #include "mongo/db/dbdirectclient.h"
+#include "mongo/db/exec/working_set.h"
 #include "mongo/db/lasterror.h"
 #include "mongo/db/operation_context_impl.h"
+#include "mongo/db/pipeline/accumulator.h"
+#include "mongo/db/storage/key_string.h"
 #include "mongo/db/storage/mmap_v1/dur_stats.h"
 #include "mongo/db/storage/mmap_v1/mmap.h"
 #include "mongo/db/storage_options.h"
@@ -59,6 +65,7 @@
 #include "mongo/dbtests/framework_options.h"
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/thread.h"
+#include "mongo/util/buffer_pool.h"
 #include "mongo/util/log.h"
 #include "mongo/util/timer.h"
 #include "mongo/util/version.h"
@@ -444,6 +451,299 @@ public:
     }
 };
 
+/**
+ * Simulates a fetch followed by a yield: each document is materialized unowned into a working
+ * set member, copied to owned memory and then released.
+ */
+class WorkingSetMakeOwned : public B {
+public:
+    WorkingSetMakeOwned() {
+        BSONObjBuilder b;
+        for (int i = 0; i < 20; ++i) {
+            b.append(BSONObjBuilder::numStr(i), i);
+        }
+        _doc = b.obj();
+    }
+    string name() {
+        return "working-set-make-owned";
+    }
+    virtual int howLongMillis() {
+        return 500;
+    }
+    virtual bool showDurStats() {
+        return false;
+    }
+    void timed() {
+        WorkingSetID id = _ws.allocate();
+        WorkingSetMember* member = _ws.get(id);
+        member->obj = Snapshotted<BSONObj>(SnapshotId(), BSONObj(_doc.objdata()));
+        _ws.transitionToLocAndObj(id);
+        member->makeObjOwned();
+        _ws.free(id);
+    }
+
+private:
+    BSONObj _doc;
+    WorkingSet _ws;
+};
+
+/**
+ * Validates, as the server does with every document it receives, a corpus of generated
+ * documents of varied shapes: flat, nested, with arrays, long strings and long field names.
+ */
+class ValidateBSON : public B {
+public:
+    ValidateBSON() : _next(0) {
+        for (int i = 0; i < 1000; ++i) {
+            BSONObjBuilder b;
+            b.append("_id", i);
+            b.append("name", str::stream() << "document number " << i);
+            b.append("value", i * 1.5);
+            b.appendDate("created", Date_t::fromMillisSinceEpoch(i));
+            if (i % 2 == 0) {
+                BSONObjBuilder sub(b.subobjStart("address"));
+                sub.append("street", "a street of a certain length");
+                sub.append("zip", i % 100000);
+                sub.done();
+            }
+            if (i % 3 == 0) {
+                BSONArrayBuilder arr(b.subarrayStart("tags"));
+                for (int j = 0; j < i % 20; ++j) {
+                    arr.append(str::stream() << "tag" << j);
+                }
+                arr.done();
+            }
+            if (i % 5 == 0) {
+                b.append(std::string(40, 'f'), std::string(i % 500, 'x'));
+            }
+            _docs.push_back(b.obj());
+        }
+    }
+    string name() {
+        return "validate-bson";
+    }
+    virtual int howLongMillis() {
+        return 500;
+    }
+    virtual bool showDurStats() {
+        return false;
+    }
+    void timed() {
+        const BSONObj& doc = _docs[_next++ % _docs.size()];
+        verify(validateBSON(doc.objdata(), doc.objsize()).isOK());
+    }
+
+private:
+    std::vector<BSONObj> _docs;
+    size_t _next;
+};
+
+class FromJson : public B {
+public:
+    FromJson() : _next(0) {
+        for (int i = 0; i < 1000; ++i) {
+            BSONObjBuilder b;
+            b.append("_id", i);
+            b.append("name", str::stream() << "document number " << i);
+            b.append("count", 10000000000LL + i);
+            b.append("value", i * 1.5);
+            b.appendDate("created", Date_t::fromMillisSinceEpoch(i));
+            BSONObjBuilder sub(b.subobjStart("address"));
+            sub.append("street", "a street of a certain length");
+            sub.append("zip", i % 100000);
+            sub.done();
+            BSONArrayBuilder arr(b.subarrayStart("tags"));
+            for (int j = 0; j < i % 10; ++j) {
+                arr.append(str::stream() << "tag" << j);
+            }
+            arr.done();
+            _docs.push_back(b.obj().jsonString());
+        }
+    }
+    string name() {
+        return "fromjson";
+    }
+    virtual int howLongMillis() {
+        return 500;
+    }
+    virtual bool showDurStats() {
+        return false;
+    }
+    void timed() {
+        verify(!fromjson(_docs[_next++ % _docs.size()]).isEmpty());
+    }
+
+private:
+    std::vector<std::string> _docs;
+    size_t _next;
+};
+
+/**
+ * Builds a query reply out of small documents the way find does, with the builder's buffer
+ * allocated from malloc or from the thread's BufferPool.
+ */
+template <class Allocator>
+class BuildReply : public B {
+public:
+    BuildReply() {
+        for (int i = 0; i < 100; ++i) {
+            _docs.push_back(BSON("_id" << i << "name" << "a name of moderate length" << "x" << i));
+        }
+    }
+    string name() {
+        return _name;
+    }
+    virtual int howLongMillis() {
+        return 500;
+    }
+    virtual bool showDurStats() {
+        return false;
+    }
+    void prep() {
+        _statsBefore = BufferPool::threadStats();
+    }
+    void timed() {
+        _BufBuilder<Allocator> b;
+        for (const BSONObj& doc : _docs) {
+            b.appendBuf(doc.objdata(), doc.objsize());
+        }
+        verify(b.len() > 0);
+    }
+    void post() {
+        const BufferPool::Stats stats = BufferPool::threadStats();
+        cout << "stats " << setw(42) << left << name() + " pool allocations" << ' ' << right
+             << setw(9) << stats.allocations - _statsBefore.allocations << " cache hits "
+             << stats.cacheHits - _statsBefore.cacheHits << endl;
+    }
+
+private:
+    static const char* _name;
+    std::vector<BSONObj> _docs;
+    BufferPool::Stats _statsBefore;
+};
+
+template <>
+const char* BuildReply<TrivialAllocator>::_name = "bufbuilder-malloc";
+template <>
+const char* BuildReply<PooledAllocator>::_name = "bufbuilder-pooled";
+
+/**
+ * Sorts compound sort keys the way a blocking SortStage does, comparing the keys with woCompare()
+ * or encoding them as KeyStrings and comparing those.
+ */
+template <bool useKeyStrings>
+class SortKeys : public B {
+public:
+    SortKeys()
+        : _pattern(BSON("a" << 1 << "b" << -1 << "c" << 1)), _ordering(Ordering::make(_pattern)) {
+        for (int i = 0; i < 10000; ++i) {
+            _keys.push_back(BSON("" << (i * 7919) % 1000 << "" << "user" + std::to_string(i % 500)
+                                    << "" << i * 1.5));
+        }
+    }
+    string name() {
+        return useKeyStrings ? "sortkeys-keystring" : "sortkeys-wocompare";
+    }
+    virtual int howLongMillis() {
+        return 1000;
+    }
+    virtual bool showDurStats() {
+        return false;
+    }
+    void timed() {
+        if (useKeyStrings) {
+            std::vector<std::string> encoded;
+            encoded.reserve(_keys.size());
+            KeyString keyString;
+            for (const BSONObj& key : _keys) {
+                keyString.resetToSortKey(key, _ordering);
+                encoded.emplace_back(keyString.getBuffer(), keyString.getSize());
+            }
+            std::sort(encoded.begin(), encoded.end());
+        } else {
+            std::vector<BSONObj> keys(_keys);
+            const BSONObj& pattern = _pattern;
+            std::sort(keys.begin(), keys.end(), [&pattern](const BSONObj& lhs, const BSONObj& rhs) {
+                return lhs.woCompare(rhs, pattern, false) < 0;
+            });
+        }
+    }
+
+private:
+    const BSONObj _pattern;
+    const Ordering _ordering;
+    std::vector<BSONObj> _keys;
+};
+
+/**
+ * Sorts index keys of one shape, an int, a string and a long, the way an index build does,
+ * comparing them with woCompare() or with a KeyShapeComparator.
+ */
+template <bool useKeyShape>
+class CompareKeys : public B {
+public:
+    CompareKeys() : _ordering(Ordering::make(BSON("a" << 1 << "b" << -1 << "c" << 1))) {
+        for (int i = 0; i < 10000; ++i) {
+            _keys.push_back(BSON("" << (i * 7919) % 1000 << "" << "user" + std::to_string(i % 500)
+                                    << "" << static_cast<long long>(i)));
+        }
+    }
+    string name() {
+        return useKeyShape ? "comparekeys-keyshape" : "comparekeys-wocompare";
+    }
+    virtual int howLongMillis() {
+        return 1000;
+    }
+    virtual bool showDurStats() {
+        return false;
+    }
+    void timed() {
+        std::vector<BSONObj> keys(_keys);
+        if (useKeyShape) {
+            const KeyShapeComparator comparator(_ordering, keys[0]);
+            std::sort(keys.begin(), keys.end(), [&comparator](const BSONObj& l, const BSONObj& r) {
+                return comparator.compare(l, r) < 0;
+            });
+        } else {
+            const Ordering& ordering = _ordering;
+            std::sort(keys.begin(), keys.end(), [&ordering](const BSONObj& l, const BSONObj& r) {
+                return l.woCompare(r, ordering, false) < 0;
+            });
+        }
+    }
+
+private:
+    const Ordering _ordering;
+    std::vector<BSONObj> _keys;
+};
+
+class SumNumbers : public B {
+public:
+    SumNumbers() {
+        for (int i = 0; i < 10000; ++i) {
+            _values.push_back(i % 2 ? Value(i * 0.01 + 0.001) : Value(i * 1000003LL));
+        }
+    }
+    string name() {
+        return "sumnumbers";
+    }
+    virtual int howLongMillis() {
+        return 1000;
+    }
+    virtual bool showDurStats() {
+        return false;
+    }
+    void timed() {
+        boost::intrusive_ptr<Accumulator> sum = AccumulatorSum::create();
+        for (const Value& value : _values) {
+            sum->process(value, false);
+        }
+        ASSERT_EQUALS(NumberDouble, sum->getValue(false).getType());
+    }
+
+private:
+    std::vector<Value> _values;
+};
 
 class All : public Suite {
 public:
@@ -457,6 +757,16 @@ public:
         add<boosttimed_mutexspeed>();
         add<stdmutexspeed>();
         add<stdtimed_mutexspeed>();
+        add<WorkingSetMakeOwned>();
+        add<ValidateBSON>();
+        add<FromJson>();
+        add<BuildReply<TrivialAllocator>>();
+        add<BuildReply<PooledAllocator>>();
+        add<SortKeys<false>>();
+        add<SortKeys<true>>();
+        add<CompareKeys<false>>();
+        add<CompareKeys<true>>();
+        add<SumNumbers>();
     }
 } myall;
 }
@@ -342,7 +342,7 @@ public:
         oplogUpdateEntryArgs args;
         {
             WriteUnitOfWork wuow(&_txn);
-            coll->updateDocument(&_txn, *it, oldDoc, newDoc, false, false, NULL, args);
+            coll->updateDocument(&_txn, *it, oldDoc, newDoc, false, false, NULL, NULL, args);
             wuow.commit();
         }
         exec->restoreState();
@@ -360,7 +360,7 @@ public:
             oldDoc = coll->docFor(&_txn, *it);
             {
                 WriteUnitOfWork wuow(&_txn);
-                coll->updateDocument(&_txn, *it++, oldDoc, newDoc, false, false, NULL, args);
+                coll->updateDocument(&_txn, *it++, oldDoc, newDoc, false, false, NULL, NULL, args);
                 wuow.commit();
             }
         }
@@ -0,0 +1,178 @@
+/*    Copyright 2015 10gen Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/logger/async_log_writer.h"
+
+#include <algorithm>
+#include <ostream>
+
+#include "mongo/logger/rotatable_file_writer.h"
+#include "mongo/stdx/functional.h"
+#include "mongo/util/concurrency/thread_name.h"
+
+namespace mongo {
+namespace logger {
+
+namespace {
+
+// Every AsyncLogWriter in the process, for flushAll().
+stdx::mutex allWritersMutex;
+std::vector<AsyncLogWriter*> allWriters;
+
+}  // namespace
+
+AsyncLogWriter::AsyncLogWriter(RotatableFileWriter* writer,
+                               size_t maxQueuedLines,
+                               OverflowPolicy overflowPolicy)
+    : _writer(writer),
+      _maxQueuedLines(std::max<size_t>(maxQueuedLines, 1)),
+      _overflowPolicy(overflowPolicy),
+      _lastStatus(Status::OK()),
+      _shutdown(false) {
+    _queue.reserve(_maxQueuedLines);
+    _batch.reserve(_maxQueuedLines);
+
+    stdx::thread t(stdx::bind(&AsyncLogWriter::_writerThread, this));
+    _thread.swap(t);
+
+    stdx::lock_guard<stdx::mutex> lk(allWritersMutex);
+    allWriters.push_back(this);
+}
+
+AsyncLogWriter::~AsyncLogWriter() {
+    {
+        stdx::lock_guard<stdx::mutex> lk(allWritersMutex);
+        allWriters.erase(std::find(allWriters.begin(), allWriters.end(), this));
+    }
+
+    {
+        stdx::lock_guard<stdx::mutex> lk(_queueMutex);
+        _shutdown = true;
+        _queueNotEmpty.notify_one();
+    }
+    _thread.join();
+}
+
+Status AsyncLogWriter::write(std::string line) {
+    stdx::unique_lock<stdx::mutex> lk(_queueMutex);
+    while (_queue.size() >= _maxQueuedLines) {
+        if (_overflowPolicy == OverflowPolicy::kDrop) {
+            _droppedLines.increment();
+            return _lastStatus;
+        }
+        _queueNotFull.wait(lk);
+    }
+
+    _queue.push_back(std::move(line));
+    if (_queue.size() == 1) {
+        _queueNotEmpty.notify_one();
+    }
+    return _lastStatus;
+}
+
+Status AsyncLogWriter::writeNow(const std::string& line) {
+    stdx::lock_guard<stdx::mutex> writeLock(_writeMutex);
+    return _writeQueued_inlock(&line);
+}
+
+Status AsyncLogWriter::flush() {
+    stdx::lock_guard<stdx::mutex> writeLock(_writeMutex);
+    return _writeQueued_inlock(NULL);
+}
+
+void AsyncLogWriter::flushAll() {
+    stdx::lock_guard<stdx::mutex> lk(allWritersMutex);
+    for (AsyncLogWriter* writer : allWriters) {
+        writer->flush();
+    }
+}
+
+long long AsyncLogWriter::getQueuedLines() const {
+    stdx::lock_guard<stdx::mutex> lk(_queueMutex);
+    return _queue.size();
+}
+
+void AsyncLogWriter::_writerThread() {
+    setThreadName("asyncLogWriter");
+
+    while (true) {
+        {
+            stdx::unique_lock<stdx::mutex> lk(_queueMutex);
+            while (_queue.empty() && !_shutdown) {
+                _queueNotEmpty.wait(lk);
+            }
+            if (_queue.empty()) {
+                return;
+            }
+        }
+
+        stdx::lock_guard<stdx::mutex> writeLock(_writeMutex);
+        _writeQueued_inlock(NULL);
+    }
+}
+
+Status AsyncLogWriter::_writeQueued_inlock(const std::string* line) {
+    {
+        stdx::lock_guard<stdx::mutex> lk(_queueMutex);
+        _batch.swap(_queue);
+        _queueNotFull.notify_all();
+    }
+
+    if (_batch.empty() && !line) {
+        return Status::OK();
+    }
+
+    Status status = Status::OK();
+    {
+        RotatableFileWriter::Use useWriter(_writer);
+        status = useWriter.status();
+        if (status.isOK()) {
+            std::ostream& os = useWriter.stream();
+            for (const std::string& queuedLine : _batch) {
+                os.write(queuedLine.data(), queuedLine.size());
+            }
+            if (line) {
+                os.write(line->data(), line->size());
+            }
+            os.flush();
+            status = useWriter.status();
+        }
+    }
+
+    _writtenLines.increment(_batch.size() + (line ? 1 : 0));
+    _writtenBatches.increment();
+    _batch.clear();
+
+    stdx::lock_guard<stdx::mutex> lk(_queueMutex);
+    _lastStatus = status;
+    return status;
+}
+
+}  // namespace logger
+}  // namespace mongo
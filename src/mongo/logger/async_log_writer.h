@@ -0,0 +1,157 @@
+/*    Copyright 2015 10gen Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "mongo/base/counter.h"
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/status.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+
+namespace mongo {
+namespace logger {
+
+class RotatableFileWriter;
+
+/**
+ * Writes lines of log output to a RotatableFileWriter from a dedicated thread, so that threads
+ * which log do not wait for the file.
+ *
+ * Lines are queued in memory, up to a fixed number of lines. The writer thread takes everything
+ * queued at once and writes it with a single flush of the file. When the queue is full, lines are
+ * either dropped and counted, or the logging thread waits for room, depending on the overflow
+ * policy.
+ *
+ * Lines are written in the order they were queued, including those written with writeNow().
+ */
+class AsyncLogWriter {
+    MONGO_DISALLOW_COPYING(AsyncLogWriter);
+
+public:
+    enum class OverflowPolicy {
+        // Wait until the writer thread makes room in the queue.
+        kBlock,
+
+        // Drop the line and count it in getDroppedLines().
+        kDrop,
+    };
+
+    /**
+     * Constructs an instance that writes to "writer", and starts its writer thread. The caller
+     * keeps ownership of "writer", which must outlive the constructed instance.
+     */
+    AsyncLogWriter(RotatableFileWriter* writer,
+                   size_t maxQueuedLines,
+                   OverflowPolicy overflowPolicy);
+
+    /**
+     * Writes all the queued lines and stops the writer thread.
+     */
+    ~AsyncLogWriter();
+
+    /**
+     * Queues "line" to be written by the writer thread.
+     *
+     * Returns the status of the most recent write to the file, since failures to write this line
+     * are only known later.
+     */
+    Status write(std::string line);
+
+    /**
+     * Writes all the queued lines and then "line" on the calling thread, before returning. Used
+     * for messages which must not be lost if the process terminates right after logging them.
+     */
+    Status writeNow(const std::string& line);
+
+    /**
+     * Writes all the queued lines before returning.
+     */
+    Status flush();
+
+    /**
+     * Flushes every AsyncLogWriter in the process. Called before the process exits and before
+     * the log files are rotated.
+     */
+    static void flushAll();
+
+    long long getQueuedLines() const;
+
+    long long getDroppedLines() const {
+        return _droppedLines.get();
+    }
+
+    long long getWrittenLines() const {
+        return _writtenLines.get();
+    }
+
+    long long getWrittenBatches() const {
+        return _writtenBatches.get();
+    }
+
+private:
+    void _writerThread();
+
+    /**
+     * Writes the lines queued so far, followed by "line" if it is not NULL. The caller must hold
+     * _writeMutex.
+     */
+    Status _writeQueued_inlock(const std::string* line);
+
+    RotatableFileWriter* const _writer;
+    const size_t _maxQueuedLines;
+    const OverflowPolicy _overflowPolicy;
+
+    // Held while taking lines from the queue and writing them, so that batches taken by
+    // different threads are written in the order they were queued.
+    stdx::mutex _writeMutex;
+
+    // The batch being written. Swapped with _queue, so both keep their capacity. Guarded by
+    // _writeMutex.
+    std::vector<std::string> _batch;
+
+    // Guards the members below.
+    mutable stdx::mutex _queueMutex;
+    stdx::condition_variable _queueNotEmpty;
+    stdx::condition_variable _queueNotFull;
+    std::vector<std::string> _queue;
+    Status _lastStatus;
+    bool _shutdown;
+
+    Counter64 _droppedLines;
+    Counter64 _writtenLines;
+    Counter64 _writtenBatches;
+
+    stdx::thread _thread;
+};
+
+}  // namespace logger
+}  // namespace mongo
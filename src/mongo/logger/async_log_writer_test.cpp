@@ -0,0 +1,195 @@
+/*    Copyright 2015 10gen Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kDefault
+
+#include "mongo/platform/basic.h"
+
+#include <fstream>
+#include <vector>
+
+#include "mongo/logger/async_log_writer.h"
+#include "mongo/logger/async_rotatable_file_appender.h"
+#include "mongo/logger/logger.h"
+#include "mongo/logger/message_event_utf8_encoder.h"
+#include "mongo/logger/rotatable_file_writer.h"
+#include "mongo/stdx/functional.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/death_test.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/log.h"
+
+namespace {
+using namespace mongo;
+using namespace mongo::logger;
+
+const std::string logFileName("LogTest_AsyncLogWriter.txt");
+
+class AsyncLogWriterTest : public mongo::unittest::Test {
+public:
+    AsyncLogWriterTest() {
+        unlink(logFileName.c_str());
+        ASSERT_OK(RotatableFileWriter::Use(&_fileWriter).setFileName(logFileName, false));
+    }
+
+    virtual ~AsyncLogWriterTest() {
+        unlink(logFileName.c_str());
+    }
+
+protected:
+    static std::vector<std::string> readLines() {
+        std::vector<std::string> lines;
+        std::ifstream ifs(logFileName.c_str());
+        ASSERT_TRUE(ifs.is_open());
+        std::string input;
+        while (std::getline(ifs, input)) {
+            lines.push_back(input);
+        }
+        return lines;
+    }
+
+    RotatableFileWriter _fileWriter;
+};
+
+std::string makeLine(int i) {
+    return "message " + std::to_string(i) + "\n";
+}
+
+TEST_F(AsyncLogWriterTest, WritesLinesInOrder) {
+    {
+        AsyncLogWriter writer(&_fileWriter, 16, AsyncLogWriter::OverflowPolicy::kBlock);
+        for (int i = 0; i < 1000; ++i) {
+            ASSERT_OK(writer.write(makeLine(i)));
+            if (i % 100 == 99) {
+                ASSERT_OK(writer.writeNow(makeLine(i) + "now\n"));
+            }
+        }
+        ASSERT_OK(writer.flush());
+        ASSERT_EQUALS(0, writer.getQueuedLines());
+        ASSERT_EQUALS(0, writer.getDroppedLines());
+        ASSERT_EQUALS(1010, writer.getWrittenLines());
+        ASSERT_LESS_THAN_OR_EQUALS(writer.getWrittenBatches(), writer.getWrittenLines());
+    }
+
+    std::vector<std::string> lines = readLines();
+    ASSERT_EQUALS(1020U, lines.size());
+    size_t next = 0;
+    for (int i = 0; i < 1000; ++i) {
+        ASSERT_EQUALS(makeLine(i), lines[next++] + "\n");
+        if (i % 100 == 99) {
+            ASSERT_EQUALS(makeLine(i), lines[next++] + "\n");
+            ASSERT_EQUALS("now", lines[next++]);
+        }
+    }
+}
+
+TEST_F(AsyncLogWriterTest, DestructorWritesQueuedLines) {
+    {
+        AsyncLogWriter writer(&_fileWriter, 1000, AsyncLogWriter::OverflowPolicy::kBlock);
+        for (int i = 0; i < 500; ++i) {
+            ASSERT_OK(writer.write(makeLine(i)));
+        }
+    }
+    ASSERT_EQUALS(500U, readLines().size());
+}
+
+TEST_F(AsyncLogWriterTest, ConcurrentWriters) {
+    {
+        AsyncLogWriter writer(&_fileWriter, 8, AsyncLogWriter::OverflowPolicy::kBlock);
+        std::vector<stdx::thread> threads;
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([&writer, t] {
+                for (int i = 0; i < 250; ++i) {
+                    writer.write(makeLine(t * 1000 + i));
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        AsyncLogWriter::flushAll();
+        ASSERT_EQUALS(1000, writer.getWrittenLines());
+    }
+
+    // Each thread's lines appear in the order that thread wrote them.
+    std::vector<std::string> lines = readLines();
+    ASSERT_EQUALS(1000U, lines.size());
+    std::vector<int> next(4, 0);
+    for (const std::string& line : lines) {
+        int n = std::stoi(line.substr(line.find(' ') + 1));
+        ASSERT_EQUALS(next[n / 1000]++, n % 1000);
+    }
+}
+
+TEST_F(AsyncLogWriterTest, DropsLinesWhenFull) {
+    const int numLines = 100;
+    long long dropped;
+    {
+        AsyncLogWriter writer(&_fileWriter, 2, AsyncLogWriter::OverflowPolicy::kDrop);
+        {
+            // Keeps the writer thread from writing to the file, so the queue fills up.
+            RotatableFileWriter::Use blockWriter(&_fileWriter);
+            for (int i = 0; i < numLines; ++i) {
+                ASSERT_OK(writer.write(makeLine(i)));
+            }
+            dropped = writer.getDroppedLines();
+            ASSERT_GREATER_THAN_OR_EQUALS(dropped, numLines - 4);
+        }
+        ASSERT_OK(writer.flush());
+        ASSERT_EQUALS(numLines, writer.getWrittenLines() + dropped);
+    }
+
+    // The lines which were not dropped are written in order.
+    std::vector<std::string> lines = readLines();
+    ASSERT_EQUALS(numLines - dropped, static_cast<long long>(lines.size()));
+    for (size_t i = 0; i < lines.size(); ++i) {
+        ASSERT_EQUALS(makeLine(i), lines[i] + "\n");
+    }
+}
+
+DEATH_TEST(AsyncLogWriterDeathTest,
+           InvariantFailureIsWrittenBeforeExit,
+           "***aborting after invariant() failure") {
+    // The log file is the output of this process, which the death test checks. The console
+    // appender is removed, so the lines only get there through the queue of the writer.
+    RotatableFileWriter fileWriter;
+    ASSERT_OK(RotatableFileWriter::Use(&fileWriter).setFileName("/dev/stdout", true));
+    AsyncLogWriter writer(&fileWriter, 100000, AsyncLogWriter::OverflowPolicy::kBlock);
+    logger::MessageLogDomain* domain = logger::globalLogDomain();
+    domain->clearAppenders();
+    domain->attachAppender(logger::MessageLogDomain::AppenderAutoPtr(
+        new AsyncRotatableFileAppender<MessageEventEphemeral>(new MessageEventDetailsEncoder,
+                                                             &writer)));
+
+    // Queues enough lines that the writer thread is still busy when the process exits.
+    for (int i = 0; i < 10000; ++i) {
+        log() << "line " << i;
+    }
+    invariant(false);
+}
+
+}  // namespace
@@ -32,6 +32,8 @@
 
 #include "mongo/s/query/async_results_merger.h"
 
+#include <algorithm>
+
 #include "mongo/db/query/getmore_request.h"
 #include "mongo/db/query/getmore_response.h"
 #include "mongo/db/query/killcursors_request.h"
@@ -143,8 +145,7 @@ boost::optional<BSONObj> AsyncResultsMerger::nextReadySorted() {
     invariant(!_remotes[smallestRemote].docBuffer.empty());
     invariant(_remotes[smallestRemote].status.isOK());
 
-    BSONObj front = _remotes[smallestRemote].docBuffer.front();
-    _remotes[smallestRemote].docBuffer.pop();
+    BSONObj front = popFront_inlock(smallestRemote);
 
     // Re-populate the merging queue with the next result from 'smallestRemote', if it has a
     // next result.
@@ -152,6 +153,7 @@ boost::optional<BSONObj> AsyncResultsMerger::nextReadySorted() {
         _mergeQueue.push(smallestRemote);
     }
 
+    prefetchNextBatch_inlock(smallestRemote);
     return front;
 }
 
@@ -162,8 +164,8 @@ boost::optional<BSONObj> AsyncResultsMerger::nextReadyUnsorted() {
         invariant(_remotes[_gettingFromRemote].status.isOK());
 
         if (_remotes[_gettingFromRemote].hasNext()) {
-            BSONObj front = _remotes[_gettingFromRemote].docBuffer.front();
-            _remotes[_gettingFromRemote].docBuffer.pop();
+            BSONObj front = popFront_inlock(_gettingFromRemote);
+            prefetchNextBatch_inlock(_gettingFromRemote);
             return front;
         }
 
@@ -177,13 +179,75 @@ boost::optional<BSONObj> AsyncResultsMerger::nextReadyUnsorted() {
     return boost::none;
 }
 
+BSONObj AsyncResultsMerger::popFront_inlock(size_t remoteIndex) {
+    auto& remote = _remotes[remoteIndex];
+    BSONObj front = remote.docBuffer.front();
+    remote.docBuffer.pop();
+    _bufferedBytes -= front.objsize();
+    return front;
+}
+
+void AsyncResultsMerger::prefetchNextBatch_inlock(size_t remoteIndex) {
+    auto& remote = _remotes[remoteIndex];
+    if (!_params.prefetchBatches || remote.exhausted() || remote.cbHandle.isValid()) {
+        return;
+    }
+
+    // Ask for the next batch once no more than half of the last one remains, which leaves the rest
+    // of the buffer to hide the round trip to the remote.
+    if (remote.docBuffer.size() * 2 > remote.lastBatchSize) {
+        return;
+    }
+
+    if (_bufferedBytes >= _params.maxBufferedBytes) {
+        return;
+    }
+
+    auto nextBatchStatus = askForNextBatch_inlock(remoteIndex);
+    if (!nextBatchStatus.isOK()) {
+        remote.status = nextBatchStatus;
+    }
+}
+
+boost::optional<long long> AsyncResultsMerger::nextBatchSize_inlock(RemoteCursorData* remote) {
+    if (!_params.prefetchBatches || remote->docsReceived == 0) {
+        return _params.batchSize;
+    }
+
+    // Give each remote an equal share of the buffer.
+    const long long avgDocBytes = std::max(1LL, remote->bytesReceived / remote->docsReceived);
+    const long long maxDocs = std::max(
+        1LL, _params.maxBufferedBytes / static_cast<long long>(_remotes.size()) / avgDocBytes);
+
+    if (!_params.batchSize) {
+        // The remote fills each batch up to its own size limit, which only has to be kept within
+        // this remote's share of the buffer.
+        return maxDocs;
+    }
+
+    if (remote->adaptiveBatchSize == 0) {
+        remote->adaptiveBatchSize = *_params.batchSize;
+    }
+
+    // A consumer that had to wait on this remote is reading faster than the remote is delivering
+    // batches, so fewer, larger batches are worth the extra buffer space.
+    if (remote->stalled) {
+        remote->adaptiveBatchSize *= 2;
+        remote->stalled = false;
+    }
+
+    remote->adaptiveBatchSize = std::max(1LL, std::min(remote->adaptiveBatchSize, maxDocs));
+    return remote->adaptiveBatchSize;
+}
+
 Status AsyncResultsMerger::askForNextBatch_inlock(size_t remoteIndex) {
     auto& remote = _remotes[remoteIndex];
 
     invariant(!remote.cbHandle.isValid());
 
     BSONObj cmdObj = remote.cursorId
-        ? GetMoreRequest(_params.nsString, *remote.cursorId, _params.batchSize, boost::none)
+        ? GetMoreRequest(
+              _params.nsString, *remote.cursorId, nextBatchSize_inlock(&remote), boost::none)
               .toBSON()
         : remote.cmdObj;
 
@@ -225,6 +289,14 @@ StatusWith<executor::TaskExecutor::EventHandle> AsyncResultsMerger::nextEvent()
         // It is illegal to call this method if there is an error received from any shard.
         invariant(remote.status.isOK());
 
+        // Only a remote whose prefetched batch is still in flight kept the consumer waiting. One
+        // that was not asked yet, for instance because the buffer was full, says nothing about
+        // how quickly it delivers.
+        if (remote.gotFirstResponse && !remote.hasNext() && !remote.exhausted() &&
+            remote.cbHandle.isValid()) {
+            remote.stalled = true;
+        }
+
         if (!remote.hasNext() && !remote.exhausted() && !remote.cbHandle.isValid()) {
             // If we already have established a cursor with this remote, and there is no outstanding
             // request for which we have a valid callback handle, then schedule work to retrieve the
@@ -310,13 +382,21 @@ void AsyncResultsMerger::handleBatchResponse(
 
     remote.cursorId = getMoreResponse.cursorId;
 
+    // A prefetched batch can arrive while results of the previous one are still buffered, in which
+    // case the remote is already on the merge queue.
+    const bool wasBufferEmpty = remote.docBuffer.empty();
+
     for (const auto& obj : getMoreResponse.batch) {
         remote.docBuffer.push(obj);
+        remote.bytesReceived += obj.objsize();
+        _bufferedBytes += obj.objsize();
     }
+    remote.lastBatchSize = getMoreResponse.batch.size();
+    remote.docsReceived += getMoreResponse.batch.size();
 
     // If we're doing a sorted merge, then we have to make sure to put this remote onto the
-    // merge queue.
-    if (!_params.sort.isEmpty() && !getMoreResponse.batch.empty()) {
+    // merge queue, unless it is there already.
+    if (!_params.sort.isEmpty() && !getMoreResponse.batch.empty() && wasBufferEmpty) {
         _mergeQueue.push(remoteIndex);
     }
 
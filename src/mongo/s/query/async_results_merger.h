@@ -61,6 +61,10 @@ namespace mongo {
  * This requires waiting until we have a response from every remote before returning results.
  * Without a sort, we are ready to return results as soon as we have *any* response from a remote.
  *
+ * If batch prefetching is enabled in the ClusterClientCursorParams, the next batch from a remote is
+ * requested while results from its previous batch are still buffered, so that merging does not
+ * wait on a full round trip to the remote every time its buffer empties.
+ *
  * On any error, the caller is responsible for shutting down the ARM using the kill() method.
  *
  * Does not throw exceptions.
@@ -169,6 +173,21 @@ private:
 
         // Set to true once we have heard from the remote node at least once.
         bool gotFirstResponse = false;
+
+        // Number of results in the last batch received from the remote.
+        size_t lastBatchSize = 0;
+
+        // Totals over all batches received from the remote, used to estimate the document size.
+        long long docsReceived = 0;
+        long long bytesReceived = 0;
+
+        // The batch size requested with the last getMore when batch sizes adapt, or zero if none
+        // has been chosen yet.
+        long long adaptiveBatchSize = 0;
+
+        // Set when the consumer needed results from this remote while none were buffered and its
+        // next batch was already requested. Grows the batch size of the next getMore.
+        bool stalled = false;
     };
 
     class MergingComparator {
@@ -202,6 +221,21 @@ private:
      */
     Status askForNextBatch_inlock(size_t remoteIndex);
 
+    /**
+     * Returns the batch size to request with the next getMore sent to 'remote'. Without batch
+     * prefetching this is the configured batch size. Otherwise the size doubles each time the
+     * consumer stalled on the remote, and is bounded by the remote's share of
+     * '_params.maxBufferedBytes' given the average size of the documents it returned so far.
+     */
+    boost::optional<long long> nextBatchSize_inlock(RemoteCursorData* remote);
+
+    /**
+     * Called after a result was taken from the buffer of the remote at 'remoteIndex'. If batch
+     * prefetching is enabled and the buffer has run low, asks the remote for its next batch before
+     * the buffer runs dry, as long as the total buffered size is below the limit.
+     */
+    void prefetchNextBatch_inlock(size_t remoteIndex);
+
     //
     // Helpers for ready().
     //
@@ -217,6 +251,11 @@ private:
     boost::optional<BSONObj> nextReadySorted();
     boost::optional<BSONObj> nextReadyUnsorted();
 
+    /**
+     * Removes and returns the result at the front of the buffer of the remote at 'remoteIndex'.
+     */
+    BSONObj popFront_inlock(size_t remoteIndex);
+
     /**
      * When nextEvent() schedules remote work, it passes this method as a callback. The TaskExecutor
      * will call this function, passing the response from the remote.
@@ -264,6 +303,9 @@ private:
     // Used only if there is *not* a sort.
     size_t _gettingFromRemote = 0;
 
+    // Total size in bytes of the results currently buffered from all remotes.
+    long long _bufferedBytes = 0;
+
     Status _status = Status::OK();
 
     executor::TaskExecutor::EventHandle _currentEvent;
@@ -139,6 +139,32 @@ protected:
         net->exitNetwork();
     }
 
+    /**
+     * Responds to the next ready request on the mock network with 'response'. Returns the command
+     * object of the request.
+     */
+    BSONObj scheduleNetworkResponseToNextRequest(const GetMoreResponse& response) {
+        executor::NetworkInterfaceMock* net = getNet();
+        net->enterNetwork();
+        ASSERT_TRUE(net->hasReadyRequests());
+        auto noi = net->getNextReadyRequest();
+        BSONObj cmdObj = noi->getRequest().cmdObj;
+        RemoteCommandResponse commandResponse(response.toBSON(), BSONObj(), Milliseconds(0));
+        executor::TaskExecutor::ResponseStatus responseStatus(commandResponse);
+        net->scheduleResponse(noi, net->now(), responseStatus);
+        net->runReadyNetworkOperations();
+        net->exitNetwork();
+        return cmdObj;
+    }
+
+    bool hasReadyRequests() {
+        executor::NetworkInterfaceMock* net = getNet();
+        net->enterNetwork();
+        bool hasReadyRequests = net->hasReadyRequests();
+        net->exitNetwork();
+        return hasReadyRequests;
+    }
+
     void runReadyNetworkOperations() {
         executor::NetworkInterfaceMock* net = getNet();
         net->enterNetwork();
@@ -736,6 +762,215 @@ TEST_F(AsyncResultsMergerTest, KillCalledTwice) {
     executor->waitForEvent(killedEvent2);
 }
 
+TEST_F(AsyncResultsMergerTest, PrefetchNextBatchBeforeBufferEmpties) {
+    BSONObj findCmd = fromjson("{find: 'testcoll', batchSize: 4}");
+    makeCursorFromFindCmd(findCmd, {_remotes[0]}, 4);
+    params.prefetchBatches = true;
+
+    auto readyEvent = unittest::assertGet(arm->nextEvent());
+    std::vector<GetMoreResponse> responses;
+    std::vector<BSONObj> batch1 = {
+        fromjson("{_id: 1}"), fromjson("{_id: 2}"), fromjson("{_id: 3}"), fromjson("{_id: 4}")};
+    responses.emplace_back(_nss, CursorId(1), batch1);
+    scheduleNetworkResponses(responses);
+    executor->waitForEvent(readyEvent);
+
+    // Three of the four results are still buffered, so there is no need for the next batch yet.
+    ASSERT_TRUE(arm->ready());
+    ASSERT_EQ(fromjson("{_id: 1}"), *unittest::assertGet(arm->nextReady()));
+    ASSERT_FALSE(hasReadyRequests());
+
+    // Once half of the batch has been consumed, the ARM asks for the next one on its own.
+    ASSERT_TRUE(arm->ready());
+    ASSERT_EQ(fromjson("{_id: 2}"), *unittest::assertGet(arm->nextReady()));
+    ASSERT_TRUE(hasReadyRequests());
+
+    std::vector<BSONObj> batch2 = {fromjson("{_id: 5}"), fromjson("{_id: 6}")};
+    BSONObj getMoreCmd =
+        scheduleNetworkResponseToNextRequest(GetMoreResponse(_nss, CursorId(0), batch2));
+    ASSERT_EQ(4, getMoreCmd["batchSize"].numberLong());
+
+    // The remaining results are returned without ever waiting on the remote.
+    for (int id = 3; id <= 6; ++id) {
+        ASSERT_TRUE(arm->ready());
+        ASSERT_EQ(BSON("_id" << id), *unittest::assertGet(arm->nextReady()));
+    }
+    ASSERT_TRUE(arm->ready());
+    ASSERT(!unittest::assertGet(arm->nextReady()));
+}
+
+TEST_F(AsyncResultsMergerTest, PrefetchSortedFromMultipleRemotes) {
+    BSONObj findCmd = fromjson("{find: 'testcoll', sort: {_id: 1}, batchSize: 4}");
+    makeCursorFromFindCmd(findCmd, {_remotes[0], _remotes[1]}, 4);
+    params.prefetchBatches = true;
+
+    auto readyEvent = unittest::assertGet(arm->nextEvent());
+    std::vector<GetMoreResponse> responses;
+    std::vector<BSONObj> batch1 = {
+        fromjson("{_id: 1}"), fromjson("{_id: 3}"), fromjson("{_id: 5}"), fromjson("{_id: 7}")};
+    responses.emplace_back(_nss, CursorId(1), batch1);
+    std::vector<BSONObj> batch2 = {fromjson("{_id: 2}"),
+                                   fromjson("{_id: 4}"),
+                                   fromjson("{_id: 6}"),
+                                   fromjson("{_id: 8}"),
+                                   fromjson("{_id: 10}"),
+                                   fromjson("{_id: 12}")};
+    responses.emplace_back(_nss, CursorId(0), batch2);
+    scheduleNetworkResponses(responses);
+    executor->waitForEvent(readyEvent);
+
+    for (int id = 1; id <= 3; ++id) {
+        ASSERT_TRUE(arm->ready());
+        ASSERT_EQ(BSON("_id" << id), *unittest::assertGet(arm->nextReady()));
+    }
+
+    // The next batch of the first remote arrives while two of its results are still buffered and
+    // the remote is on the merge queue.
+    std::vector<BSONObj> batch3 = {fromjson("{_id: 9}"), fromjson("{_id: 11}")};
+    BSONObj getMoreCmd =
+        scheduleNetworkResponseToNextRequest(GetMoreResponse(_nss, CursorId(0), batch3));
+    ASSERT_EQ(4, getMoreCmd["batchSize"].numberLong());
+
+    // Draining the first remote across both of its batches leaves no stale entry behind on the
+    // merge queue.
+    for (int id = 4; id <= 12; ++id) {
+        ASSERT_TRUE(arm->ready());
+        ASSERT_EQ(BSON("_id" << id), *unittest::assertGet(arm->nextReady()));
+    }
+    ASSERT_TRUE(arm->ready());
+    ASSERT(!unittest::assertGet(arm->nextReady()));
+}
+
+TEST_F(AsyncResultsMergerTest, PrefetchRespectsBufferedBytesLimit) {
+    BSONObj findCmd = fromjson("{find: 'testcoll', batchSize: 4}");
+    makeCursorFromFindCmd(findCmd, {_remotes[0]}, 4);
+    params.prefetchBatches = true;
+
+    // Each of the results below is 14 bytes, so this leaves room for a single buffered result.
+    params.maxBufferedBytes = 25;
+
+    auto readyEvent = unittest::assertGet(arm->nextEvent());
+    std::vector<GetMoreResponse> responses;
+    std::vector<BSONObj> batch1 = {
+        fromjson("{_id: 1}"), fromjson("{_id: 2}"), fromjson("{_id: 3}"), fromjson("{_id: 4}")};
+    responses.emplace_back(_nss, CursorId(1), batch1);
+    scheduleNetworkResponses(responses);
+    executor->waitForEvent(readyEvent);
+
+    ASSERT_TRUE(arm->ready());
+    ASSERT_EQ(fromjson("{_id: 1}"), *unittest::assertGet(arm->nextReady()));
+    ASSERT_TRUE(arm->ready());
+    ASSERT_EQ(fromjson("{_id: 2}"), *unittest::assertGet(arm->nextReady()));
+    ASSERT_FALSE(hasReadyRequests());
+
+    ASSERT_TRUE(arm->ready());
+    ASSERT_EQ(fromjson("{_id: 3}"), *unittest::assertGet(arm->nextReady()));
+    ASSERT_TRUE(hasReadyRequests());
+
+    // The batch size is limited to what fits into the buffer.
+    std::vector<BSONObj> batch2 = {fromjson("{_id: 5}")};
+    BSONObj getMoreCmd =
+        scheduleNetworkResponseToNextRequest(GetMoreResponse(_nss, CursorId(0), batch2));
+    ASSERT_EQ(1, getMoreCmd["batchSize"].numberLong());
+
+    ASSERT_TRUE(arm->ready());
+    ASSERT_EQ(fromjson("{_id: 4}"), *unittest::assertGet(arm->nextReady()));
+    ASSERT_TRUE(arm->ready());
+    ASSERT_EQ(fromjson("{_id: 5}"), *unittest::assertGet(arm->nextReady()));
+    ASSERT_TRUE(arm->ready());
+    ASSERT(!unittest::assertGet(arm->nextReady()));
+}
+
+TEST_F(AsyncResultsMergerTest, PrefetchBatchSizeGrowsAfterStall) {
+    BSONObj findCmd = fromjson("{find: 'testcoll', batchSize: 2}");
+    makeCursorFromFindCmd(findCmd, {_remotes[0]}, 2);
+    params.prefetchBatches = true;
+
+    auto readyEvent = unittest::assertGet(arm->nextEvent());
+    std::vector<GetMoreResponse> responses;
+    std::vector<BSONObj> batch1 = {fromjson("{_id: 1}"), fromjson("{_id: 2}")};
+    responses.emplace_back(_nss, CursorId(1), batch1);
+    scheduleNetworkResponses(responses);
+    executor->waitForEvent(readyEvent);
+
+    ASSERT_TRUE(arm->ready());
+    ASSERT_EQ(fromjson("{_id: 1}"), *unittest::assertGet(arm->nextReady()));
+    ASSERT_TRUE(hasReadyRequests());
+    ASSERT_TRUE(arm->ready());
+    ASSERT_EQ(fromjson("{_id: 2}"), *unittest::assertGet(arm->nextReady()));
+
+    // The consumer catches up with the remote before the prefetched batch arrives.
+    ASSERT_FALSE(arm->ready());
+    readyEvent = unittest::assertGet(arm->nextEvent());
+
+    std::vector<BSONObj> batch2 = {fromjson("{_id: 3}"), fromjson("{_id: 4}")};
+    BSONObj getMoreCmd =
+        scheduleNetworkResponseToNextRequest(GetMoreResponse(_nss, CursorId(1), batch2));
+    ASSERT_EQ(2, getMoreCmd["batchSize"].numberLong());
+    executor->waitForEvent(readyEvent);
+
+    // Having stalled, the ARM asks for a larger batch next time.
+    ASSERT_TRUE(arm->ready());
+    ASSERT_EQ(fromjson("{_id: 3}"), *unittest::assertGet(arm->nextReady()));
+    std::vector<BSONObj> batch3 = {fromjson("{_id: 5}")};
+    getMoreCmd = scheduleNetworkResponseToNextRequest(GetMoreResponse(_nss, CursorId(0), batch3));
+    ASSERT_EQ(4, getMoreCmd["batchSize"].numberLong());
+
+    ASSERT_TRUE(arm->ready());
+    ASSERT_EQ(fromjson("{_id: 4}"), *unittest::assertGet(arm->nextReady()));
+    ASSERT_TRUE(arm->ready());
+    ASSERT_EQ(fromjson("{_id: 5}"), *unittest::assertGet(arm->nextReady()));
+    ASSERT_TRUE(arm->ready());
+    ASSERT(!unittest::assertGet(arm->nextReady()));
+}
+
+TEST_F(AsyncResultsMergerTest, PrefetchBatchSizeKeptWhenBufferWasFull) {
+    BSONObj findCmd = fromjson("{find: 'testcoll', sort: {_id: 1}, batchSize: 2}");
+    makeCursorFromFindCmd(findCmd, {_remotes[0], _remotes[1]}, 2);
+    params.prefetchBatches = true;
+
+    // The results of the second remote alone exceed this, so the first one is never prefetched.
+    params.maxBufferedBytes = 200;
+
+    auto readyEvent = unittest::assertGet(arm->nextEvent());
+    std::vector<GetMoreResponse> responses;
+    std::vector<BSONObj> batch1 = {fromjson("{_id: 1}"), fromjson("{_id: 2}")};
+    responses.emplace_back(_nss, CursorId(1), batch1);
+    const std::string padding(100, 'x');
+    std::vector<BSONObj> batch2;
+    for (int id = 10; id < 13; ++id) {
+        batch2.push_back(BSON("_id" << id << "padding" << padding));
+    }
+    responses.emplace_back(_nss, CursorId(0), batch2);
+    scheduleNetworkResponses(responses);
+    executor->waitForEvent(readyEvent);
+
+    ASSERT_TRUE(arm->ready());
+    ASSERT_EQ(fromjson("{_id: 1}"), *unittest::assertGet(arm->nextReady()));
+    ASSERT_TRUE(arm->ready());
+    ASSERT_EQ(fromjson("{_id: 2}"), *unittest::assertGet(arm->nextReady()));
+    ASSERT_FALSE(hasReadyRequests());
+
+    // The consumer waits on the first remote, but only because its next batch was never asked
+    // for, so the batch size does not grow.
+    ASSERT_FALSE(arm->ready());
+    readyEvent = unittest::assertGet(arm->nextEvent());
+    std::vector<BSONObj> batch3 = {fromjson("{_id: 3}")};
+    BSONObj getMoreCmd =
+        scheduleNetworkResponseToNextRequest(GetMoreResponse(_nss, CursorId(0), batch3));
+    ASSERT_EQ(2, getMoreCmd["batchSize"].numberLong());
+    executor->waitForEvent(readyEvent);
+
+    ASSERT_TRUE(arm->ready());
+    ASSERT_EQ(fromjson("{_id: 3}"), *unittest::assertGet(arm->nextReady()));
+    for (const auto& obj : batch2) {
+        ASSERT_TRUE(arm->ready());
+        ASSERT_EQ(obj, *unittest::assertGet(arm->nextReady()));
+    }
+    ASSERT_TRUE(arm->ready());
+    ASSERT(!unittest::assertGet(arm->nextReady()));
+}
+
 }  // namespace
 
 }  // namespace mongo
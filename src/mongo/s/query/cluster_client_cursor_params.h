@@ -74,6 +74,17 @@ struct ClusterClientCursorParams {
     // Limits the number of results returned by the ClusterClientCursor to this many. Optional.
     // Should be forwarded to the remote hosts in 'cmdObj'.
     boost::optional<long long> limit;
+
+    // If true, the next batch is requested from a remote as soon as no more than half of the
+    // results from its last batch remain buffered, rather than only once they have all been
+    // consumed. The getMore batch size then adapts to the document size and to how often the
+    // consumer has to wait on the remote.
+    bool prefetchBatches = false;
+
+    // Bound on the total size in bytes of the results buffered across all remotes. No batch is
+    // requested ahead of time while this much is buffered, and adaptive batch sizes are limited to
+    // each remote's equal share of it. Only used if 'prefetchBatches' is true.
+    long long maxBufferedBytes = 64 * 1024 * 1024;
 };
 
 }  // mongo
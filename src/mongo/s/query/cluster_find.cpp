@@ -41,6 +41,7 @@
 #include "mongo/db/query/canonical_query.h"
 #include "mongo/db/query/find_common.h"
 #include "mongo/db/query/getmore_request.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/s/catalog/catalog_cache.h"
 #include "mongo/s/chunk_manager.h"
 #include "mongo/s/client/shard_registry.h"
@@ -53,6 +54,38 @@
 
 namespace mongo {
 
+/**
+ * If true, mongos asks each shard for its next batch of results while part of the previous batch
+ * is still buffered, and adapts the getMore batch size to the document size and consumption rate.
+ */
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryMongosPrefetchBatches, bool, true);
+
+/**
+ * Bound on the total size in bytes of results that mongos buffers from the shards for a single
+ * cursor when prefetching batches.
+ */
+int internalQueryMongosMaxBufferedBytes = 64 * 1024 * 1024;
+
+class ExportedMaxBufferedBytesParameter : public ExportedServerParameter<int> {
+public:
+    ExportedMaxBufferedBytesParameter()
+        : ExportedServerParameter<int>(ServerParameterSet::getGlobal(),
+                                       "internalQueryMongosMaxBufferedBytes",
+                                       &internalQueryMongosMaxBufferedBytes,
+                                       true,   // allowedToChangeAtStartup
+                                       true)   // allowedToChangeAtRuntime
+    {}
+
+    virtual Status validate(const int& potentialNewValue) {
+        if (potentialNewValue <= 0) {
+            return Status(ErrorCodes::BadValue,
+                          "internalQueryMongosMaxBufferedBytes must be greater than 0");
+        }
+        return Status::OK();
+    }
+
+} exportedMaxBufferedBytesParam;
+
 namespace {
 
 /**
@@ -121,6 +154,8 @@ StatusWith<CursorId> runQueryWithoutRetrying(OperationContext* txn,
     params.batchSize = query.getParsed().getBatchSize();
     params.sort = query.getParsed().getSort();
     params.skip = query.getParsed().getSkip();
+    params.prefetchBatches = internalQueryMongosPrefetchBatches;
+    params.maxBufferedBytes = internalQueryMongosMaxBufferedBytes;
 
     const auto lpqToForward = transformQueryForShards(query.getParsed());
 
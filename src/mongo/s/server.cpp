@@ -55,6 +55,7 @@
 #include "mongo/db/service_context.h"
 #include "mongo/db/service_context_noop.h"
 #include "mongo/db/startup_warnings_common.h"
+#include "mongo/logger/async_log_writer.h"
 #include "mongo/platform/process_id.h"
 #include "mongo/s/balance.h"
 #include "mongo/s/catalog/catalog_manager.h"
@@ -446,10 +447,12 @@ void mongo::dbexit(ExitCode rc, const char* why) {
     //
     if (rc == EXIT_WINDOWS_SERVICE_STOP) {
         log() << "dbexit: exiting because Windows service was stopped";
+        logger::AsyncLogWriter::flushAll();
         return;
     }
 #endif
 
     log() << "dbexit: " << why << " rc:" << rc;
+    logger::AsyncLogWriter::flushAll();
     quickExit(rc);
 }
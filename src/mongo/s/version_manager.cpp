@@ -34,7 +34,9 @@
 
 #include "mongo/s/version_manager.h"
 
+#include "mongo/base/counter.h"
 #include "mongo/client/dbclient_rs.h"
+#include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/s/catalog/catalog_cache.h"
 #include "mongo/s/catalog/catalog_manager.h"
@@ -56,11 +58,22 @@ using std::string;
 
 namespace {
 
+// Number of setShardVersion commands sent to versioned namespaces, and of those which were not
+// sent because the connection already had the current shard version
+Counter64 setShardVersionSent;
+Counter64 setShardVersionSkipped;
+
+ServerStatusMetricField<Counter64> displaySetShardVersionSent("sharding.setShardVersion.sent",
+                                                              &setShardVersionSent);
+ServerStatusMetricField<Counter64> displaySetShardVersionSkipped(
+    "sharding.setShardVersion.skipped", &setShardVersionSkipped);
+
 /**
  * Tracking information, per-connection, of the latest chunk manager iteration or sequence
- * number that was used to send a shard version over this connection.
+ * number that was used to send a shard version over this connection, along with that version.
  * When the chunk manager is replaced, implying new versions were loaded, the chunk manager
- * sequence number is iterated by 1 and connections need to re-send shard versions.
+ * sequence number is iterated by 1 and connections need to re-send shard versions, unless the
+ * version of the shard they are connected to did not change.
  */
 class ConnectionShardStatus {
 public:
@@ -71,24 +84,33 @@ public:
         return seenConnIt != _map.end() && seenConnIt->second.size() > 0;
     }
 
-    bool getSequence(DBClientBase* conn, const string& ns, unsigned long long* sequence) {
+    bool getSequence(DBClientBase* conn,
+                     const string& ns,
+                     unsigned long long* sequence,
+                     ChunkVersion* version) {
         stdx::lock_guard<stdx::mutex> lk(_mutex);
 
         SequenceMap::const_iterator seenConnIt = _map.find(conn->getConnectionId());
         if (seenConnIt == _map.end())
             return false;
 
-        map<string, unsigned long long>::const_iterator seenNSIt = seenConnIt->second.find(ns);
+        map<string, SentVersion>::const_iterator seenNSIt = seenConnIt->second.find(ns);
         if (seenNSIt == seenConnIt->second.end())
             return false;
 
-        *sequence = seenNSIt->second;
+        *sequence = seenNSIt->second.sequence;
+        *version = seenNSIt->second.version;
         return true;
     }
 
-    void setSequence(DBClientBase* conn, const string& ns, const unsigned long long& s) {
+    void setSequence(DBClientBase* conn,
+                     const string& ns,
+                     const unsigned long long& s,
+                     const ChunkVersion& version) {
         stdx::lock_guard<stdx::mutex> lk(_mutex);
-        _map[conn->getConnectionId()][ns] = s;
+        SentVersion& sent = _map[conn->getConnectionId()][ns];
+        sent.sequence = s;
+        sent.version = version;
     }
 
     void reset(DBClientBase* conn) {
@@ -97,11 +119,17 @@ public:
     }
 
 private:
+    struct SentVersion {
+        unsigned long long sequence = 0;
+        ChunkVersion version;
+    };
+
     // protects _map
     stdx::mutex _mutex;
 
-    // a map from a connection into ChunkManager's sequence number for each namespace
-    typedef map<unsigned long long, map<string, unsigned long long>> SequenceMap;
+    // a map from a connection into ChunkManager's sequence number and the shard version sent
+    // for each namespace
+    typedef map<unsigned long long, map<string, SentVersion>> SequenceMap;
     SequenceMap _map;
 
 } connectionShardStatus;
@@ -250,7 +278,7 @@ bool initShardVersionEmptyNS(DBClientBase* conn_in) {
 
     LOG(3) << "initial sharding result : " << result;
 
-    connectionShardStatus.setSequence(conn, "", 0);
+    connectionShardStatus.setSequence(conn, "", 0, ChunkVersion());
     return ok;
 }
 
@@ -349,18 +377,31 @@ bool checkShardVersion(DBClientBase* conn_in,
         return false;
     }
 
+    ChunkVersion version = ChunkVersion(0, 0, OID());
+    if (manager) {
+        version = manager->getVersion(shard->getId());
+    }
+
     // Has the ChunkManager been reloaded since the last time we updated the shard version over
     // this connection?  If we've never updated the shard version, do so now.
     unsigned long long sequenceNumber = 0;
-    if (connectionShardStatus.getSequence(conn, ns, &sequenceNumber)) {
+    ChunkVersion sentVersion;
+    if (connectionShardStatus.getSequence(conn, ns, &sequenceNumber, &sentVersion)) {
         if (sequenceNumber == officialSequenceNumber) {
             return false;
         }
-    }
 
-    ChunkVersion version = ChunkVersion(0, 0, OID());
-    if (manager) {
-        version = manager->getVersion(shard->getId());
+        // Reloads caused by migrations and splits mostly change the versions of other shards.
+        // If the version of this shard is the one this connection already has, there is nothing
+        // to send. Authoritative requests always go out, since the shard asked for them.
+        if (!authoritative && sentVersion.isStrictlyEqualTo(version)) {
+            LOG(3) << "shard version " << version << " for " << ns << " already set on "
+                   << conn->getServerAddress() << ", chunk manager iteration "
+                   << officialSequenceNumber;
+            connectionShardStatus.setSequence(conn, ns, officialSequenceNumber, version);
+            setShardVersionSkipped.increment();
+            return false;
+        }
     }
 
     LOG(1) << "setting shard version of " << version << " for " << ns << " on shard "
@@ -369,6 +410,8 @@ bool checkShardVersion(DBClientBase* conn_in,
     LOG(3) << "last version sent with chunk manager iteration " << sequenceNumber
            << ", current chunk manager iteration is " << officialSequenceNumber;
 
+    setShardVersionSent.increment();
+
     BSONObj result;
     if (setShardVersion(*conn,
                         ns,
@@ -378,7 +421,7 @@ bool checkShardVersion(DBClientBase* conn_in,
                         authoritative,
                         result)) {
         LOG(1) << "      setShardVersion success: " << result;
-        connectionShardStatus.setSequence(conn, ns, officialSequenceNumber);
+        connectionShardStatus.setSequence(conn, ns, officialSequenceNumber, version);
         return true;
     }
 
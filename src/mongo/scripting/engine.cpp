@@ -116,6 +116,23 @@ int Scope::invoke(const char* code, const BSONObj* args, const BSONObj* recv, in
     return invoke(func, args, recv, timeoutMs);
 }
 
+int Scope::invokeBatch(ScriptingFunction func,
+                       const BSONObj* args,
+                       const std::vector<BSONObj>& recvs,
+                       std::vector<bool>* returnValues,
+                       int timeoutMs,
+                       bool readOnlyArgs,
+                       bool readOnlyRecvs) {
+    for (const BSONObj& recv : recvs) {
+        int res = invoke(func, args, &recv, timeoutMs, !returnValues, readOnlyArgs, readOnlyRecvs);
+        if (res != 0)
+            return res;
+        if (returnValues)
+            returnValues->push_back(getBoolean("__returnValue"));
+    }
+    return 0;
+}
+
 bool Scope::execFile(const string& filename, bool printResult, bool reportError, int timeoutMs) {
 #ifdef _WIN32
     boost::filesystem::path p(toWideString(filename.c_str()));
@@ -136,6 +136,24 @@ public:
         uasserted(9005, std::string("invoke failed: ") + getError());
     }
 
+    /**
+     * Invokes "func" once for each object of "recvs", with that object as "this" and "args" as
+     * the arguments, in a single call into the engine. "args" are converted once for the whole
+     * batch, and "timeoutMs" applies to the whole batch.
+     *
+     * If "returnValues" is not NULL, the truthiness of each invocation's return value is
+     * appended to it. __returnValue is not set.
+     *
+     * @return 0 on success
+     */
+    virtual int invokeBatch(ScriptingFunction func,
+                            const BSONObj* args,
+                            const std::vector<BSONObj>& recvs,
+                            std::vector<bool>* returnValues,
+                            int timeoutMs = 0,
+                            bool readOnlyArgs = false,
+                            bool readOnlyRecvs = false);
+
     virtual void injectNative(const char* field, NativeFunction func, void* data = 0) = 0;
 
     virtual bool exec(StringData code,
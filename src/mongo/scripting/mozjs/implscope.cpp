@@ -537,6 +537,61 @@ int MozJSImplScope::invoke(ScriptingFunction func,
     return 0;
 }
 
+int MozJSImplScope::invokeBatch(ScriptingFunction func,
+                                const BSONObj* argsObject,
+                                const std::vector<BSONObj>& recvs,
+                                std::vector<bool>* returnValues,
+                                int timeoutMs,
+                                bool readOnlyArgs,
+                                bool readOnlyRecvs) {
+    MozJSEntry entry(this);
+
+    auto funcValue = _funcs[func - 1];
+
+    const int nargs = argsObject ? argsObject->nFields() : 0;
+
+    JS::AutoValueVector args(_context);
+
+    if (nargs) {
+        BSONObjIterator it(*argsObject);
+        for (int i = 0; i < nargs; i++) {
+            BSONElement next = it.next();
+
+            JS::RootedValue value(_context);
+            ValueReader(_context, &value).fromBSONElement(next, readOnlyArgs);
+
+            args.append(value);
+        }
+    }
+
+    if (timeoutMs)
+        _engine->getDeadlineMonitor().startDeadline(this, timeoutMs);
+
+    // The objects are wrapped lazily, so only the fields the function reads are converted.
+    JS::RootedValue smrecv(_context);
+    JS::RootedObject obj(_context);
+    JS::RootedValue out(_context);
+    bool success = true;
+    for (const BSONObj& recv : recvs) {
+        ValueReader(_context, &smrecv).fromBSON(recv, readOnlyRecvs);
+        obj = smrecv.toObjectOrNull();
+
+        success = JS::Call(_context, obj, funcValue, args, &out);
+        if (!success)
+            break;
+
+        if (returnValues)
+            returnValues->push_back(ValueWriter(_context, out).toBoolean());
+    }
+
+    if (timeoutMs)
+        _engine->getDeadlineMonitor().stopDeadline(this);
+
+    _checkErrorState(success);
+
+    return 0;
+}
+
 bool MozJSImplScope::exec(StringData code,
                           const std::string& name,
                           bool printResult,
@@ -126,6 +126,14 @@ public:
                bool readOnlyArgs = false,
                bool readOnlyRecv = false) override;
 
+    int invokeBatch(ScriptingFunction func,
+                    const BSONObj* args,
+                    const std::vector<BSONObj>& recvs,
+                    std::vector<bool>* returnValues,
+                    int timeoutMs = 0,
+                    bool readOnlyArgs = false,
+                    bool readOnlyRecvs = false) override;
+
     bool exec(StringData code,
               const std::string& name,
               bool printResult,
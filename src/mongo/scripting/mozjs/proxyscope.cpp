@@ -194,6 +194,22 @@ int MozJSProxyScope::invoke(ScriptingFunction func,
     return out;
 }
 
+int MozJSProxyScope::invokeBatch(ScriptingFunction func,
+                                 const BSONObj* argsObject,
+                                 const std::vector<BSONObj>& recvs,
+                                 std::vector<bool>* returnValues,
+                                 int timeoutMs,
+                                 bool readOnlyArgs,
+                                 bool readOnlyRecvs) {
+    int out;
+    runOnImplThread([&] {
+        out = _implScope->invokeBatch(
+            func, argsObject, recvs, returnValues, timeoutMs, readOnlyArgs, readOnlyRecvs);
+    });
+
+    return out;
+}
+
 bool MozJSProxyScope::exec(StringData code,
                            const std::string& name,
                            bool printResult,
@@ -46,6 +46,7 @@ using namespace std;
 
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/config.h"
+#include "mongo/logger/async_log_writer.h"
 #include "mongo/util/debug_util.h"
 #include "mongo/util/debugger.h"
 #include "mongo/util/exit.h"
@@ -56,6 +57,19 @@ using namespace std;
 
 namespace mongo {
 
+namespace {
+
+/**
+ * Terminates the process after writing the log lines still queued for an asynchronous log writer,
+ * such as the failure message and backtrace just logged, since quickExit() flushes nothing.
+ */
+MONGO_COMPILER_NORETURN void flushLogAndQuickExit(int code) {
+    logger::AsyncLogWriter::flushAll();
+    quickExit(code);
+}
+
+}  // namespace
+
 AssertionCount assertionCount;
 
 AssertionCount::AssertionCount() : regular(0), warning(0), msg(0), user(0), rollovers(0) {}
@@ -126,7 +140,7 @@ NOINLINE_DECL void wasserted(const char* expr, const char* file, unsigned line)
 #if defined(MONGO_CONFIG_DEBUG_BUILD)
     // this is so we notice in buildbot
     log() << "\n\n***aborting after wassert() failure in a debug/test build\n\n" << endl;
-    quickExit(EXIT_ABRUPT);
+    flushLogAndQuickExit(EXIT_ABRUPT);
 #endif
 }
 
@@ -141,7 +155,7 @@ NOINLINE_DECL void verifyFailed(const char* expr, const char* file, unsigned lin
 #if defined(MONGO_CONFIG_DEBUG_BUILD)
     // this is so we notice in buildbot
     log() << "\n\n***aborting after verify() failure as this is a debug/test build\n\n" << endl;
-    quickExit(EXIT_ABRUPT);
+    flushLogAndQuickExit(EXIT_ABRUPT);
 #endif
     throw e;
 }
@@ -151,7 +165,7 @@ NOINLINE_DECL void invariantFailed(const char* expr, const char* file, unsigned
     logContext();
     breakpoint();
     log() << "\n\n***aborting after invariant() failure\n\n" << endl;
-    quickExit(EXIT_ABRUPT);
+    flushLogAndQuickExit(EXIT_ABRUPT);
 }
 
 NOINLINE_DECL void invariantOKFailed(const char* expr,
@@ -163,7 +177,7 @@ NOINLINE_DECL void invariantOKFailed(const char* expr,
     logContext();
     breakpoint();
     log() << "\n\n***aborting after invariant() failure\n\n" << endl;
-    quickExit(EXIT_ABRUPT);
+    flushLogAndQuickExit(EXIT_ABRUPT);
 }
 
 NOINLINE_DECL void fassertFailed(int msgid) {
@@ -171,14 +185,14 @@ NOINLINE_DECL void fassertFailed(int msgid) {
     logContext();
     breakpoint();
     log() << "\n\n***aborting after fassert() failure\n\n" << endl;
-    quickExit(EXIT_ABRUPT);
+    flushLogAndQuickExit(EXIT_ABRUPT);
 }
 
 NOINLINE_DECL void fassertFailedNoTrace(int msgid) {
     log() << "Fatal Assertion " << msgid << endl;
     breakpoint();
     log() << "\n\n***aborting after fassert() failure\n\n" << endl;
-    quickExit(EXIT_ABRUPT);
+    flushLogAndQuickExit(EXIT_ABRUPT);
 }
 
 MONGO_COMPILER_NORETURN void fassertFailedWithStatus(int msgid, const Status& status) {
@@ -186,14 +200,14 @@ MONGO_COMPILER_NORETURN void fassertFailedWithStatus(int msgid, const Status& st
     logContext();
     breakpoint();
     log() << "\n\n***aborting after fassert() failure\n\n" << endl;
-    quickExit(EXIT_ABRUPT);
+    flushLogAndQuickExit(EXIT_ABRUPT);
 }
 
 MONGO_COMPILER_NORETURN void fassertFailedWithStatusNoTrace(int msgid, const Status& status) {
     log() << "Fatal assertion " << msgid << " " << status;
     breakpoint();
     log() << "\n\n***aborting after fassert() failure\n\n" << endl;
-    quickExit(EXIT_ABRUPT);
+    flushLogAndQuickExit(EXIT_ABRUPT);
 }
 
 void uasserted(int msgid, const string& msg) {
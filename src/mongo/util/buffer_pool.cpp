@@ -0,0 +1,279 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/buffer_pool.h"
+
+#include <boost/thread/tss.hpp>
+#include <cstdlib>
+#include <cstring>
+
+#include "mongo/platform/atomic_word.h"
+#include "mongo/platform/bits.h"
+#include "mongo/platform/compiler.h"
+#include "mongo/util/allocator.h"
+#include "mongo/util/concurrency/threadlocal.h"
+
+namespace mongo {
+
+namespace {
+
+const int kNumSizeClasses = 11;  // 64 bytes to 64KB
+static_assert((BufferPool::kMinBlockSize << (kNumSizeClasses - 1)) == BufferPool::kMaxBlockSize,
+              "size classes must span kMinBlockSize to kMaxBlockSize");
+
+/**
+ * Returns the index of the smallest size class holding 'bytes', which must be at most
+ * kMaxBlockSize.
+ */
+int sizeClass(size_t bytes) {
+    if (bytes <= BufferPool::kMinBlockSize) {
+        return 0;
+    }
+    return 64 - countLeadingZeros64(bytes - 1) - 6;
+}
+
+size_t classSize(int sizeClass) {
+    return BufferPool::kMinBlockSize << sizeClass;
+}
+
+// The bytes of kMaxCachedBytesTotal reserved by the caches of all threads.
+AtomicWord<long long> totalReserved(0);
+
+struct ThreadCache;
+
+// The cache is found through a trivially constructible thread local, and deleted at thread exit by
+// a thread_specific_ptr. Blocks released while the thread is being torn down, after its cache is
+// gone, are freed directly.
+MONGO_TRIVIALLY_CONSTRUCTIBLE_THREAD_LOCAL ThreadCache* threadCache;
+MONGO_TRIVIALLY_CONSTRUCTIBLE_THREAD_LOCAL bool threadCacheDestroyed;
+
+struct ThreadCache {
+    ~ThreadCache() {
+        clear();
+        threadCache = nullptr;
+        threadCacheDestroyed = true;
+    }
+
+    void clear() {
+        for (int i = 0; i < kNumSizeClasses; ++i) {
+            while (counts[i] > 0) {
+                free(blocks[i][--counts[i]]);
+            }
+            lowWater[i] = 0;
+        }
+        cachedBytes = 0;
+        totalReserved.subtractAndFetch(reservedBytes);
+        reservedBytes = 0;
+    }
+
+    /**
+     * Frees the blocks which stayed in the cache since the last trim, and returns the whole
+     * kMaxBlockSize chunks of the reservation no longer needed by the rest.
+     */
+    void trim() {
+        for (int i = 0; i < kNumSizeClasses; ++i) {
+            for (int unused = lowWater[i]; unused > 0; --unused) {
+                free(blocks[i][--counts[i]]);
+                cachedBytes -= classSize(i);
+            }
+            lowWater[i] = counts[i];
+        }
+        const size_t needed = (cachedBytes + BufferPool::kMaxBlockSize - 1) /
+            BufferPool::kMaxBlockSize * BufferPool::kMaxBlockSize;
+        totalReserved.subtractAndFetch(reservedBytes - needed);
+        reservedBytes = needed;
+    }
+
+    /**
+     * Returns whether 'bytes' more bytes may be cached, reserving more of kMaxCachedBytesTotal
+     * if needed. The shared counter is only touched once per kMaxBlockSize bytes.
+     */
+    bool reserve(size_t bytes) {
+        while (cachedBytes + bytes > reservedBytes) {
+            if (reservedBytes + BufferPool::kMaxBlockSize > BufferPool::kMaxCachedBytesPerThread) {
+                return false;
+            }
+            const long long chunk = BufferPool::kMaxBlockSize;
+            if (totalReserved.addAndFetch(chunk) >
+                static_cast<long long>(BufferPool::kMaxCachedBytesTotal)) {
+                totalReserved.subtractAndFetch(chunk);
+                return false;
+            }
+            reservedBytes += chunk;
+        }
+        return true;
+    }
+
+    void* blocks[kNumSizeClasses][BufferPool::kMaxCachedBlocksPerClass];
+    int counts[kNumSizeClasses] = {};
+    int lowWater[kNumSizeClasses] = {};  // fewest blocks of each class cached since the last trim
+    size_t cachedBytes = 0;
+    size_t reservedBytes = 0;  // share of kMaxCachedBytesTotal held by this cache
+    BufferPool::Stats stats;
+};
+
+boost::thread_specific_ptr<ThreadCache>& threadCacheOwner() {
+    // Never deleted, so that buffers may be released during static destruction
+    static auto owner = new boost::thread_specific_ptr<ThreadCache>();
+    return *owner;
+}
+
+ThreadCache* getThreadCache() {
+    if (MONGO_likely(threadCache)) {
+        return threadCache;
+    }
+    if (threadCacheDestroyed) {
+        return nullptr;
+    }
+    threadCache = new ThreadCache();
+    threadCacheOwner().reset(threadCache);
+    return threadCache;
+}
+
+/**
+ * Removes and returns a block of size class 'sizeClass' from the calling thread's cache, or
+ * returns NULL if there is none.
+ */
+void* takeCachedBlock(ThreadCache* cache, int sizeClass) {
+    if (!cache || cache->counts[sizeClass] == 0) {
+        return nullptr;
+    }
+    cache->cachedBytes -= classSize(sizeClass);
+    cache->stats.cacheHits++;
+    void* block = cache->blocks[sizeClass][--cache->counts[sizeClass]];
+    if (cache->counts[sizeClass] < cache->lowWater[sizeClass]) {
+        cache->lowWater[sizeClass] = cache->counts[sizeClass];
+    }
+    return block;
+}
+
+}  // namespace
+
+const size_t BufferPool::kMinBlockSize;
+const size_t BufferPool::kMaxBlockSize;
+const size_t BufferPool::kMaxCachedBytesPerThread;
+const size_t BufferPool::kMaxCachedBytesTotal;
+const int BufferPool::kMaxCachedBlocksPerClass;
+
+void* BufferPool::allocate(size_t bytes, size_t* blockSize) {
+    ThreadCache* cache = getThreadCache();
+    if (cache) {
+        cache->stats.allocations++;
+    }
+
+    if (bytes > kMaxBlockSize) {
+        *blockSize = bytes;
+        return mongoMalloc(bytes);
+    }
+
+    const int cls = sizeClass(bytes);
+    *blockSize = classSize(cls);
+    if (void* block = takeCachedBlock(cache, cls)) {
+        return block;
+    }
+    return mongoMalloc(*blockSize);
+}
+
+void* BufferPool::reallocate(void* block, size_t bytes, size_t* blockSize) {
+    if (!block) {
+        return allocate(bytes, blockSize);
+    }
+    if (bytes <= *blockSize) {
+        return block;
+    }
+
+    ThreadCache* cache = getThreadCache();
+    if (cache) {
+        cache->stats.allocations++;
+    }
+
+    if (bytes > kMaxBlockSize) {
+        *blockSize = bytes;
+        return mongoRealloc(block, bytes);
+    }
+
+    const int cls = sizeClass(bytes);
+    if (void* newBlock = takeCachedBlock(cache, cls)) {
+        memcpy(newBlock, block, *blockSize);
+        release(block, *blockSize);
+        *blockSize = classSize(cls);
+        return newBlock;
+    }
+    *blockSize = classSize(cls);
+    return mongoRealloc(block, *blockSize);
+}
+
+void BufferPool::release(void* block, size_t blockSize) {
+    if (!block) {
+        return;
+    }
+
+    ThreadCache* cache = getThreadCache();
+    if (!cache) {
+        free(block);
+        return;
+    }
+    cache->stats.releases++;
+
+    if (blockSize <= kMaxBlockSize) {
+        const int cls = sizeClass(blockSize);
+        if (cache->counts[cls] < kMaxCachedBlocksPerClass && cache->reserve(blockSize)) {
+            cache->blocks[cls][cache->counts[cls]++] = block;
+            cache->cachedBytes += blockSize;
+            cache->stats.cached++;
+            return;
+        }
+    }
+    free(block);
+}
+
+BufferPool::Stats BufferPool::threadStats() {
+    ThreadCache* cache = getThreadCache();
+    return cache ? cache->stats : Stats();
+}
+
+void BufferPool::clearThreadCache() {
+    // Avoids creating a cache for a thread which never had one.
+    if (ThreadCache* cache = threadCache) {
+        cache->clear();
+    }
+}
+
+void BufferPool::trimThreadCache() {
+    if (ThreadCache* cache = threadCache) {
+        cache->trim();
+    }
+}
+
+size_t BufferPool::totalReservedBytes() {
+    return totalReserved.load();
+}
+
+}  // namespace mongo
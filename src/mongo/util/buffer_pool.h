@@ -0,0 +1,115 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+namespace mongo {
+
+/**
+ * A per-thread cache of the buffers used by BufBuilder.
+ *
+ * Builders are typically created, filled and destroyed once per operation, so the same few buffer
+ * sizes are malloc'ed and freed over and over. Buffers of up to kMaxBlockSize bytes are rounded up
+ * to a power of two size class, and when released are kept in a small cache belonging to the
+ * releasing thread, from which later allocations of the same size class are served.
+ *
+ * Every block is obtained from malloc and has no header, so a block may still be handed off to
+ * code which frees it with free(), such as a decoupled BufBuilder buffer owned by a Message or a
+ * SharedBuffer. Such blocks simply never return to the cache.
+ */
+class BufferPool {
+public:
+    static const size_t kMinBlockSize = 64;
+    static const size_t kMaxBlockSize = 64 * 1024;
+
+    /** Upper bound on the bytes held in each thread's cache. */
+    static const size_t kMaxCachedBytesPerThread = 256 * 1024;
+
+    /**
+     * Upper bound on the bytes held in the caches of all threads together. Threads reserve their
+     * share of it kMaxBlockSize bytes at a time, and return it when their cache is cleared.
+     */
+    static const size_t kMaxCachedBytesTotal = 16 * 1024 * 1024;
+
+    /** Upper bound on the blocks of any one size class held in each thread's cache. */
+    static const int kMaxCachedBlocksPerClass = 8;
+
+    /**
+     * Allocation counts of the calling thread.
+     */
+    struct Stats {
+        long long allocations = 0;  // blocks requested
+        long long cacheHits = 0;    // blocks requested which were served from the cache
+        long long releases = 0;     // blocks released
+        long long cached = 0;       // blocks released which were kept in the cache
+    };
+
+    /**
+     * Returns a block of at least 'bytes' bytes, and stores its actual size in 'blockSize'.
+     */
+    static void* allocate(size_t bytes, size_t* blockSize);
+
+    /**
+     * Grows 'block', of size 'blockSize', to at least 'bytes' bytes, keeping its contents. Returns
+     * the new block and stores its size in 'blockSize'.
+     */
+    static void* reallocate(void* block, size_t bytes, size_t* blockSize);
+
+    /**
+     * Releases 'block', which was returned by allocate() or reallocate() with size 'blockSize'.
+     * Does nothing if 'block' is NULL.
+     */
+    static void release(void* block, size_t blockSize);
+
+    /**
+     * Returns the allocation counts of the calling thread.
+     */
+    static Stats threadStats();
+
+    /**
+     * Frees all blocks held in the calling thread's cache, and returns its share of
+     * kMaxCachedBytesTotal. This also happens when the thread exits.
+     */
+    static void clearThreadCache();
+
+    /**
+     * Frees the blocks in the calling thread's cache which were not reused since the previous
+     * trim, and returns the part of its share of kMaxCachedBytesTotal they no longer need. Cheap
+     * enough to call every few requests: a busy thread keeps the blocks it keeps reusing.
+     */
+    static void trimThreadCache();
+
+    /**
+     * Returns the bytes of kMaxCachedBytesTotal currently reserved by the caches of all threads.
+     */
+    static size_t totalReservedBytes();
+};
+
+}  // namespace mongo
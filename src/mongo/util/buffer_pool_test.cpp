@@ -0,0 +1,314 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/buffer_pool.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "mongo/bson/util/builder.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+class BufferPoolTest : public unittest::Test {
+protected:
+    void setUp() override {
+        BufferPool::clearThreadCache();
+    }
+    void tearDown() override {
+        BufferPool::clearThreadCache();
+    }
+};
+
+TEST_F(BufferPoolTest, RoundsUpToSizeClass) {
+    size_t blockSize;
+    void* block = BufferPool::allocate(1, &blockSize);
+    ASSERT_EQUALS(BufferPool::kMinBlockSize, blockSize);
+    BufferPool::release(block, blockSize);
+
+    block = BufferPool::allocate(513, &blockSize);
+    ASSERT_EQUALS(1024U, blockSize);
+    BufferPool::release(block, blockSize);
+
+    block = BufferPool::allocate(BufferPool::kMaxBlockSize, &blockSize);
+    ASSERT_EQUALS(BufferPool::kMaxBlockSize, blockSize);
+    BufferPool::release(block, blockSize);
+
+    block = BufferPool::allocate(BufferPool::kMaxBlockSize + 1, &blockSize);
+    ASSERT_EQUALS(BufferPool::kMaxBlockSize + 1, blockSize);
+    BufferPool::release(block, blockSize);
+}
+
+TEST_F(BufferPoolTest, ReleasedBlocksAreReused) {
+    const BufferPool::Stats before = BufferPool::threadStats();
+
+    size_t blockSize;
+    void* block = BufferPool::allocate(500, &blockSize);
+    BufferPool::release(block, blockSize);
+    void* again = BufferPool::allocate(400, &blockSize);
+    ASSERT_EQUALS(block, again);
+    BufferPool::release(again, blockSize);
+
+    const BufferPool::Stats after = BufferPool::threadStats();
+    ASSERT_EQUALS(2, after.allocations - before.allocations);
+    ASSERT_EQUALS(1, after.cacheHits - before.cacheHits);
+    ASSERT_EQUALS(2, after.releases - before.releases);
+    ASSERT_EQUALS(2, after.cached - before.cached);
+}
+
+TEST_F(BufferPoolTest, LargeBlocksAreNotCached) {
+    const BufferPool::Stats before = BufferPool::threadStats();
+
+    size_t blockSize;
+    void* block = BufferPool::allocate(BufferPool::kMaxBlockSize * 2, &blockSize);
+    BufferPool::release(block, blockSize);
+
+    const BufferPool::Stats after = BufferPool::threadStats();
+    ASSERT_EQUALS(1, after.releases - before.releases);
+    ASSERT_EQUALS(0, after.cached - before.cached);
+}
+
+TEST_F(BufferPoolTest, CacheIsBounded) {
+    std::vector<void*> blocks;
+    size_t blockSize;
+    for (int i = 0; i < BufferPool::kMaxCachedBlocksPerClass + 2; ++i) {
+        blocks.push_back(BufferPool::allocate(100, &blockSize));
+    }
+
+    const BufferPool::Stats before = BufferPool::threadStats();
+    for (void* block : blocks) {
+        BufferPool::release(block, blockSize);
+    }
+    const BufferPool::Stats after = BufferPool::threadStats();
+    ASSERT_EQUALS(BufferPool::kMaxCachedBlocksPerClass, after.cached - before.cached);
+
+    // The total size of the cache is bounded too
+    blocks.clear();
+    for (size_t i = 0; i < BufferPool::kMaxCachedBytesPerThread / BufferPool::kMaxBlockSize + 2;
+         ++i) {
+        blocks.push_back(BufferPool::allocate(BufferPool::kMaxBlockSize, &blockSize));
+    }
+    const BufferPool::Stats beforeLarge = BufferPool::threadStats();
+    for (void* block : blocks) {
+        BufferPool::release(block, blockSize);
+    }
+    const BufferPool::Stats afterLarge = BufferPool::threadStats();
+    ASSERT_LESS_THAN_OR_EQUALS(
+        static_cast<size_t>(afterLarge.cached - beforeLarge.cached) * BufferPool::kMaxBlockSize,
+        BufferPool::kMaxCachedBytesPerThread);
+}
+
+TEST_F(BufferPoolTest, ReallocateKeepsContents) {
+    size_t blockSize;
+    char* block = static_cast<char*>(BufferPool::allocate(64, &blockSize));
+    memset(block, 'x', blockSize);
+
+    // Growing within the block's size class leaves it in place
+    ASSERT_EQUALS(block, BufferPool::reallocate(block, 64, &blockSize));
+
+    // Growing into a size class with a cached block moves to that block
+    size_t cachedSize;
+    void* cached = BufferPool::allocate(1000, &cachedSize);
+    BufferPool::release(cached, cachedSize);
+    char* grown = static_cast<char*>(BufferPool::reallocate(block, 1000, &blockSize));
+    ASSERT_EQUALS(cached, grown);
+    ASSERT_EQUALS(1024U, blockSize);
+    for (int i = 0; i < 64; ++i) {
+        ASSERT_EQUALS('x', grown[i]);
+    }
+
+    grown = static_cast<char*>(BufferPool::reallocate(grown, 100 * 1000, &blockSize));
+    ASSERT_EQUALS(100 * 1000U, blockSize);
+    for (int i = 0; i < 64; ++i) {
+        ASSERT_EQUALS('x', grown[i]);
+    }
+    BufferPool::release(grown, blockSize);
+}
+
+TEST_F(BufferPoolTest, BufBuildersReuseBuffers) {
+    {
+        BufBuilder b;
+        b.appendStr("warm up the cache");
+    }
+
+    const BufferPool::Stats before = BufferPool::threadStats();
+    for (int i = 0; i < 100; ++i) {
+        BufBuilder b;
+        for (int j = 0; j < 100; ++j) {
+            b.appendNum(j);
+        }
+    }
+    const BufferPool::Stats after = BufferPool::threadStats();
+    ASSERT_EQUALS(after.allocations - before.allocations, after.cacheHits - before.cacheHits);
+}
+
+TEST_F(BufferPoolTest, DecoupledBuffersCanBeFreed) {
+    BufBuilder b;
+    b.appendStr("decoupled");
+    char* buf = b.buf();
+    b.decouple();
+    ASSERT_EQUALS(0, strcmp("decoupled", buf));
+    free(buf);
+}
+
+TEST_F(BufferPoolTest, ResetAfterDecoupleDoesNotCacheNull) {
+    BufBuilder b(1024);
+    b.appendStr("decoupled");
+    char* buf = b.buf();
+    b.decouple();
+    free(buf);
+
+    const BufferPool::Stats before = BufferPool::threadStats();
+    b.reset(512);
+    ASSERT_EQUALS(0, BufferPool::threadStats().cached - before.cached);
+
+    size_t blockSize;
+    void* block = BufferPool::allocate(1000, &blockSize);
+    ASSERT(block);
+    BufferPool::release(block, blockSize);
+    BufferPool::release(NULL, blockSize);
+}
+
+TEST_F(BufferPoolTest, ClearingTheCacheReturnsItsReservation) {
+    const size_t reservedBefore = BufferPool::totalReservedBytes();
+
+    size_t blockSize;
+    void* block = BufferPool::allocate(100, &blockSize);
+    BufferPool::release(block, blockSize);
+    ASSERT_EQUALS(reservedBefore + BufferPool::kMaxBlockSize, BufferPool::totalReservedBytes());
+
+    BufferPool::clearThreadCache();
+    ASSERT_EQUALS(reservedBefore, BufferPool::totalReservedBytes());
+}
+
+TEST_F(BufferPoolTest, TrimmingKeepsBlocksReusedSinceTheLastTrim) {
+    const size_t reservedBefore = BufferPool::totalReservedBytes();
+
+    size_t blockSize;
+    void* block = BufferPool::allocate(100, &blockSize);
+    BufferPool::release(block, blockSize);
+
+    // A busy thread trims between requests which keep reusing the same block.
+    for (int i = 0; i < 3; ++i) {
+        BufferPool::trimThreadCache();
+        block = BufferPool::allocate(100, &blockSize);
+        BufferPool::release(block, blockSize);
+    }
+    BufferPool::trimThreadCache();
+    ASSERT_EQUALS(reservedBefore + BufferPool::kMaxBlockSize, BufferPool::totalReservedBytes());
+
+    const BufferPool::Stats before = BufferPool::threadStats();
+    BufferPool::release(BufferPool::allocate(100, &blockSize), blockSize);
+    ASSERT_EQUALS(before.cacheHits + 1, BufferPool::threadStats().cacheHits);
+}
+
+TEST_F(BufferPoolTest, TrimmingFreesBlocksNotReusedSinceTheLastTrim) {
+    const size_t reservedBefore = BufferPool::totalReservedBytes();
+
+    size_t blockSize;
+    void* block = BufferPool::allocate(100, &blockSize);
+    BufferPool::release(block, blockSize);
+
+    // The first trim only marks the block, which is freed once a whole interval passes unused.
+    BufferPool::trimThreadCache();
+    ASSERT_EQUALS(reservedBefore + BufferPool::kMaxBlockSize, BufferPool::totalReservedBytes());
+    BufferPool::trimThreadCache();
+    ASSERT_EQUALS(reservedBefore, BufferPool::totalReservedBytes());
+
+    const BufferPool::Stats before = BufferPool::threadStats();
+    BufferPool::release(BufferPool::allocate(100, &blockSize), blockSize);
+    ASSERT_EQUALS(before.cacheHits, BufferPool::threadStats().cacheHits);
+}
+
+TEST_F(BufferPoolTest, CachesOfAllThreadsAreBounded) {
+    // Each thread fills its cache and keeps it while the others do the same
+    const size_t reservedBefore = BufferPool::totalReservedBytes();
+    const int numThreads =
+        2 * BufferPool::kMaxCachedBytesTotal / BufferPool::kMaxCachedBytesPerThread;
+    std::vector<stdx::thread> threads;
+    stdx::mutex mutex;
+    stdx::condition_variable allFilled;
+    int numFilled = 0;
+    size_t maxReserved = 0;
+    for (int i = 0; i < numThreads; ++i) {
+        threads.emplace_back([&] {
+            std::vector<void*> blocks;
+            size_t blockSize;
+            for (size_t j = 0; j < BufferPool::kMaxCachedBlocksPerClass; ++j) {
+                blocks.push_back(BufferPool::allocate(BufferPool::kMaxBlockSize / 2, &blockSize));
+            }
+            for (void* block : blocks) {
+                BufferPool::release(block, blockSize);
+            }
+
+            stdx::unique_lock<stdx::mutex> lk(mutex);
+            maxReserved = std::max(maxReserved, BufferPool::totalReservedBytes());
+            if (++numFilled == numThreads) {
+                allFilled.notify_all();
+            }
+            allFilled.wait(lk, [&] { return numFilled == numThreads; });
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    ASSERT_LESS_THAN_OR_EQUALS(maxReserved, BufferPool::kMaxCachedBytesTotal);
+    ASSERT_EQUALS(reservedBefore, BufferPool::totalReservedBytes());
+}
+
+TEST_F(BufferPoolTest, ThreadsHaveSeparateCaches) {
+    size_t blockSize;
+    void* block = BufferPool::allocate(100, &blockSize);
+    BufferPool::release(block, blockSize);
+
+    void* otherThreadBlock = nullptr;
+    stdx::thread([&] {
+        size_t otherSize;
+        otherThreadBlock = BufferPool::allocate(100, &otherSize);
+        ASSERT_EQUALS(0, BufferPool::threadStats().cacheHits);
+        BufferPool::release(otherThreadBlock, otherSize);
+    }).join();
+
+    // Blocks left in an exited thread's cache were freed, and this thread's cache is unaffected
+    const BufferPool::Stats before = BufferPool::threadStats();
+    ASSERT_EQUALS(block, BufferPool::allocate(100, &blockSize));
+    ASSERT_EQUALS(1, BufferPool::threadStats().cacheHits - before.cacheHits);
+    BufferPool::release(block, blockSize);
+}
+
+}  // namespace
+}  // namespace mongo
@@ -33,6 +33,7 @@
 
 #include <boost/date_time/posix_time/posix_time.hpp>
 
+#include "mongo/util/buffer_pool.h"
 #include "mongo/util/log.h"
 
 namespace mongo {
@@ -47,6 +48,8 @@ void registerThreadIdleCallback(ThreadIdleCallback callback) {
 }
 
 void markThreadIdle() {
+    BufferPool::trimThreadCache();
+
     if (!threadIdleCallback) {
         return;
     }
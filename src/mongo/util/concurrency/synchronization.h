@@ -43,9 +43,9 @@ typedef void (*ThreadIdleCallback)();
 
 /**
  * Informs the registered listener that this thread believes it may go idle for an extended
- * period. The caller should avoid calling markThreadIdle at a high rate, as it can both be
- * moderately costly itself and in terms of distributed overhead for subsequent malloc/free
- * calls.
+ * period, and trims the thread's cache of BufBuilder buffers. The caller should avoid calling
+ * markThreadIdle at a high rate, as it can both be moderately costly itself and in terms of
+ * distributed overhead for subsequent malloc/free calls.
  */
 void markThreadIdle();
 
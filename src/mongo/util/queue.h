@@ -75,6 +75,29 @@ public:
         _cvNoLongerEmpty.notify_one();
     }
 
+    /**
+     * Pushes every element in the range [begin, end) under a single acquisition of the lock.
+     * Blocks until the whole range fits; if the range alone is larger than the max size, waits
+     * for the queue to drain completely instead so that progress is always possible.
+     */
+    template <typename Iterator>
+    void pushAllBlocking(Iterator begin, Iterator end) {
+        size_t total = 0;
+        for (auto i = begin; i != end; ++i) {
+            total += _getSize(*i);
+        }
+
+        stdx::unique_lock<stdx::mutex> l(_lock);
+        while (_currentSize + total > _maxSize && _currentSize != 0) {
+            _cvNoLongerFull.wait(l);
+        }
+        for (auto i = begin; i != end; ++i) {
+            _queue.push(*i);
+        }
+        _currentSize += total;
+        _cvNoLongerEmpty.notify_one();
+    }
+
     bool empty() const {
         stdx::lock_guard<stdx::mutex> l(_lock);
         return _queue.empty();
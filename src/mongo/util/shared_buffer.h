@@ -80,6 +80,14 @@ public:
         return _holder ? _holder->data() : NULL;
     }
 
+    /**
+     * Returns true if more than one SharedBuffer refers to the underlying memory. An unshared
+     * buffer can safely be overwritten by its only owner.
+     */
+    bool isShared() const {
+        return _holder && _holder->isShared();
+    }
+
     class Holder {
     public:
         explicit Holder(AtomicUInt32::WordType initial = AtomicUInt32::WordType())
@@ -103,6 +111,10 @@ public:
             return reinterpret_cast<char*>(this + 1);
         }
 
+        bool isShared() const {
+            return _refCount.load() > 1;
+        }
+
         const char* data() const {
             return reinterpret_cast<const char*>(this + 1);
         }
@@ -0,0 +1,106 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cmath>
+
+namespace mongo {
+
+/**
+ * Sums numbers more accurately than adding them up one by one.
+ *
+ * Integers are summed exactly for as long as their total fits in a long long. Doubles, and
+ * integer totals which would overflow, are summed with Neumaier's variant of Kahan summation:
+ * the rounding error of each addition is kept in a separate compensation term, so that the
+ * total is nearly always the correctly rounded sum of the doubles added.
+ */
+class CompensatedSum {
+public:
+    void addLong(long long x) {
+        // Unsigned arithmetic wraps on overflow, which is detected from the signs.
+        const long long sum = static_cast<long long>(static_cast<unsigned long long>(_longSum) +
+                                                     static_cast<unsigned long long>(x));
+        if ((_longSum < 0) == (x < 0) && (sum < 0) != (x < 0)) {
+            // Move the integer total over to the doubles and start a new one.
+            addDouble(static_cast<double>(_longSum));
+            _longSum = x;
+            _longOverflowed = true;
+            return;
+        }
+        _longSum = sum;
+    }
+
+    void addDouble(double x) {
+        const double sum = _doubleSum + x;
+        if (std::abs(_doubleSum) >= std::abs(x)) {
+            _compensation += (_doubleSum - sum) + x;
+        } else {
+            _compensation += (x - sum) + _doubleSum;
+        }
+        _doubleSum = sum;
+        _hasDoubles = true;
+    }
+
+    /**
+     * Returns true if only integers were added and their total fits in a long long.
+     */
+    bool isLong() const {
+        return !_hasDoubles && !_longOverflowed;
+    }
+
+    /**
+     * Returns the total. Only valid if isLong().
+     */
+    long long getLong() const {
+        return _longSum;
+    }
+
+    /**
+     * Returns the total as a double.
+     */
+    double getDouble() const {
+        CompensatedSum total(*this);
+        total.addDouble(static_cast<double>(_longSum));
+        // The compensation of infinite or NaN totals is meaningless.
+        if (!std::isfinite(total._doubleSum)) {
+            return total._doubleSum;
+        }
+        return total._doubleSum + total._compensation;
+    }
+
+private:
+    long long _longSum = 0;
+    bool _longOverflowed = false;
+
+    double _doubleSum = 0;
+    double _compensation = 0;
+    bool _hasDoubles = false;
+};
+
+}  // namespace mongo
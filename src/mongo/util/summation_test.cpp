@@ -0,0 +1,109 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/summation.h"
+
+#include <limits>
+
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+TEST(CompensatedSum, Empty) {
+    CompensatedSum sum;
+    ASSERT_TRUE(sum.isLong());
+    ASSERT_EQUALS(0, sum.getLong());
+    ASSERT_EQUALS(0.0, sum.getDouble());
+}
+
+TEST(CompensatedSum, Longs) {
+    CompensatedSum sum;
+    sum.addLong(std::numeric_limits<long long>::max());
+    sum.addLong(std::numeric_limits<long long>::min());
+    sum.addLong(5);
+    ASSERT_TRUE(sum.isLong());
+    ASSERT_EQUALS(4, sum.getLong());
+    ASSERT_EQUALS(4.0, sum.getDouble());
+}
+
+TEST(CompensatedSum, LongOverflow) {
+    CompensatedSum sum;
+    sum.addLong(std::numeric_limits<long long>::max());
+    sum.addLong(2048);
+    ASSERT_FALSE(sum.isLong());
+    ASSERT_EQUALS(9223372036854777856.0, sum.getDouble());
+
+    CompensatedSum negative;
+    negative.addLong(std::numeric_limits<long long>::min());
+    negative.addLong(-1);
+    ASSERT_FALSE(negative.isLong());
+    ASSERT_EQUALS(-9223372036854775808.0, negative.getDouble());
+}
+
+TEST(CompensatedSum, Doubles) {
+    CompensatedSum sum;
+    double naive = 0;
+    for (int i = 0; i < 1000; ++i) {
+        sum.addDouble(0.1);
+        naive += 0.1;
+    }
+    ASSERT_FALSE(sum.isLong());
+    ASSERT_EQUALS(100.0, sum.getDouble());
+    ASSERT_NOT_EQUALS(100.0, naive);
+}
+
+TEST(CompensatedSum, LongsAndDoubles) {
+    CompensatedSum sum;
+    sum.addLong(1LL << 53);
+    sum.addDouble(0.5);
+    sum.addDouble(0.5);
+    sum.addLong(-(1LL << 53));
+    ASSERT_FALSE(sum.isLong());
+    ASSERT_EQUALS(1.0, sum.getDouble());
+}
+
+TEST(CompensatedSum, NonFinite) {
+    const double inf = std::numeric_limits<double>::infinity();
+
+    CompensatedSum infinite;
+    infinite.addDouble(std::numeric_limits<double>::max());
+    infinite.addDouble(std::numeric_limits<double>::max());
+    infinite.addLong(1);
+    ASSERT_EQUALS(inf, infinite.getDouble());
+
+    CompensatedSum nan;
+    nan.addDouble(inf);
+    nan.addDouble(-inf);
+    ASSERT_TRUE(std::isnan(nan.getDouble()));
+}
+
+}  // namespace
+}  // namespace mongo